@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xml::allocator class and the
+    allocators provided by xmlwrapp.
+ */
+
+#ifndef _xmlwrapp_allocator_h_
+#define _xmlwrapp_allocator_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xml
+{
+
+namespace impl
+{
+struct counting_allocator_impl;
+struct pool_allocator_impl;
+}
+
+/**
+    Memory allocator used by libxml2.
+
+    All memory allocated by libxml2, e.g. for the nodes, attributes and
+    strings of the documents, is allocated using the functions of this
+    class once it is installed with xml::init::set_allocator(). The
+    allocator must be thread-safe if the library is used from several
+    threads.
+
+    The blocks returned by allocate() and reallocate() must be suitably
+    aligned for any type, like those returned by @c malloc().
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API allocator
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    allocator() = default;
+    virtual ~allocator();
+
+    /**
+        Allocate a block of memory of at least the given size.
+
+        @return The pointer to the block or null if there is not enough
+                memory.
+     */
+    virtual void* allocate(size_type size) = 0;
+
+    /**
+        Change the size of the block previously returned by allocate() or
+        reallocate(), preserving its contents.
+
+        @param ptr The block to resize, may be null in which case this
+                   function must behave like allocate().
+        @param size The new size of the block.
+        @return The pointer to the possibly moved block or null if there is
+                not enough memory, in which case @a ptr remains valid.
+     */
+    virtual void* reallocate(void *ptr, size_type size) = 0;
+
+    /**
+        Free the block previously returned by allocate() or reallocate().
+
+        @param ptr The block to free, may be null.
+     */
+    virtual void deallocate(void *ptr) = 0;
+
+private:
+    allocator(const allocator&) = delete;
+    allocator& operator=(const allocator&) = delete;
+};
+
+/**
+    Allocator counting the memory used by libxml2.
+
+    This allocator forwards all the requests to another allocator, or the
+    standard @c malloc() if none is specified, and keeps exact statistics of
+    the memory allocated through it, which can be used to measure the memory
+    used by the documents.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API counting_allocator : public allocator
+{
+public:
+    /// Statistics about the memory allocated, see get_statistics().
+    struct statistics
+    {
+        /// Number of blocks allocated.
+        size_type allocations{0};
+
+        /// Number of blocks freed.
+        size_type deallocations{0};
+
+        /// Number of bytes currently allocated.
+        size_type bytes_in_use{0};
+
+        /// Maximal number of bytes allocated at the same time.
+        size_type peak_bytes_in_use{0};
+
+        /// Total number of bytes ever allocated.
+        unsigned long long total_bytes{0};
+    };
+
+    /**
+        Create the allocator forwarding to the given one.
+
+        @param underlying The allocator to use for the actual allocations,
+                          which must outlive this one, or null to use the
+                          standard library functions.
+     */
+    explicit counting_allocator(allocator *underlying = nullptr);
+
+    /// Destructor.
+    ~counting_allocator() override;
+
+    void* allocate(size_type size) override;
+    void* reallocate(void *ptr, size_type size) override;
+    void deallocate(void *ptr) override;
+
+    /// Get the statistics of the memory allocated since the creation.
+    statistics get_statistics() const;
+
+private:
+    std::unique_ptr<impl::counting_allocator_impl> pimpl_;
+};
+
+/**
+    Allocator using thread-caching pools for small blocks.
+
+    Most of the memory allocations done by libxml2 are small blocks used for
+    the nodes, attributes and their contents. This allocator carves such
+    blocks out of big chunks of memory and keeps the freed blocks in
+    per-thread caches, so that most allocations and deallocations don't need
+    any locking and are much cheaper than with the general purpose
+    allocator. The bigger blocks are allocated using the standard @c malloc().
+
+    The memory used by the pools is not returned to the system until the
+    allocator is destroyed, but it is reused for the later allocations.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API pool_allocator : public allocator
+{
+public:
+    /// The biggest block size allocated from the pools.
+    static const size_type max_pooled_size = 256;
+
+    /// Create a new allocator.
+    pool_allocator();
+
+    /// Destructor frees all the memory used by the pools.
+    ~pool_allocator() override;
+
+    void* allocate(size_type size) override;
+    void* reallocate(void *ptr, size_type size) override;
+    void deallocate(void *ptr) override;
+
+    /// Get the amount of memory allocated from the system for the pools.
+    size_type get_pool_memory() const;
+
+private:
+    std::unique_ptr<impl::pool_allocator_impl> pimpl_;
+
+    friend struct impl::pool_allocator_impl;
+};
+
+} // namespace xml
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xmlwrapp_allocator_h_
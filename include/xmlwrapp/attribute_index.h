@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xml::attribute_index class.
+ */
+
+#ifndef _xmlwrapp_attribute_index_h_
+#define _xmlwrapp_attribute_index_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/node.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xml
+{
+
+// forward declarations
+class document;
+
+namespace impl
+{
+class attribute_index_impl;
+}
+
+/**
+    Index of the elements of a document by the value of their attribute.
+
+    This class allows to find the elements having the given value of some
+    attribute, e.g. @c id or @c ref, in constant time instead of scanning the
+    whole document, as e.g. an XPath expression like @c //item[\@sku='x']
+    would do. It is built once, when it is created, by going over all the
+    elements of the document.
+
+    By default, the index is kept up to date when the document is modified
+    using xmlwrapp API, e.g. xml::node::insert(), xml::node::erase(),
+    xml::node::replace() or xml::attributes::insert(). This has a small cost
+    for every modification of the document, so if it is not going to be
+    modified, or if the index is only used between modifications, it can be
+    created in snapshot mode, in which case it is not updated at all and
+    must not be used once the document is modified.
+
+    Notice that the changes done to the document using libxml2 API directly
+    are never taken into account.
+
+    The index can also use the table of IDs maintained by libxml2 itself,
+    containing the values of @c xml:id attributes and of the attributes
+    declared as having ID type in the document DTD.
+
+    Example:
+    @code
+    xml::attribute_index by_sku(doc, "item", "sku");
+    xml::node::iterator i = by_sku.find("A-17");
+    if (i != by_sku.end())
+        ...
+    @endcode
+
+    If the document is destroyed before the index, the index becomes empty.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API attribute_index
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// How the index reacts to the document changes.
+    enum update_mode
+    {
+        snapshot,       ///< The index is not updated when the document changes.
+        auto_update     ///< The index is kept up to date (default).
+    };
+
+    /// Tag type used to select the constructor indexing the document IDs.
+    enum ids_tag
+    {
+        use_ids         ///< Index the document by IDs.
+    };
+
+    /**
+        Create the index of the elements by the value of their attribute.
+
+        @param doc The document to index, which must outlive the index, or,
+                   at least, mustn't be used after being destroyed.
+        @param element_name The name of the elements to index. If it is
+                            @c nullptr, all elements having the specified
+                            attribute are indexed.
+        @param attr_name The name of the attribute whose value is used as key.
+        @param mode Whether the index is kept up to date.
+     */
+    attribute_index(document& doc,
+                    const char *element_name,
+                    const char *attr_name,
+                    update_mode mode = auto_update);
+
+    /**
+        Create the index using the document IDs.
+
+        This index uses the IDs table of the document maintained by libxml2,
+        which contains the values of all @c xml:id attributes and the values
+        of the attributes declared to have ID type in the document DTD. The
+        IDs of the elements inserted into the document using xmlwrapp are
+        added to this table when the index is in auto_update mode.
+
+        @param doc The document to index.
+        @param tag Must be attribute_index::use_ids.
+        @param mode Whether the index is kept up to date.
+     */
+    attribute_index(document& doc,
+                    ids_tag tag,
+                    update_mode mode = auto_update);
+
+    /// Destructor.
+    ~attribute_index();
+
+    /**
+        Find an element with the given attribute value.
+
+        If there are several elements with the same value, the first of them
+        in the document order is returned, unless the document has been
+        modified since the index creation: in this case it is unspecified
+        which one of them is returned.
+
+        @param value The attribute value to look for.
+        @return Iterator pointing to the element or end() if not found.
+     */
+    node::iterator find(const char *value) const;
+
+    /**
+        Count the elements with the given attribute value.
+
+        @param value The attribute value to look for.
+        @return The number of elements with this value, always 0 or 1 when
+                using the document IDs.
+     */
+    size_type count(const char *value) const;
+
+    /// Get the number of distinct attribute values in the index.
+    size_type size() const;
+
+    /// Return true if the index is empty.
+    bool empty() const { return size() == 0; }
+
+    /// Return the iterator returned by find() if nothing was found.
+    node::iterator end() const { return node::iterator(); }
+
+private:
+    std::unique_ptr<impl::attribute_index_impl> pimpl_;
+
+    // This class is not copyable
+    attribute_index(const attribute_index&) = delete;
+    attribute_index& operator=(const attribute_index&) = delete;
+};
+
+} // namespace xml
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xmlwrapp_attribute_index_h_
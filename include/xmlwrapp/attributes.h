@@ -56,6 +56,7 @@ namespace xml
 
 // forward declarations
 class node;
+class qname;
 
 namespace impl
 {
@@ -299,6 +300,58 @@ public:
      */
     const_iterator find(const char *name) const;
 
+    /**
+        Find the attribute with the given name in the given namespace.
+
+        This function has the same semantics as libxml2 xmlHasNsProp(): unlike
+        find(const char*), which only compares the local names, only the
+        attribute in the specified namespace is found. If it is not present on
+        the node, the DTD is searched for a default value.
+
+        @param name The local name of the attribute to find.
+        @param ns_uri The namespace URI of the attribute. If it is @c nullptr
+                      or empty, only attributes without namespace match.
+        @return An iterator that points to the attribute if found.
+        @return If the attribute was not found, find will return end().
+
+        @since 0.11.0
+     */
+    iterator find(const char *name, const char *ns_uri);
+
+    /**
+        Find the attribute with the given name in the given namespace.
+
+        @see find(const char*, const char*)
+
+        @since 0.11.0
+     */
+    const_iterator find(const char *name, const char *ns_uri) const;
+
+    /**
+        Find the attribute with the given qualified name.
+
+        This is the same as find(const char*) but faster, especially when
+        looking up the same name repeatedly, and also takes the namespace of
+        the name into account. As with find(const char*), the DTD is searched
+        for a default value if the attribute is not found on the node itself.
+
+        @param name The name of the attribute to find.
+        @return An iterator that points to the attribute with the given name.
+        @return If the attribute was not found, find will return end().
+
+        @since 0.11.0
+     */
+    iterator find(const qname& name);
+
+    /**
+        Find the attribute with the given qualified name.
+
+        @see find(const qname&)
+
+        @since 0.11.0
+     */
+    const_iterator find(const qname& name) const;
+
     /**
         Erase the attribute that is pointed to by the given iterator. This
         will invalidate any iterators for this attribute, as well as any
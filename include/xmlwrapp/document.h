@@ -59,6 +59,7 @@ namespace xslt
 {
 
 class stylesheet;
+class pipeline;
 namespace impl
 {
 class result;
@@ -70,6 +71,8 @@ namespace xml
 {
 
 // forward declarations
+class dtd;
+class name_dictionary;
 class relaxng;
 class schema;
 class tree_parser;
@@ -90,12 +93,56 @@ public:
     /// size type
     using size_type = std::size_t;
 
+    /**
+        Memory management mode of the document.
+
+        By default, all nodes, attributes and texts of the document are
+        allocated separately and each of them is freed as soon as it is
+        removed from the document. In arena_allocation mode, they are all
+        allocated from a memory arena belonging to the document instead,
+        which makes allocating them faster and allows to free the entire
+        document at once, without visiting all of its nodes, when it is
+        destroyed. However the memory of the nodes removed from such document
+        is only reclaimed when the document itself is destroyed, so this mode
+        is best suited for the documents which are parsed and then only read
+        or modified a little.
+
+        Arena documents can only be created when a custom allocator is used,
+        see xml::init::set_allocator(), as the arena memory comes from it.
+        Their nodes are never stored in a dictionary, see
+        xml::name_dictionary. Otherwise they can be used in exactly the same
+        way as the other documents: in particular, inserting a node from
+        another document into an arena document copies it into the arena and
+        inserting a node of an arena document into another document copies it
+        out of the arena, as always.
+
+        @since 0.11.0
+     */
+    enum memory_mode
+    {
+        individual_allocation,  ///< Allocate each node separately (default).
+        arena_allocation        ///< Allocate all nodes from the document arena.
+    };
+
     /**
         Create a new XML document with the default settings. The new document
         will contain a root node with a name of "blank".
      */
     document();
 
+    /**
+        Create a new XML document using the given memory management mode.
+
+        The new document contains a root node with a name of "blank", like
+        the one created by the default constructor.
+
+        @param mode The memory management mode, in arena_allocation mode
+                    xml::exception is thrown if no custom allocator is used.
+
+        @since 0.11.0
+     */
+    explicit document(memory_mode mode);
+
     /**
         Create a new XML document and set the name of the root element to the
         given text.
@@ -146,10 +193,70 @@ public:
      */
     explicit document(const char *data, size_type len, error_handler& on_error = throw_on_error);
 
+    /**
+        Load XML document from given file using a shared names dictionary.
+
+        This is the same as document(const char*, error_handler&) constructor
+        except that the names of the document elements and attributes are
+        stored in the given dictionary, see xml::name_dictionary.
+
+        @param filename The name of the file to parse.
+        @param dict The dictionary to use.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    document(const char *filename, name_dictionary& dict, error_handler& on_error = throw_on_error);
+
+    /**
+        Load XML document from given data using a shared names dictionary.
+
+        @param data The XML data to parse.
+        @param len The length of the XML data to parse.
+        @param dict The dictionary to use, see xml::name_dictionary.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    document(const char *data, size_type len, name_dictionary& dict,
+             error_handler& on_error = throw_on_error);
+
+    /**
+        Load XML document from given file using the given memory mode.
+
+        This is the same as document(const char*, error_handler&) constructor
+        except that the document is created in the given mode, see
+        memory_mode.
+
+        @param filename The name of the file to parse.
+        @param mode The memory management mode of the document.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    document(const char *filename, memory_mode mode, error_handler& on_error = throw_on_error);
+
+    /**
+        Load XML document from given data using the given memory mode.
+
+        @param data The XML data to parse.
+        @param len The length of the XML data to parse.
+        @param mode The memory management mode of the document, see
+                    memory_mode.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    document(const char *data, size_type len, memory_mode mode,
+             error_handler& on_error = throw_on_error);
+
     /**
         Copy construct a new XML document. The new document will be an exact
         copy of the original.
 
+        Notice that the copy always uses individual_allocation memory_mode,
+        even if the original document uses an arena.
+
         @param other The other document object to copy from.
      */
     document(const document& other);
@@ -289,6 +396,29 @@ public:
      */
     bool has_external_subset() const;
 
+    /**
+        Use the given DTD as the external subset of this document.
+
+        Unlike validate(const char*), which transfers the DTD it parses to the
+        document, this function doesn't copy the DTD: the document only keeps
+        a reference to it, so the same DTD can be attached to any number of
+        documents cheaply. Any external subset previously used by the document
+        is removed.
+
+        The DTD is not used for validation by this function, but it will be
+        used by validate() and provides the default values of the attributes,
+        e.g. for xml::attributes::find().
+
+        Notice that the external subset is not copied when the document is
+        copied.
+
+        @param dtd The DTD to use, may be null to just remove the existing
+                   external subset.
+
+        @since 0.11.0
+     */
+    void set_external_subset(const std::shared_ptr<const dtd>& dtd);
+
     /**
         Validate this document against the DTD that has been attached to it.
         This would happen at parse time if there was a !DOCTYPE definition.
@@ -315,12 +445,59 @@ public:
         external subset after the validation. If there is already an external
         DTD attached to this document it will be removed and deleted.
 
+        Use xml::dtd instead of this function to validate many documents
+        against the same DTD without parsing it every time.
+
         @param dtdname A filename or URL for the DTD to use.
         @return True if the document is valid.
         @return False if there was a problem with the DTD or XML doc.
      */
     bool validate(const char *dtdname);
 
+    /**
+        Enable or disable the index of child elements by name.
+
+        By default, xml::node::find() and xml::node::elements() look for the
+        elements with the given name by checking all the children of the node
+        in turn. This is fine for the nodes with a few children, but becomes
+        slow when the same node with many children is searched repeatedly.
+
+        When the index is enabled, the children of each node are indexed by
+        their names when they're looked up for the first time, and the
+        subsequent calls to find() and elements() only take the time
+        proportional to the number of matching elements. The index is kept up
+        to date when the document is modified using xmlwrapp API, but its use
+        requires extra memory and makes the modifications slightly slower, so
+        it should only be enabled for the documents with nodes having many
+        children that are searched many times.
+
+        Only the overloads of find() and elements() without the start
+        iterator use the index.
+
+        The index is not copied when the document is copied.
+
+        @param enable Whether the index should be enabled or disabled.
+
+        @since 0.11.0
+     */
+    void enable_child_index(bool enable = true);
+
+    /**
+        Return true if the child elements index is enabled.
+
+        @see enable_child_index()
+
+        @since 0.11.0
+     */
+    bool has_child_index() const;
+
+    /**
+        Return the memory management mode of this document.
+
+        @since 0.11.0
+     */
+    memory_mode get_memory_mode() const;
+
     /**
         Returns the number of child nodes of this document. This will always
         be at least one, since all xmlwrapp documents must have a root node.
@@ -511,9 +688,13 @@ private:
     void* release_doc_data();
 
     friend class tree_parser;
+    friend class qname;
+    friend class attribute_index;
+    friend class dtd;
     friend class relaxng;
     friend class schema;
     friend class xslt::stylesheet;
+    friend class xslt::pipeline;
     friend struct impl::xpath_context_impl;
 };
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xml::dtd class.
+ */
+
+#ifndef _xmlwrapp_dtd_h_
+#define _xmlwrapp_dtd_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/export.h"
+#include "xmlwrapp/errors.h"
+
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xml
+{
+
+// forward declarations
+class document;
+
+namespace impl
+{
+struct dtd_impl;
+}
+
+/**
+    Document Type Definition.
+
+    This class is used to validate documents against an external DTD. Unlike
+    xml::document::validate(const char*), which parses the DTD every time it
+    is called, the DTD is parsed only once when this object is created and
+    can then be used to validate any number of documents.
+
+    The same object can be used to validate different documents from several
+    threads concurrently.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API dtd
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /**
+        Parses the DTD from the given file or URL.
+
+        Errors are handled by @a on_error handler; by default, xml::exception
+        is thrown on errors. If the DTD can't be parsed and the error handler
+        doesn't throw an exception, the constructor will throw xml::exception
+        anyway.
+     */
+    explicit dtd(const char *filename, error_handler& on_error = throw_on_error);
+
+    /**
+        Parses the DTD from memory.
+
+        Errors are handled in the same way as by the other constructor.
+
+        @param data The DTD contents.
+        @param size The size of @a data, in bytes.
+        @param on_error Handler called to process errors and warnings.
+     */
+    dtd(const char *data, size_type size, error_handler& on_error = throw_on_error);
+
+    /// Destructor
+    ~dtd();
+
+    /**
+        Validates the document @a doc against this DTD.
+
+        The document itself is not modified and any DTD it may already have
+        is not used for validation.
+
+        Errors are handled by @a on_error handler; by default, xml::exception
+        is thrown on errors.
+
+        @return `true` if the document is valid with regard to the DTD,
+                `false` otherwise.
+     */
+    bool validate(const document& doc, error_handler& on_error = throw_on_error) const;
+
+private:
+    std::unique_ptr<impl::dtd_impl> pimpl_;
+
+    friend struct impl::dtd_impl;
+
+    // This class is not copyable
+    dtd(const dtd&) = delete;
+    dtd& operator=(const dtd&) = delete;
+};
+
+} // namespace xml
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xmlwrapp_dtd_h_
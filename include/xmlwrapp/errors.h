@@ -43,9 +43,10 @@
 // xmlwrapp includes
 #include "xmlwrapp/export.h"
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
-#include <list>
+#include <vector>
 
 XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 
@@ -53,8 +54,15 @@ XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 namespace xml
 {
 
+class error_message;
 class error_messages;
 
+namespace impl
+{
+class errors_collector;
+struct error_message_builder;
+}
+
 /**
     This exception class is thrown by xmlwrapp for all runtime XML-related
     errors.
@@ -83,6 +91,12 @@ public:
     throw_on_error_or_warning throw on issues, error_messages collects errors
     and warnings without throwing.
 
+    The handler is always called from the thread performing the operation
+    which resulted in the error. The errors of the operations performed in
+    different threads at the same time are never mixed, so there is no need
+    to serialize xmlwrapp calls because of error reporting, as long as each
+    thread uses its own handler object.
+
     @since 0.7.0
  */
 class XMLWRAPP_API error_handler
@@ -95,6 +109,17 @@ public:
 
     /// Called by xmlwrapp to report a warning.
     virtual void on_warning(const std::string& msg) = 0;
+
+    /**
+        Called by xmlwrapp to report an error or a warning with all details.
+
+        The default implementation calls on_error() or on_warning() with the
+        formatted message text. Override this function to use the individual
+        fields of the message, such as its line number, instead.
+
+        @since 0.11.0
+     */
+    virtual void on_message(const error_message& msg);
 };
 
 
@@ -108,6 +133,7 @@ class error_handler_ignore_errors : public error_handler
 public:
     void on_error(const std::string&) override {}
     void on_warning(const std::string&) override {}
+    void on_message(const error_message&) override {}
 };
 
 /**
@@ -146,9 +172,13 @@ extern XMLWRAPP_API error_handler_throw_on_error_or_warning  throw_on_error_or_w
 /**
     Single message in error_messages.
 
+    The messages reported by libxml2 keep all the details provided by it,
+    such as the location of the error, and the human-readable text including
+    all of them is only built when message() is called.
+
     @since 0.7.0
  */
-class error_message
+class XMLWRAPP_API error_message
 {
 public:
     /// A type for different type of errors
@@ -165,18 +195,125 @@ public:
         @param msg_type The error type.
      */
     error_message(const std::string& err_msg, message_type msg_type)
-        : message_(err_msg), type_(msg_type)
+        : text_(err_msg), type_(msg_type)
     {}
 
     /// Get the error message type.
     message_type type() const { return type_; }
 
-    /// Get the error message.
-    const std::string& message() const { return message_; }
+    /**
+        Get the error message.
+
+        For the messages reported by libxml2, the returned string includes
+        the error domain and code and its location, if available.
+
+        @note This function returns the message by value since 0.11.0.
+     */
+    std::string message() const;
+
+    /**
+        Get the message text without any details.
+
+        For the messages not reported by libxml2, this is the same as
+        message().
+
+        @since 0.11.0
+     */
+    const std::string& text() const { return text_; }
+
+    /**
+        Get libxml2 domain of the error.
+
+        This is one of @c xmlErrorDomain values or 0 if the message was not
+        reported by libxml2.
+
+        @since 0.11.0
+     */
+    int domain() const { return domain_; }
+
+    /**
+        Get libxml2 error code.
+
+        This is one of @c xmlParserErrors values or 0 if the message was not
+        reported by libxml2.
+
+        @since 0.11.0
+     */
+    int code() const { return code_; }
+
+    /**
+        Get libxml2 error level.
+
+        This is one of @c xmlErrorLevel values, notice that it can be
+        different from type(), as some libxml2 warnings are really errors.
+
+        @since 0.11.0
+     */
+    int level() const { return level_; }
+
+    /**
+        Get the file in which the error occurred.
+
+        @return The file name or empty string if unknown.
+
+        @since 0.11.0
+     */
+    const std::string& file() const { return file_; }
+
+    /**
+        Get the line at which the error occurred.
+
+        @return The line number or 0 if unknown.
+
+        @since 0.11.0
+     */
+    int line() const { return line_; }
+
+    /**
+        Get the column at which the error occurred.
+
+        @return The column number or 0 if unknown.
+
+        @since 0.11.0
+     */
+    int column() const { return column_; }
+
+    /**
+        Get the extra string information about the error.
+
+        The meaning of this string depends on the error, e.g. it may be the
+        name of the element or the expression being processed.
+
+        @since 0.11.0
+     */
+    const std::string& str1() const { return str1_; }
+
+    /**
+        Get the extra integer information about the error.
+
+        This is typically the position inside str1().
+
+        @since 0.11.0
+     */
+    int int1() const { return int1_; }
 
 private:
-    std::string  message_;
+    std::string  text_;
+    std::string  file_;
+    std::string  str1_;
     message_type type_;
+
+    int          domain_{0};
+    int          code_{0};
+    int          level_{0};
+    int          line_{0};
+    int          column_{0};
+    int          int1_{0};
+
+    // true if the fields above were filled by libxml2
+    bool         has_details_{false};
+
+    friend struct impl::error_message_builder;
 };
 
 
@@ -184,13 +321,27 @@ private:
     The xml::error_messages class is used to store all the error messages
     which are collected while parsing or validating an XML document.
 
+    By default, all messages are stored, however a broken document may
+    result in a huge number of them. To avoid this, the number of errors can
+    be limited using set_max_errors() or stop_on_first_error(). When this
+    object is used as error handler for parsing or validation, xmlwrapp then
+    also stops parsing the document as soon as the limit is reached.
+
     @since 0.7.0
  */
 class XMLWRAPP_API error_messages : public error_handler
 {
 public:
-    /// A type to store multiple messages
-    using messages_type = std::list<error_message>;
+    /**
+        A type to store multiple messages.
+
+        @note This type is std::vector since 0.11.0, it used to be std::list
+              in the previous versions.
+     */
+    using messages_type = std::vector<error_message>;
+
+    /// size type
+    using size_type = std::size_t;
 
     error_messages() = default;
 
@@ -218,12 +369,73 @@ public:
      */
     bool has_errors() const { return has_errors_; }
 
+    /**
+        Limit the number of errors stored in this object.
+
+        Once @a max_errors errors have been stored, any subsequent errors and
+        warnings are discarded and only counted, see get_suppressed_count().
+        Warnings don't count towards the limit.
+
+        When this object is passed as error handler to xml::tree_parser or to
+        xml::event_parser::set_schema() or set_relaxng(), parsing is stopped
+        when the limit is reached. Validation of an already parsed document
+        by xml::dtd, xml::schema or xml::relaxng can't be interrupted, but the
+        number of stored messages is still limited.
+
+        @param max_errors The maximal number of errors to store or 0, which
+                          is the default, to store all of them.
+
+        @since 0.11.0
+     */
+    void set_max_errors(size_type max_errors) { max_errors_ = max_errors; }
+
+    /**
+        Stop at the first error.
+
+        This is the same as calling set_max_errors() with 1 as argument.
+
+        @since 0.11.0
+     */
+    void stop_on_first_error() { set_max_errors(1); }
+
+    /**
+        Get the maximal number of errors stored in this object.
+
+        @return The value set by set_max_errors() or 0 if there is no limit.
+
+        @since 0.11.0
+     */
+    size_type get_max_errors() const { return max_errors_; }
+
+    /**
+        Check if the limit on the number of errors was reached.
+
+        If this function returns true, the operation reporting the errors
+        may have been stopped before finishing.
+
+        @since 0.11.0
+     */
+    bool limit_reached() const
+    {
+        return max_errors_ != 0 && num_errors_ >= max_errors_;
+    }
+
+    /**
+        Get the number of messages discarded because of the limit.
+
+        @see set_max_errors()
+
+        @since 0.11.0
+     */
+    size_type get_suppressed_count() const { return suppressed_count_; }
+
 
     /**
         Convert error messages into a single printable string.
 
         The returned string is typically multiline, with the messages
-        separated with newlines ('\n').
+        separated with newlines ('\n'). If any messages were suppressed, the
+        last line indicates their number.
      */
     std::string print() const;
 
@@ -232,6 +444,7 @@ public:
     // Implementation of error_handler methods:
     void on_error(const std::string& msg) override;
     void on_warning(const std::string& msg) override;
+    void on_message(const error_message& msg) override;
 
 protected:
     /// Called by print() to format a single message.
@@ -242,6 +455,12 @@ private:
 
     bool          has_errors_{false};
     bool          has_warnings_{false};
+
+    size_type     max_errors_{0};
+    size_type     num_errors_{0};
+    size_type     suppressed_count_{0};
+
+    friend class impl::errors_collector;
 };
 
 
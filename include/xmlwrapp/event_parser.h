@@ -42,6 +42,7 @@
 // xmlwrapp includes
 #include "xmlwrapp/init.h"
 #include "xmlwrapp/export.h"
+#include "xmlwrapp/errors.h"
 
 // standard includes
 #include <cstddef>
@@ -55,6 +56,10 @@ XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 namespace xml
 {
 
+class name_dictionary;
+class relaxng;
+class schema;
+
 namespace impl
 {
 struct epimpl; // forward declaration of private implementation
@@ -77,8 +82,66 @@ public:
     /// Default constructor.
     event_parser();
 
+    /**
+        Create a parser storing the element and attribute names in the given
+        shared dictionary, see xml::name_dictionary.
+
+        @since 0.11.0
+     */
+    explicit event_parser(name_dictionary& dict);
+
     virtual ~event_parser();
 
+    /**
+        Validate the document against the given XML Schema while parsing it.
+
+        This allows to validate the documents without building their tree,
+        and so using only a constant amount of memory, which is useful for
+        very big documents. The callbacks of this class are still called
+        while the document is being validated.
+
+        This function must be called before starting parsing and the schema
+        must remain valid until the parsing is finished. It replaces any
+        schema previously set with set_relaxng().
+
+        Validation errors and warnings are collected while parsing and
+        reported to @a on_error by parse_finish(), which is also called by
+        parse_file() and parse_stream(). By default, xml::exception is thrown
+        if the document is invalid. If the handler doesn't throw, the parsing
+        functions return false for invalid documents and get_error_message()
+        returns the first validation error.
+
+        @param xsd The schema to validate against.
+        @param on_error Handler called to process validation errors and warnings.
+
+        @since 0.11.0
+     */
+    void set_schema(const schema& xsd, error_handler& on_error = throw_on_error);
+
+    /**
+        Validate the document against the given RelaxNG schema while parsing it.
+
+        This is similar to set_schema(), but uses RelaxNG instead of XML Schema.
+        Only the elements containing the current one are kept in memory while
+        validating, unless the schema requires the entire element contents to
+        validate it, e.g. because it uses interleave or data types: in this
+        case, the subtree of this element is built while parsing it and
+        validated when it ends. In the worst case, e.g. if the schema doesn't
+        allow validating the root element in streaming mode, the entire
+        document tree is built, so the schemas should be written with this in
+        mind when validating very big documents.
+
+        This function must be called before starting parsing and the schema
+        must remain valid until the parsing is finished. It replaces any
+        schema previously set with set_schema().
+
+        @param rng The RelaxNG schema to validate against.
+        @param on_error Handler called to process validation errors and warnings.
+
+        @since 0.11.0
+     */
+    void set_relaxng(const relaxng& rng, error_handler& on_error = throw_on_error);
+
     /**
         Call this member function to parse the given file.
 
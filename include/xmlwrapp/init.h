@@ -46,6 +46,8 @@
 namespace xml
 {
 
+class allocator;
+
 /**
     The xml::init class is used to configure the XML parser.
 
@@ -53,7 +55,16 @@ namespace xml
     you start any threads or use any other part of xmlwrapp. The member
     functions may alter global and/or static variables and affect the behavior
     of subsequently created classes (and the parser in particular).
-    In other words, this class is not thread safe.
+    In other words, these functions are not thread safe.
+
+    Creating and destroying the objects of this class is thread safe, however:
+    the library is initialized only once, when the first object is created,
+    and the objects created concurrently in the other threads wait until the
+    initialization is complete. The library is shut down when the last object
+    is destroyed, which normally only happens at the program exit, but not
+    before all parsing, XPath evaluation, validation and transformation
+    operations running in the other threads finish. See @ref threads for more
+    information about using xmlwrapp from multiple threads.
 
     @note In xmlwrapp versions prior to 0.6.0, this class was used to initialize
           the library and exactly one instance had to be created before first
@@ -169,14 +180,65 @@ public:
      */
     static bool validate_xml(bool flag);
 
+    /**
+        Set the allocator used for all memory allocated by libxml2 (and
+        libxslt, if xsltwrapp is used).
+
+        By default, libxml2 uses the standard @c malloc() and @c free(). This
+        function allows to use a custom allocator instead, e.g.
+        xml::pool_allocator for speeding up the allocation of many small
+        blocks used by the document nodes or xml::counting_allocator for
+        measuring the memory used.
+
+        As the library is already initialized when this function is called,
+        it shuts down and initializes libxml2 again to ensure that all the
+        memory is allocated and freed by the same allocator. Because of this,
+        this function must be called before any other xmlwrapp objects, such
+        as documents, parsers or compiled schemas and stylesheets, are
+        created, and before any threads using the library are started,
+        typically at the very beginning of main(). Like the other functions
+        of this class, it is not thread safe.
+
+        The allocator must remain valid for as long as it is used, i.e. until
+        this function is called again to replace it or to restore the default
+        allocator, which should be done before destroying it.
+
+        @code
+        int main()
+        {
+            xml::pool_allocator pool;
+            xml::init::set_allocator(&pool);
+
+            ... use xmlwrapp normally ...
+
+            xml::init::set_allocator(nullptr);
+            return 0;
+        }
+        @endcode
+
+        @param alloc The allocator to use or null to restore the default one.
+        @return The previously used allocator or null if it was the default.
+
+        @since 0.11.0
+     */
+    static allocator* set_allocator(allocator *alloc);
+
+    /**
+        Get the allocator currently used by libxml2.
+
+        @return The allocator set by set_allocator() or null if the default
+                allocator is used.
+
+        @since 0.11.0
+     */
+    static allocator* get_allocator();
+
 private:
     init(const init&) = delete;
     init& operator=(const init&) = delete;
 
     void init_library();
     void shutdown_library();
-
-    static int ms_counter;
 };
 
 } // namespace xml
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xml::name_dictionary class.
+ */
+
+#ifndef _xmlwrapp_name_dictionary_h_
+#define _xmlwrapp_name_dictionary_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xml
+{
+
+namespace impl
+{
+struct name_dictionary_impl;
+}
+
+/**
+    Dictionary of element and attribute names shared between parsers.
+
+    libxml2 stores ("interns") all the names it encounters while parsing a
+    document in a dictionary, so that each distinct name is allocated only once
+    and names can be compared by comparing pointers. By default, every parsed
+    document gets a dictionary of its own. When many documents using the same
+    vocabulary are parsed, sharing a single dictionary between them avoids
+    re-interning the same names over and over again and makes the names of
+    all these documents comparable by pointer.
+
+    A name_dictionary can be passed to xml::tree_parser, xml::event_parser and
+    xml::document constructors. The dictionary is reference counted, so the
+    documents parsed using it keep it alive even after the name_dictionary
+    object itself is destroyed.
+
+    By default, a dictionary can only be used from a single thread at a time,
+    as libxml2 dictionaries are not protected against concurrent modifications.
+    If it needs to be shared between parsers running concurrently in different
+    threads, it must be created in thread_safe mode. In this mode, the shared
+    dictionary becomes read-only once it has been used for parsing and each
+    parser gets a private sub-dictionary which is consulted for the names not
+    present in the shared one. Such dictionary should be filled with the
+    names of the vocabulary using intern() before using it for parsing.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API name_dictionary
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// Threading mode of the dictionary, see name_dictionary description.
+    enum threading_mode
+    {
+        single_threaded,    ///< Usable from one thread only (default).
+        thread_safe         ///< Usable from concurrently running parsers.
+    };
+
+    /**
+        Create a new empty dictionary.
+
+        @param mode Whether the dictionary may be used by several threads.
+     */
+    explicit name_dictionary(threading_mode mode = single_threaded);
+
+    /// Destructor.
+    ~name_dictionary();
+
+    /// Get the threading mode this dictionary was created with.
+    threading_mode get_threading_mode() const;
+
+    /**
+        Add the given name to the dictionary if it's not there yet.
+
+        In thread_safe mode, this function can only be called before the
+        dictionary is used for parsing and throws xml::exception otherwise.
+
+        @param name The name to intern.
+        @return Pointer to the unique copy of the name stored in the
+                dictionary, which remains valid as long as the dictionary,
+                or any document using it, exists.
+     */
+    const char *intern(const char *name);
+
+    /**
+        Check if the given name is present in the dictionary.
+
+        @return Pointer to the interned copy of the name or @c nullptr.
+     */
+    const char *find(const char *name) const;
+
+    /// Get the number of distinct names in the dictionary.
+    size_type size() const;
+
+private:
+    std::unique_ptr<impl::name_dictionary_impl> pimpl_;
+
+    friend struct impl::name_dictionary_impl;
+
+    // This class is not copyable
+    name_dictionary(const name_dictionary&) = delete;
+    name_dictionary& operator=(const name_dictionary&) = delete;
+};
+
+} // namespace xml
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xmlwrapp_name_dictionary_h_
@@ -61,6 +61,8 @@ namespace xml
 // forward declarations
 class document;
 class attributes;
+class qname;
+class attribute_index;
 class nodes_view;
 class const_nodes_view;
 
@@ -73,6 +75,7 @@ struct doc_impl;
 struct nipimpl;
 struct node_cmp;
 struct xpath_context_impl;
+struct xpath_value_impl;
 }
 
 
@@ -475,6 +478,7 @@ public:
 
         friend class node;
         friend class document;
+        friend class attribute_index;
         friend class const_iterator;
         friend bool XMLWRAPP_API operator==(const iterator& lhs, const iterator& rhs);
     };
@@ -677,6 +681,79 @@ public:
      */
     const_iterator find(const char *name, const const_iterator& start) const;
 
+    /**
+        Find the first child element with the given name in the given
+        namespace. If no such node can be found, this function will return
+        the same iterator that end() would return.
+
+        Unlike find(const char*), which only compares the local names, this
+        function only matches the elements in the specified namespace.
+
+        @param name The local name of the element to find.
+        @param ns_uri The namespace URI of the element. If it is @c nullptr
+                      or empty, only elements without namespace match.
+        @return An iterator that points to the node if found.
+        @return An end() iterator if the node was not found.
+
+        @since 0.11.0
+     */
+    iterator find(const char *name, const char *ns_uri);
+
+    /**
+        Find the first child element with the given name in the given
+        namespace.
+
+        @see find(const char*, const char*)
+
+        @since 0.11.0
+     */
+    const_iterator find(const char *name, const char *ns_uri) const;
+
+    /**
+        Find the first child element with the given qualified name.
+
+        This is the same as find(const char*) but faster, especially when
+        looking up the same name repeatedly, and also takes the namespace of
+        the name into account.
+
+        @param name The name of the element to find.
+        @return An iterator that points to the node if found.
+        @return An end() iterator if the node was not found.
+
+        @since 0.11.0
+     */
+    iterator find(const qname& name);
+
+    /**
+        Find the first child element with the given qualified name.
+
+        @see find(const qname&)
+
+        @since 0.11.0
+     */
+    const_iterator find(const qname& name) const;
+
+    /**
+        Find the first child element, starting with the given iterator, with
+        the given qualified name.
+
+        @see find(const char*, const iterator&), find(const qname&)
+
+        @since 0.11.0
+     */
+    iterator find(const qname& name, const iterator& start);
+
+    /**
+        Find the first child element, starting with the given const_iterator,
+        with the given qualified name.
+
+        @see find(const char*, const const_iterator&) const,
+             find(const qname&)
+
+        @since 0.11.0
+     */
+    const_iterator find(const qname& name, const const_iterator& start) const;
+
     /**
         Returns view of child nodes of type type_element. If no such node
         can be found, returns empty view.
@@ -752,6 +829,58 @@ public:
      */
     const_nodes_view elements(const char *name) const;
 
+    /**
+        Returns view of child elements with the given name in the given
+        namespace.
+
+        Example:
+        @code
+        for (const auto& entry : feed.elements("entry", "http://www.w3.org/2005/Atom"))
+        {
+          ...
+        }
+        @endcode
+
+        @param  name Local name of the elements to return.
+        @param  ns_uri The namespace URI of the elements. If it is @c nullptr
+                       or empty, only elements without namespace are returned.
+        @return View that contains only elements @a name in @a ns_uri.
+        @since  0.11.0
+     */
+    nodes_view elements(const char *name, const char *ns_uri);
+
+    /**
+        Returns view of child elements with the given name in the given
+        namespace.
+
+        @see elements(const char*, const char*)
+
+        @since  0.11.0
+     */
+    const_nodes_view elements(const char *name, const char *ns_uri) const;
+
+    /**
+        Returns view of child elements with the given qualified name.
+
+        This is the same as elements(const char*) but faster, especially when
+        iterating over many elements, and also takes the namespace of the name
+        into account.
+
+        @param  name Name of the elements to return.
+        @return View that contains only elements @a name.
+        @since  0.11.0
+     */
+    nodes_view elements(const qname& name);
+
+    /**
+        Returns view of child elements with the given qualified name.
+
+        @see elements(const qname&)
+
+        @since  0.11.0
+     */
+    const_nodes_view elements(const qname& name) const;
+
     /**
         Insert a new child node. The new node will be inserted at the end of
         the child list. This is similar to the xml::node::push_back member
@@ -893,6 +1022,7 @@ private:
     friend struct impl::node_cmp;
     friend class xml::const_nodes_view;
     friend struct impl::xpath_context_impl;
+    friend struct impl::xpath_value_impl;
 };
 
 // Comparison operators for xml::node iterators
@@ -62,6 +62,7 @@ namespace impl
 struct nipimpl;
 class iter_advance_functor;
 struct xpath_context_impl;
+struct xpath_value_impl;
 
 } // namespace impl
 
@@ -293,6 +294,7 @@ private:
 
     friend class node;
     friend struct impl::xpath_context_impl;
+    friend struct impl::xpath_value_impl;
 };
 
 // Comparison operators for xml::[const_]nodes_view iterators
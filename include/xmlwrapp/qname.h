@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xml::qname class.
+ */
+
+#ifndef _xmlwrapp_qname_h_
+#define _xmlwrapp_qname_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xml
+{
+
+// forward declarations
+class document;
+
+namespace impl
+{
+struct qname_impl;
+}
+
+/**
+    Name of an element or attribute, resolved for efficient lookups.
+
+    A qname combines the local name with an optional namespace URI. It is
+    resolved once against the dictionary of the document it is created for,
+    after which checking whether a node of this document has this name only
+    requires comparing pointers instead of strings. This makes it much faster
+    to use xml::node::find(), xml::node::elements() or xml::attributes::find()
+    with a qname than with a string when the same name is looked up many
+    times, e.g. in a loop over the elements of a big document.
+
+    Example:
+    @code
+    const xml::qname item(doc, "item", "http://example.com/ns");
+    for (auto& order : root.elements())
+    {
+        for (auto& i : order.elements(item))
+            ...
+    }
+    @endcode
+
+    A qname can be used with any document, but it is only faster than a string
+    for the document it was created for and only if this document stores its
+    names in a dictionary, which is the case for all parsed documents.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API qname
+{
+public:
+    /**
+        Create a name matching nodes with the given local name in any
+        namespace, or in no namespace at all.
+
+        @param doc The document in which the name will be looked up.
+        @param local_name The local name, i.e. without any namespace prefix.
+     */
+    qname(const document& doc, const char *local_name);
+
+    /**
+        Create a name matching nodes with the given local name in the given
+        namespace.
+
+        @param doc The document in which the name will be looked up.
+        @param local_name The local name, i.e. without any namespace prefix.
+        @param ns_uri The namespace URI. If it is @c nullptr or empty, only
+                      the nodes which are not in any namespace match.
+     */
+    qname(const document& doc, const char *local_name, const char *ns_uri);
+
+    /// Copy constructor.
+    qname(const qname& other);
+
+    /// Assignment operator.
+    qname& operator=(const qname& other);
+
+    /// Destructor.
+    ~qname();
+
+    /// Get the local name.
+    const char *get_name() const;
+
+    /**
+        Get the namespace URI.
+
+        @return The namespace URI or @c nullptr if the name matches nodes
+                in any namespace or nodes without namespace.
+     */
+    const char *get_namespace() const;
+
+    /// Return true if this name matches nodes in any namespace.
+    bool matches_any_namespace() const;
+
+private:
+    std::unique_ptr<impl::qname_impl> pimpl_;
+
+    friend struct impl::qname_impl;
+};
+
+} // namespace xml
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xmlwrapp_qname_h_
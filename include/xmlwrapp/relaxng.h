@@ -45,6 +45,7 @@
 #include "xmlwrapp/errors.h"
 
 #include <memory>
+#include <vector>
 
 XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 
@@ -66,6 +67,14 @@ struct relaxng_impl;
     This class is used to validate documents against RelaxNG schemas expressed
     in XML syntax (compact RelaxNG syntax is not supported).
 
+    Validating documents is thread-safe: the same relaxng object can be used to
+    validate different documents from several threads at the same time, with
+    each thread using its own error handler. The validation contexts needed
+    for this are reused by the subsequent calls to validate(), so validating
+    many small documents is cheap. However a single document must not be
+    validated by more than one thread at once, nor modified while it is being
+    validated.
+
     @since 0.9.0
  */
 class XMLWRAPP_API relaxng
@@ -95,9 +104,50 @@ public:
      */
     bool validate(const document& doc, error_handler& on_error = throw_on_error) const;
 
+    /**
+        Validates many documents using several threads.
+
+        The documents are distributed among the worker threads, which validate
+        them concurrently. This is equivalent to calling validate() for every
+        document, but faster on multi-core machines.
+
+        @param docs The documents to validate, they must all be different.
+        @param num_threads The number of threads to use, the number of
+                           processors is used by default.
+        @return Errors and warnings for each of the documents, in the same
+                order as @a docs. A document is valid if and only if there are
+                no errors for it.
+
+        @since 0.11.0
+     */
+    std::vector<error_messages>
+    validate_batch(const std::vector<const document*>& docs,
+                   unsigned num_threads = 0) const;
+
+    /**
+        Validates all documents in the given range using several threads.
+
+        This is a convenient overload for validating documents stored in any
+        container.
+
+        @since 0.11.0
+     */
+    template <typename Iterator>
+    std::vector<error_messages>
+    validate_batch(Iterator first, Iterator last, unsigned num_threads = 0) const
+    {
+        std::vector<const document*> docs;
+        for ( ; first != last; ++first )
+            docs.push_back(&*first);
+
+        return validate_batch(docs, num_threads);
+    }
+
 private:
     std::unique_ptr<impl::relaxng_impl> pimpl_;
 
+    friend struct impl::relaxng_impl;
+
     // This class is not copyable
     relaxng(const relaxng&) = delete;
     relaxng& operator=(const relaxng&) = delete;
@@ -42,6 +42,7 @@
 
 // xmlwrapp includes
 #include "xmlwrapp/init.h"
+#include "xmlwrapp/document.h"
 #include "xmlwrapp/export.h"
 #include "xmlwrapp/errors.h"
 
@@ -56,7 +57,7 @@ namespace xml
 {
 
 // forward declarations
-class document;
+class name_dictionary;
 
 namespace impl
 {
@@ -100,6 +101,60 @@ public:
      */
     tree_parser(const char *data, size_type size, error_handler& on_error = throw_on_error);
 
+    /**
+        Parse the given file using a shared names dictionary.
+
+        The element and attribute names of the parsed document are stored in
+        the given dictionary instead of a new one, see xml::name_dictionary.
+
+        @param filename The name of the file to parse.
+        @param dict The dictionary to use.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    tree_parser(const char *filename, name_dictionary& dict, error_handler& on_error = throw_on_error);
+
+    /**
+        Parse the given data using a shared names dictionary.
+
+        @param data The XML data to parse.
+        @param size The size of the XML data to parse.
+        @param dict The dictionary to use, see xml::name_dictionary.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    tree_parser(const char *data, size_type size, name_dictionary& dict,
+                error_handler& on_error = throw_on_error);
+
+    /**
+        Parse the given file creating the document in the given memory mode.
+
+        See xml::document::memory_mode for the description of the modes.
+
+        @param filename The name of the file to parse.
+        @param mode The memory management mode of the document.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    tree_parser(const char *filename, document::memory_mode mode,
+                error_handler& on_error = throw_on_error);
+
+    /**
+        Parse the given data creating the document in the given memory mode.
+
+        @param data The XML data to parse.
+        @param size The size of the XML data to parse.
+        @param mode The memory management mode of the document.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    tree_parser(const char *data, size_type size, document::memory_mode mode,
+                error_handler& on_error = throw_on_error);
+
     /**
         xml::tree_parser class constructor. Given the name of a file, this
         constructor will parse that file.
@@ -191,8 +246,10 @@ public:
     const xml::document& get_document() const;
 
 private:
-    void init(const char *filename, error_handler *on_error);
-    void init(const char *data, size_type size, error_handler *on_error);
+    void init(const char *filename, name_dictionary *dict,
+              document::memory_mode mode, error_handler *on_error);
+    void init(const char *data, size_type size, name_dictionary *dict,
+              document::memory_mode mode, error_handler *on_error);
 
     std::unique_ptr<impl::tree_impl> pimpl_;
 
@@ -36,13 +36,18 @@
 
 #include "xmlwrapp/version.h"
 #include "xmlwrapp/init.h"
+#include "xmlwrapp/allocator.h"
 #include "xmlwrapp/nodes_view.h"
 #include "xmlwrapp/node.h"
 #include "xmlwrapp/attributes.h"
 #include "xmlwrapp/document.h"
 #include "xmlwrapp/tree_parser.h"
+#include "xmlwrapp/name_dictionary.h"
+#include "xmlwrapp/qname.h"
+#include "xmlwrapp/attribute_index.h"
 #include "xmlwrapp/event_parser.h"
 #include "xmlwrapp/errors.h"
+#include "xmlwrapp/dtd.h"
 #include "xmlwrapp/relaxng.h"
 #include "xmlwrapp/schema.h"
 #include "xmlwrapp/xpath.h"
@@ -47,8 +47,10 @@
 #include "xmlwrapp/export.h"
 #include "xmlwrapp/nodes_view.h"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 
@@ -61,8 +63,114 @@ class document;
 namespace impl
 {
 struct xpath_context_impl;
+struct xpath_value_impl;
 }
 
+/**
+    Value of an XPath expression.
+
+    This class is used for the arguments and the return values of the XPath
+    extension functions, see xml::xpath_function. The value may be of any of
+    the XPath types: a node-set, a boolean, a number or a string. It can be
+    converted to any other type, except for node-set, using the usual XPath
+    conversion rules.
+
+    @since 0.11.0
+ */
+class XMLWRAPP_API xpath_value
+{
+public:
+    /// Type of the value.
+    enum value_type
+    {
+        type_node_set,  ///< Set of nodes (also used for result tree fragments).
+        type_boolean,   ///< Boolean value.
+        type_number,    ///< Floating point number.
+        type_string     ///< String.
+    };
+
+    /// Create an empty node-set.
+    xpath_value();
+
+    /// Create a boolean value.
+    xpath_value(bool value);
+
+    /// Create a number value.
+    xpath_value(double value);
+
+    /// Create a number value.
+    xpath_value(int value);
+
+    /// Create a string value.
+    xpath_value(const std::string& value);
+
+    /// Create a string value.
+    xpath_value(const char *value);
+
+    /**
+        Create a node-set containing a single node.
+
+        The node must remain valid for as long as this value is used.
+     */
+    explicit xpath_value(const node& n);
+
+    /**
+        Create a node-set containing all nodes of the given view.
+
+        The nodes must remain valid for as long as this value is used.
+     */
+    explicit xpath_value(const const_nodes_view& nodes);
+
+    /// Copy constructor.
+    xpath_value(const xpath_value& other);
+
+    /// Assignment operator.
+    xpath_value& operator=(const xpath_value& other);
+
+    /// Destructor.
+    ~xpath_value();
+
+    /// Get the type of this value.
+    value_type get_type() const;
+
+    /// Convert the value to boolean using XPath boolean() function rules.
+    bool as_boolean() const;
+
+    /// Convert the value to number using XPath number() function rules.
+    double as_number() const;
+
+    /// Convert the value to string using XPath string() function rules.
+    std::string as_string() const;
+
+    /**
+        Get the nodes of a node-set value.
+
+        Throws xml::exception if the value is not a node-set.
+     */
+    const_nodes_view as_nodes() const;
+
+private:
+    std::unique_ptr<impl::xpath_value_impl> pimpl_;
+
+    friend struct impl::xpath_value_impl;
+};
+
+/**
+    Type of the XPath extension functions.
+
+    The function is called with the values of all the arguments given to it
+    in the XPath expression, and should check that their number is correct
+    and convert them to the expected types, as needed. It may throw an
+    exception to indicate an error, which is then reported using the error
+    handler of the expression evaluation or the transformation and stops it.
+
+    @see xpath_context::register_function(),
+         xslt::stylesheet::register_function()
+
+    @since 0.11.0
+ */
+using xpath_function = std::function<xpath_value (const std::vector<xpath_value>& args)>;
+
 /**
     Context in which XPath expressions can be evaluated.
 
@@ -98,6 +206,23 @@ public:
      */
     void register_namespace(const std::string& prefix, const std::string& href);
 
+    /**
+        Register an extension function.
+
+        The function can then be called from the XPath expressions evaluated
+        in this context. If it is in a namespace, the prefix used for it in
+        the expressions must be registered using register_namespace().
+
+        @param name    The local name of the function.
+        @param ns_uri  The namespace URI of the function, may be empty.
+        @param func    The function to call.
+
+        @since 0.11.0
+     */
+    void register_function(const std::string& name,
+                           const std::string& ns_uri,
+                           xpath_function func);
+
     /**
         Execute an XPath query in the document scope.
 
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::batch_transform class.
+ */
+
+#ifndef _xsltwrapp_batch_transform_h_
+#define _xsltwrapp_batch_transform_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xsltwrapp/stylesheet.h"
+#include "xmlwrapp/export.h"
+#include "xmlwrapp/errors.h"
+
+// standard includes
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+class param_set;
+
+namespace impl
+{
+struct batch_transform_impl;
+}
+
+/**
+    Applies a stylesheet to many independent documents using several threads.
+
+    Each document of the batch is parsed, transformed and serialized by one
+    of the worker threads, which all share the same compiled stylesheet but
+    use their own transformation contexts and error handlers, see the thread
+    safety section of xslt::stylesheet documentation.
+
+    The documents are read from the input source and the results are passed
+    to the output sink, both of which are callbacks provided by the
+    application. They are called from the worker threads, but never
+    concurrently, so they don't need to be thread-safe themselves. Notice
+    that the results are passed to the sink in the order in which the
+    documents are processed, which may be different from their input order.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API batch_transform
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// A document to transform.
+    struct input
+    {
+        /// Name identifying the document in the results.
+        std::string name;
+
+        /// The file to parse the document from, if not empty.
+        std::string filename;
+
+        /// The document contents, only used if filename is empty.
+        std::string data;
+    };
+
+    /// The result of transforming a single document.
+    struct result
+    {
+        /// Position of the document in the input sequence.
+        size_type index;
+
+        /// Name of the document, from input::name.
+        std::string name;
+
+        /// True if the document was parsed and transformed successfully.
+        bool success;
+
+        /// The serialized result of the transformation, empty on failure.
+        std::string output;
+
+        /// Errors and warnings which occurred while processing the document.
+        xml::error_messages errors;
+    };
+
+    /// Statistics about a batch run, returned by run().
+    struct statistics
+    {
+        /// Number of documents processed.
+        size_type documents{0};
+
+        /// Number of documents which couldn't be parsed or transformed.
+        size_type failures{0};
+
+        /// Total size of the input documents, in bytes.
+        unsigned long long input_bytes{0};
+
+        /// Total size of the serialized results, in bytes.
+        unsigned long long output_bytes{0};
+
+        /// Time taken by the entire run.
+        std::chrono::microseconds elapsed{0};
+
+        /// Get the number of documents processed per second.
+        double documents_per_second() const;
+
+        /// Get the number of input bytes processed per second.
+        double bytes_per_second() const;
+    };
+
+    /**
+        Function providing the documents to transform.
+
+        It should fill @a next and return true or return false if there are
+        no more documents.
+     */
+    using input_source = std::function<bool (input& next)>;
+
+    /// Function called with the result of transforming each document.
+    using output_sink = std::function<void (const result& res)>;
+
+    /**
+        Create the batch using the given stylesheet.
+
+        The stylesheet must remain valid for as long as this object is used
+        and must not be modified while run() is executing.
+
+        @param style The stylesheet to apply to all documents.
+        @param num_threads The number of worker threads, the number of
+                           processors is used by default.
+     */
+    explicit batch_transform(const stylesheet& style, size_type num_threads = 0);
+
+    /// Destructor.
+    ~batch_transform();
+
+    /// Get the number of worker threads used.
+    size_type get_num_threads() const;
+
+    /// Set the parameters used for transforming all documents.
+    void set_params(const param_set& params);
+
+    /**
+        Transform all documents provided by the source.
+
+        This function returns after all documents have been processed. If the
+        source or the sink throw an exception, no new documents are started,
+        and the exception is rethrown from this function after the documents
+        being processed are finished.
+
+        @param source Function called to get the documents to transform.
+        @param sink Function called with the result of each document.
+        @return Statistics about this run.
+     */
+    statistics run(const input_source& source, const output_sink& sink);
+
+    /**
+        Transform all the given files.
+
+        This is a convenient wrapper for run() using the file names as
+        document names.
+     */
+    statistics run(const std::vector<std::string>& filenames,
+                   const output_sink& sink);
+
+private:
+    std::unique_ptr<impl::batch_transform_impl> pimpl_;
+
+    // This class is not copyable
+    batch_transform(const batch_transform&) = delete;
+    batch_transform& operator=(const batch_transform&) = delete;
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_batch_transform_h_
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::document_cache class.
+ */
+
+#ifndef _xsltwrapp_document_cache_h_
+#define _xsltwrapp_document_cache_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+namespace impl
+{
+struct document_cache_impl;
+}
+
+/**
+    Cache of the documents loaded by XSLT document() function.
+
+    By default, the documents loaded by the stylesheets using document()
+    function are parsed again during each transformation, which may be
+    expensive for big documents, e.g. lookup tables used by many
+    transformations. When a document_cache is associated with a stylesheet
+    using xslt::stylesheet::set_document_cache(), the documents are parsed
+    only once and kept in memory, indexed by their URIs, and subsequent
+    transformations use copies of the parsed documents instead of parsing
+    them again. The copies are needed because libxslt may modify the loaded
+    documents, e.g. to strip whitespace, but making them is much cheaper than
+    parsing.
+
+    The documents loaded from local files are parsed again if the file was
+    modified since it was cached, as determined by comparing its modification
+    time and size. The documents loaded from the other URIs are kept in the
+    cache until they're removed from it explicitly or evicted.
+
+    The memory used by the cached documents is limited: when it exceeds the
+    maximal allowed amount, the least recently used documents are evicted
+    from the cache. The documents bigger than the limit are not cached at
+    all. Notice that the memory used by the documents can only be estimated.
+
+    The same cache can be shared by several stylesheets and used from several
+    threads concurrently.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API document_cache
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// Statistics about the cache usage, see get_statistics().
+    struct statistics
+    {
+        /// Number of documents taken from the cache.
+        size_type hits{0};
+
+        /// Number of documents which had to be parsed.
+        size_type misses{0};
+
+        /// Number of documents evicted from the cache because it was full.
+        size_type evictions{0};
+    };
+
+    /**
+        Create a new empty cache.
+
+        @param max_memory The maximal amount of memory, in bytes, used by the
+                          cached documents, must be positive.
+     */
+    explicit document_cache(size_type max_memory = 256*1024*1024);
+
+    /// Destructor.
+    ~document_cache();
+
+    /**
+        Remove the document with the given URI from the cache.
+
+        This can be used to force parsing the document again if it was
+        modified, which is only necessary for the documents not loaded from
+        local files.
+
+        @param uri The URI of the document, as used by the stylesheet, i.e.
+                   after resolving it relatively to the stylesheet base URI.
+        @return true if the document was in the cache.
+     */
+    bool remove(const char *uri);
+
+    /// Remove all documents from the cache.
+    void clear();
+
+    /// Get the number of documents currently in the cache.
+    size_type size() const;
+
+    /// Get the estimated amount of memory used by the cached documents.
+    size_type get_memory_used() const;
+
+    /// Get the maximal amount of memory used by the cached documents.
+    size_type get_max_memory() const;
+
+    /**
+        Change the maximal amount of memory used by the cached documents.
+
+        If the cached documents currently use more memory than @a max_memory,
+        the least recently used ones are evicted from the cache immediately.
+     */
+    void set_max_memory(size_type max_memory);
+
+    /// Get the statistics of the cache usage since its creation.
+    statistics get_statistics() const;
+
+private:
+    std::unique_ptr<impl::document_cache_impl> pimpl_;
+
+    friend struct impl::document_cache_impl;
+
+    // This class is not copyable
+    document_cache(const document_cache&) = delete;
+    document_cache& operator=(const document_cache&) = delete;
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_document_cache_h_
@@ -52,8 +52,11 @@ namespace xslt
 
     If you want to use any of the xslt::init member functions, do so before
     you start any threads or use any other part of xsltwrapp. The member
-    functions may alter global and/or static variables. In other words, this
-    class is not thread safe.
+    functions may alter global and/or static variables. In other words, these
+    functions are not thread safe.
+
+    Creating and destroying the objects of this class is thread safe, in the
+    same way as for xml::init.
 
     @note In xmlwrapp versions prior to 0.6.0, this class was used to initialize
           the library and exactly one instance had to be created before first
@@ -79,10 +82,8 @@ private:
     init(const init&) = delete;
     init& operator=(const init&) = delete;
 
-    void init_library();
-    void shutdown_library();
-
-    static int ms_counter;
+    static void init_library();
+    static void shutdown_library();
 }; // end xslt::init class
 
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::param_set class.
+ */
+
+#ifndef _xsltwrapp_param_set_h_
+#define _xsltwrapp_param_set_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+#include <string>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+namespace impl
+{
+struct param_set_impl;
+}
+
+/**
+    Typed set of parameters for xslt::stylesheet::apply().
+
+    Unlike xslt::stylesheet::param_type, which contains raw XPath expressions
+    and so requires quoting the string values, this class allows to specify
+    the parameter values of the given types. It is meant to be constructed
+    once and reused for many transformations: the parameters are converted
+    to the form used by libxslt and checked for validity when they are set
+    and not for every transformation. String parameters are passed to
+    libxslt as is and don't need to be evaluated at all, while the other
+    ones are still evaluated by libxslt for each transformation, as their
+    values may depend on the document being transformed.
+
+    Setting a parameter which was already set replaces its value.
+
+    This class is not thread-safe, but a const param_set object can be used
+    by several transformations running concurrently.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API param_set
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// Create an empty set of parameters.
+    param_set();
+
+    /// Copy constructor.
+    param_set(const param_set& other);
+
+    /// Assignment operator.
+    param_set& operator=(const param_set& other);
+
+    /// Destructor.
+    ~param_set();
+
+    /**
+        Set a string parameter.
+
+        The value is used literally, without any need for quoting.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    param_set& set_string(const char *name, const std::string& value);
+
+    /**
+        Set a numeric parameter.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    param_set& set_number(const char *name, double value);
+
+    /**
+        Set a boolean parameter.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    param_set& set_boolean(const char *name, bool value);
+
+    /**
+        Set a parameter to the value of an XPath expression.
+
+        This can be used for the parameters of any type, but is mostly useful
+        for the node-set parameters, as the expression is evaluated in the
+        context of the document being transformed, e.g. "/root/child" selects
+        all the child elements of the input document root element.
+
+        The expression is checked for validity and xml::exception is thrown
+        if it is invalid.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    param_set& set_expression(const char *name, const std::string& xpath);
+
+    /**
+        Remove the parameter with the given name.
+
+        @return true if the parameter was removed, false if it wasn't set.
+     */
+    bool remove(const char *name);
+
+    /// Remove all parameters.
+    void clear();
+
+    /// Get the number of the parameters.
+    size_type size() const;
+
+    /// Check if there are no parameters.
+    bool empty() const { return size() == 0; }
+
+private:
+    std::unique_ptr<impl::param_set_impl> pimpl_;
+
+    friend struct impl::param_set_impl;
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_param_set_h_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::pipeline class.
+ */
+
+#ifndef _xsltwrapp_pipeline_h_
+#define _xsltwrapp_pipeline_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xsltwrapp/stylesheet.h"
+#include "xmlwrapp/document.h"
+#include "xmlwrapp/export.h"
+#include "xmlwrapp/errors.h"
+
+// standard includes
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+class param_set;
+
+namespace impl
+{
+struct pipeline_impl;
+}
+
+/**
+    Sequence of stylesheets applied one after another.
+
+    Applying a pipeline to a document applies its first stylesheet to it,
+    then applies the second stylesheet to the result of the first one and so
+    on. The intermediate results are passed directly from one stylesheet to
+    the next one, without being serialized or copied, and only the result of
+    the last stylesheet is returned or written out, using the output method
+    and encoding specified by the last stylesheet.
+
+    A pipeline doesn't modify the stylesheets it uses, so it can be applied
+    from several threads concurrently, under the same conditions as
+    xslt::stylesheet::apply(), once all the stylesheets were added to it.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API pipeline
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// Create an empty pipeline.
+    pipeline();
+
+    /// Destructor.
+    ~pipeline();
+
+    /**
+        Append a stylesheet to the pipeline.
+
+        The stylesheet must remain valid for as long as the pipeline is used.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    pipeline& add(const stylesheet& style);
+
+    /**
+        Append a stylesheet applied with the given parameters to the pipeline.
+
+        The parameters are copied, but the stylesheet must remain valid for as
+        long as the pipeline is used.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    pipeline& add(const stylesheet& style, const param_set& params);
+
+    /**
+        Append a shared stylesheet to the pipeline.
+
+        The pipeline keeps a reference to the stylesheet, so this overload is
+        convenient to use with the stylesheets returned by
+        xslt::stylesheet_cache.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    pipeline& add(std::shared_ptr<const stylesheet> style);
+
+    /**
+        Append a shared stylesheet applied with the given parameters to the
+        pipeline.
+
+        @return Reference to this object, allowing to chain the calls.
+     */
+    pipeline& add(std::shared_ptr<const stylesheet> style, const param_set& params);
+
+    /// Get the number of stylesheets in the pipeline.
+    size_type size() const;
+
+    /// Check if the pipeline doesn't contain any stylesheets.
+    bool empty() const { return size() == 0; }
+
+    /**
+        Apply all stylesheets of the pipeline to the given document.
+
+        Throws xml::exception if the pipeline is empty.
+
+        @param doc The XML document to transform.
+        @param result The result of the last stylesheet.
+        @param on_error Handler called to process errors and warnings.
+
+        @return True if all transformations were successful and the result
+                was placed in @a result.
+        @return False if there was an error, result is not modified.
+     */
+    bool apply(const xml::document& doc,
+               xml::document& result,
+               xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply all stylesheets of the pipeline to the given document and write
+        the result directly to the given stream.
+
+        @see xslt::stylesheet::apply_to_stream()
+     */
+    bool apply_to_stream(const xml::document& doc,
+                         std::ostream& stream,
+                         xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply all stylesheets of the pipeline to the given document and write
+        the result directly to the given file descriptor.
+
+        @see xslt::stylesheet::apply_to_fd()
+     */
+    bool apply_to_fd(const xml::document& doc,
+                     int fd,
+                     xml::error_handler& on_error = xml::throw_on_error) const;
+
+private:
+    std::unique_ptr<impl::pipeline_impl> pimpl_;
+
+    // This class is not copyable
+    pipeline(const pipeline&) = delete;
+    pipeline& operator=(const pipeline&) = delete;
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_pipeline_h_
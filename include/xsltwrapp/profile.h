@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::profile class.
+ */
+
+#ifndef _xsltwrapp_profile_h_
+#define _xsltwrapp_profile_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xmlwrapp/export.h"
+
+// standard includes
+#include <chrono>
+#include <string>
+#include <vector>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+/**
+    Profiling information about a single template of a stylesheet.
+
+    @since 0.11.0
+ */
+struct template_profile
+{
+    /// The template name, empty for the templates without one.
+    std::string name;
+
+    /// The match pattern of the template, empty for named templates.
+    std::string match;
+
+    /// The template mode, empty if it doesn't have any.
+    std::string mode;
+
+    /// The number of times the template was called.
+    unsigned long calls{0};
+
+    /**
+        The time spent in this template, excluding the time spent in the
+        templates called from it.
+
+        Notice that libxslt measures the time with 10 microseconds precision.
+     */
+    std::chrono::microseconds time{0};
+};
+
+/**
+    Profiling information collected while applying a stylesheet.
+
+    Pass an object of this class to xslt::stylesheet::apply() to enable
+    profiling of the transformation. The information about the templates
+    called during the transformation is added to the information already
+    stored in the object, so the same object can be used with many
+    transformations to find the templates taking most time overall.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API profile
+{
+public:
+    /// Type of the container of per-template information.
+    using templates_type = std::vector<template_profile>;
+
+    profile() = default;
+
+    /**
+        Get the information about all the templates called at least once.
+
+        The templates are sorted in order of decreasing time spent in them.
+     */
+    const templates_type& templates() const { return templates_; }
+
+    /// Get the number of transformations this information was collected from.
+    unsigned long transformations() const { return transformations_; }
+
+    /// Get the total time spent in all the templates.
+    std::chrono::microseconds total_time() const;
+
+    /**
+        Add the information from another profile to this one.
+
+        The templates having the same name, match pattern and mode are
+        considered to be the same.
+     */
+    void merge(const profile& other);
+
+    /// Remove all the collected information.
+    void clear();
+
+    /**
+        Add the information about the given template to this profile.
+
+        This function is mostly used by xmlwrapp itself, but can also be used
+        to construct the profile information manually.
+     */
+    void add(const template_profile& templ);
+
+    /// Increment the count of transformations this information is about.
+    void add_transformation() { ++transformations_; }
+
+private:
+    templates_type templates_;
+    unsigned long transformations_{0};
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_profile_h_
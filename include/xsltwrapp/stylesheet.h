@@ -45,8 +45,11 @@
 #include "xmlwrapp/document.h"
 #include "xmlwrapp/export.h"
 #include "xmlwrapp/errors.h"
+#include "xmlwrapp/xpath.h"
 
 // standard includes
+#include <cstddef>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
@@ -56,10 +59,33 @@ XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
 namespace xslt
 {
 
+class document_cache;
+class param_set;
+class profile;
+
 /**
     The xslt::stylesheet class is used to hold information about an XSLT
     stylesheet. You can use it to load in a stylesheet and then use that
     stylesheet to transform an XML document to something else.
+
+    <h3>Thread safety</h3>
+
+    A stylesheet is compiled once, when it is created, and is not modified
+    when it is applied, so the same stylesheet object can be used to
+    transform different documents in several threads concurrently, provided
+    that the const overloads of apply() filling the result document passed to
+    them are used. These overloads keep all the state of the transformation
+    in the transformation context, and the errors are reported to the
+    error handler passed to them, which must not be shared between the
+    threads either. Notice that the input documents must not be shared
+    between the threads neither, as libxslt may modify them, e.g. to strip
+    whitespace. libxml2 must be built with threads support for this to work,
+    as the global libxml2 error handlers, which are temporarily changed
+    during the transformation, are only per-thread in this case.
+
+    The other overloads of apply(), returning a reference to the result
+    document or storing the error message in the stylesheet object, modify
+    it and so can't be used concurrently.
  */
 class XSLTWRAPP_API stylesheet
 {
@@ -84,11 +110,40 @@ public:
     explicit stylesheet(const char *filename,
                         xml::error_handler& on_error = xml::throw_on_error);
 
+    /**
+        Create a new xslt::stylesheet object and parse the stylesheet from
+        the given memory buffer.
+
+        This is useful for the stylesheets embedded in the application, as
+        it avoids creating an intermediate xml::document object.
+
+        Errors are handled by @a on_error handler; by default, xml::exception
+        is thrown on errors. If there's a fatal error that prevents the
+        stylesheet from being loaded and the error handler doesn't throw an
+        exception, the constructor will throw xml::exception anyway.
+
+        @param data The stylesheet contents.
+        @param size The size of the data.
+        @param base_uri The URI used for resolving the relative URIs of the
+                        imported or included stylesheets and of the
+                        documents loaded by document() function, may be
+                        @c nullptr if the stylesheet doesn't use them.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    stylesheet(const char *data,
+               std::size_t size,
+               const char *base_uri,
+               xml::error_handler& on_error = xml::throw_on_error);
+
     /**
         Create a new xslt::stylesheet object from an xml::document object
-        that contains the parsed stylesheet. The given xml::document is
-        passed by value. This is needed because the stylesheet will own the
-        document and free it.
+        that contains the parsed stylesheet.
+
+        The stylesheet needs to own the document and free it, so the given
+        document is copied. Use the overload taking an rvalue reference to
+        avoid making the copy if the document is not needed any longer.
 
         Errors are handled by @a on_error handler; by default, xml::exception
         is thrown on errors. If there's a fatal error that prevents the
@@ -98,7 +153,24 @@ public:
         @param doc The parsed stylesheet.
         @param on_error Handler called to process errors and warnings (since 0.7.0).
      */
-    explicit stylesheet(xml::document doc,
+    explicit stylesheet(const xml::document& doc,
+                        xml::error_handler& on_error = xml::throw_on_error);
+
+    /**
+        Create a new xslt::stylesheet object taking ownership of the given
+        xml::document object containing the parsed stylesheet.
+
+        Unlike the overload taking a const reference, this one doesn't copy
+        the document. If the stylesheet is created successfully, @a doc is
+        left empty and must not be used any longer, except for destroying
+        it or assigning to it.
+
+        @param doc The parsed stylesheet.
+        @param on_error Handler called to process errors and warnings.
+
+        @since 0.11.0
+     */
+    explicit stylesheet(xml::document&& doc,
                         xml::error_handler& on_error = xml::throw_on_error);
 
     /**
@@ -106,6 +178,42 @@ public:
      */
     ~stylesheet();
 
+    /**
+        Register an extension function which can be called from this
+        stylesheet XPath expressions.
+
+        The function must be in a namespace and the stylesheet must declare
+        a prefix for it to be able to call the function.
+
+        Extension functions must be registered before the stylesheet is used
+        by several threads. As the same function is used by all
+        transformations using this stylesheet, it must be safe to call it
+        concurrently if the stylesheet is applied concurrently.
+
+        @param name    The local name of the function.
+        @param ns_uri  The namespace URI of the function.
+        @param func    The function to call.
+
+        @since 0.11.0
+     */
+    void register_function(const std::string& name,
+                           const std::string& ns_uri,
+                           xml::xpath_function func);
+
+    /**
+        Use the given cache for the documents loaded by document() function
+        during the transformations using this stylesheet.
+
+        Just as register_function(), this function must be called before the
+        stylesheet is used by several threads. The cache itself may be shared
+        by several stylesheets and used concurrently.
+
+        @param cache The cache to use or empty pointer to stop using it.
+
+        @since 0.11.0
+     */
+    void set_document_cache(std::shared_ptr<document_cache> cache);
+
     /**
         Apply this stylesheet to the given XML document. The result document
         is placed in the second document parameter.
@@ -141,6 +249,9 @@ public:
         Apply this stylesheet to the given XML document. The result document
         is placed in the second document parameter.
 
+        This function is thread-safe, see the class description, and is
+        const since 0.11.0.
+
         @param doc The XML document to transform.
         @param result The result tree after applying this stylesheet.
         @param on_error Handler called to process errors and warnings (since 0.7.0).
@@ -150,12 +261,15 @@ public:
      */
     bool apply(const xml::document& doc,
                xml::document& result,
-               xml::error_handler& on_error);
+               xml::error_handler& on_error) const;
 
     /**
         Apply this stylesheet to the given XML document. The result document
         is placed in the second document parameter.
 
+        This function is thread-safe, see the class description, and is
+        const since 0.11.0.
+
         @param doc The XML document to transform.
         @param result The result tree after applying this stylesheet.
         @param with_params Override xsl:param elements using the given key/value map
@@ -167,7 +281,70 @@ public:
     bool apply(const xml::document& doc,
                xml::document& result,
                const param_type& with_params,
-               xml::error_handler& on_error);
+               xml::error_handler& on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document. The result document is placed in the second document
+        parameter.
+
+        This function is thread-safe, see the class description.
+
+        @param doc The XML document to transform.
+        @param result The result tree after applying this stylesheet.
+        @param with_params Override xsl:param elements using the given parameters.
+        @param on_error Handler called to process errors and warnings.
+
+        @return True if the transformation was successful and the results placed in result.
+        @return False if there was an error, result is not modified.
+
+        @since 0.11.0
+     */
+    bool apply(const xml::document& doc,
+               xml::document& result,
+               const param_set& with_params,
+               xml::error_handler& on_error) const;
+
+    /**
+        Apply this stylesheet to the given XML document while collecting
+        profiling information about it.
+
+        This is the same as the overload without @a prof parameter, but also
+        records the number of calls and time spent in each of the templates
+        of the stylesheet and adds this information to @a prof.
+
+        Profiling information is stored in the stylesheet itself by libxslt,
+        so while this function can still be used from multiple threads, the
+        profiled transformations using the same stylesheet are serialized.
+
+        @param doc The XML document to transform.
+        @param result The result tree after applying this stylesheet.
+        @param prof The object to add profiling information to.
+        @param on_error Handler called to process errors and warnings.
+
+        @return True if the transformation was successful and the results placed in result.
+        @return False if there was an error, result is not modified.
+
+        @since 0.11.0
+     */
+    bool apply(const xml::document& doc,
+               xml::document& result,
+               profile& prof,
+               xml::error_handler& on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document while collecting profiling information about it.
+
+        @see apply(const xml::document&, xml::document&, profile&, xml::error_handler&) const
+
+        @since 0.11.0
+     */
+    bool apply(const xml::document& doc,
+               xml::document& result,
+               const param_type& with_params,
+               profile& prof,
+               xml::error_handler& on_error) const;
 
     /**
         Apply this stylesheet to the given XML document. The results document
@@ -176,7 +353,8 @@ public:
 
         Each time you call this member function, the xml::document object
         that was returned from the last call becomes invalid. That is, of
-        course, unless you copied it first.
+        course, unless you copied it first. For the same reason, this function
+        is not thread-safe.
 
         @param doc The XML document to transform.
         @param on_error Handler called to process errors and warnings (since 0.7.0).
@@ -193,7 +371,8 @@ public:
 
         Each time you call this member function, the xml::document object
         that was returned from the last call becomes invalid. That is, of
-        course, unless you copied it first.
+        course, unless you copied it first. For the same reason, this function
+        is not thread-safe.
 
         @param doc The XML document to transform.
         @param with_params Override xsl:param elements using the given key/value map
@@ -205,6 +384,94 @@ public:
                          const param_type& with_params,
                          xml::error_handler& on_error = xml::throw_on_error);
 
+    /**
+        Apply this stylesheet to the given XML document and write the result
+        directly to the given stream.
+
+        The result is serialized using the output method and encoding
+        specified by the stylesheet, as when saving the result document
+        returned by apply(), but without creating an intermediate string
+        containing all of it. The result tree is freed as soon as it has been
+        written.
+
+        This function is thread-safe in the same sense as the const overloads
+        of apply().
+
+        @param doc The XML document to transform.
+        @param stream The stream to write the result to.
+        @param on_error Handler called to process errors and warnings.
+
+        @return True if the transformation was successful and the result
+                was written to the stream.
+        @return False if there was an error and the error handler didn't
+                throw. Some output may have been already written in this
+                case if the error happened while writing it.
+
+        @since 0.11.0
+     */
+    bool apply_to_stream(const xml::document& doc,
+                         std::ostream& stream,
+                         xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document and write the result directly to the given stream.
+
+        This is the same as the overload without @a with_params parameter.
+
+        @since 0.11.0
+     */
+    bool apply_to_stream(const xml::document& doc,
+                         std::ostream& stream,
+                         const param_type& with_params,
+                         xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document and write the result directly to the given stream.
+
+        @since 0.11.0
+     */
+    bool apply_to_stream(const xml::document& doc,
+                         std::ostream& stream,
+                         const param_set& with_params,
+                         xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply this stylesheet to the given XML document and write the result
+        directly to the given file descriptor.
+
+        This is the same as apply_to_stream() but writes to a file descriptor,
+        which is not closed by this function.
+
+        @since 0.11.0
+     */
+    bool apply_to_fd(const xml::document& doc,
+                     int fd,
+                     xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document and write the result directly to the given file descriptor.
+
+        @since 0.11.0
+     */
+    bool apply_to_fd(const xml::document& doc,
+                     int fd,
+                     const param_type& with_params,
+                     xml::error_handler& on_error = xml::throw_on_error) const;
+
+    /**
+        Apply this stylesheet with the given parameters to the given XML
+        document and write the result directly to the given file descriptor.
+
+        @since 0.11.0
+     */
+    bool apply_to_fd(const xml::document& doc,
+                     int fd,
+                     const param_set& with_params,
+                     xml::error_handler& on_error = xml::throw_on_error) const;
+
     /**
         If you used one of the xslt::stylesheet::apply member functions that
         return a bool, you can use this function to get the text message for
@@ -223,10 +490,12 @@ public:
     const std::string& get_error_message() const;
 
 private:
-    void init(xml::document& doc, xml::error_handler& on_error);
+    void init(xml::document& doc, xml::error_handler& on_error, const char *base_uri = nullptr);
 
     std::unique_ptr<pimpl> pimpl_;
 
+    friend class pipeline;
+
     // an xslt::stylesheet cannot yet be copied or assigned to.
     stylesheet(const stylesheet&) = delete;
     stylesheet& operator=(const stylesheet&) = delete;
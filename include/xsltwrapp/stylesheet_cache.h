@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the definition of the xslt::stylesheet_cache class.
+ */
+
+#ifndef _xsltwrapp_stylesheet_cache_h_
+#define _xsltwrapp_stylesheet_cache_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/init.h"
+#include "xsltwrapp/stylesheet.h"
+#include "xmlwrapp/export.h"
+#include "xmlwrapp/errors.h"
+
+// standard includes
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+XMLWRAPP_MSVC_SUPPRESS_DLL_MEMBER_WARN
+
+namespace xslt
+{
+
+namespace impl
+{
+struct stylesheet_cache_impl;
+}
+
+/**
+    Cache of compiled stylesheets.
+
+    Compiling a stylesheet is expensive, so applications using the same
+    stylesheets repeatedly should compile them only once. This class hands
+    out shared, immutable xslt::stylesheet objects loaded from the given
+    files and compiles them again only when the stylesheet file or any of the
+    files it imports or includes is modified, as determined by comparing
+    their modification time and size.
+
+    The stylesheets imported or included by the cached stylesheets are cached
+    too, so that compiling a stylesheet again after it was modified doesn't
+    require reading the unchanged stylesheets it imports from disk.
+
+    When the cache contains more than the maximal number of stylesheets, the
+    least recently used ones are evicted from it. Notice that the evicted
+    stylesheets are only destroyed when they are not used any more, i.e.
+    when the last pointer to them obtained from get() is destroyed.
+
+    The cache can be used from several threads concurrently. The stylesheets
+    returned by it can be applied concurrently too, as explained in
+    xslt::stylesheet documentation.
+
+    @since 0.11.0
+ */
+class XSLTWRAPP_API stylesheet_cache
+{
+public:
+    /// size type
+    using size_type = std::size_t;
+
+    /// Statistics about the cache usage, see get_statistics().
+    struct statistics
+    {
+        /// Number of get() calls which returned a cached stylesheet.
+        size_type hits{0};
+
+        /// Number of get() calls which had to compile the stylesheet.
+        size_type misses{0};
+
+        /// Number of stylesheets evicted from the cache because it was full.
+        size_type evictions{0};
+
+        /// Number of imported or included stylesheets which were reused.
+        size_type import_hits{0};
+
+        /// Number of imported or included stylesheets read from disk.
+        size_type import_misses{0};
+
+        /// Total time spent compiling the stylesheets.
+        std::chrono::microseconds compile_time{0};
+    };
+
+    /**
+        Create a new empty cache.
+
+        @param max_size The maximal number of stylesheets kept in the cache,
+                        must be positive.
+     */
+    explicit stylesheet_cache(size_type max_size = 64);
+
+    /// Destructor.
+    ~stylesheet_cache();
+
+    /**
+        Get the compiled stylesheet loaded from the given file.
+
+        The stylesheet is compiled if it isn't in the cache yet or if it, or
+        any of the stylesheets it imports or includes, was modified since it
+        was compiled.
+
+        Errors are handled by @a on_error handler; by default, xml::exception
+        is thrown on errors. If the stylesheet can't be compiled, an exception
+        is thrown as with xslt::stylesheet constructor and nothing is added to
+        the cache.
+
+        @param filename The name of the file that contains the stylesheet.
+        @param on_error Handler called to process errors and warnings.
+        @return Shared pointer to the compiled stylesheet, never null.
+     */
+    std::shared_ptr<const stylesheet>
+    get(const char *filename, xml::error_handler& on_error = xml::throw_on_error);
+
+    /**
+        Remove the stylesheet loaded from the given file from the cache.
+
+        @return true if the stylesheet was in the cache.
+     */
+    bool remove(const char *filename);
+
+    /// Remove all stylesheets from the cache.
+    void clear();
+
+    /// Get the number of the stylesheets currently in the cache.
+    size_type size() const;
+
+    /// Get the maximal number of stylesheets kept in the cache.
+    size_type get_max_size() const;
+
+    /**
+        Change the maximal number of stylesheets kept in the cache.
+
+        If the cache currently contains more stylesheets than @a max_size, the
+        least recently used ones are evicted from it immediately.
+     */
+    void set_max_size(size_type max_size);
+
+    /// Get the statistics of the cache usage since its creation.
+    statistics get_statistics() const;
+
+    /**
+        Set the document cache used by the stylesheets compiled by this
+        cache.
+
+        The document cache is only used by the stylesheets compiled after
+        calling this function, see xslt::stylesheet::set_document_cache().
+     */
+    void set_document_cache(std::shared_ptr<document_cache> cache);
+
+private:
+    std::unique_ptr<impl::stylesheet_cache_impl> pimpl_;
+
+    // This class is not copyable
+    stylesheet_cache(const stylesheet_cache&) = delete;
+    stylesheet_cache& operator=(const stylesheet_cache&) = delete;
+};
+
+} // namespace xslt
+
+XMLWRAPP_MSVC_RESTORE_DLL_MEMBER_WARN
+
+#endif // _xsltwrapp_stylesheet_cache_h_
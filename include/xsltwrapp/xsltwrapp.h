@@ -34,7 +34,13 @@
 #define _xsltwrapp_xsltwrapp_h_
 
 #include "xmlwrapp/xmlwrapp.h"
+#include "xsltwrapp/batch_transform.h"
+#include "xsltwrapp/document_cache.h"
 #include "xsltwrapp/init.h"
+#include "xsltwrapp/param_set.h"
+#include "xsltwrapp/pipeline.h"
+#include "xsltwrapp/profile.h"
 #include "xsltwrapp/stylesheet.h"
+#include "xsltwrapp/stylesheet_cache.h"
 
 #endif // _xsltwrapp_xsltwrapp_h_
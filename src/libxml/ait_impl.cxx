@@ -32,6 +32,7 @@
 
 // xmlwrapp includes
 #include "ait_impl.h"
+#include "qname_impl.h"
 #include "utility.h"
 #include "xmlwrapp/attributes.h"
 #include "xmlwrapp/errors.h"
@@ -379,15 +380,16 @@ namespace impl
 
 xmlAttrPtr find_prop(xmlNodePtr xmlnode, const char *name)
 {
-    xmlAttrPtr prop = xmlnode->properties;
+    return name_matcher(xmlnode->doc, reinterpret_cast<const xmlChar*>(name)).find_attr(xmlnode);
+}
 
-    for (; prop; prop = prop->next )
-    {
-        if (xmlStrEqual(prop->name, reinterpret_cast<const xmlChar*>(name)))
-            return prop;
-    }
 
-    return nullptr;
+xmlAttrPtr find_prop(xmlNodePtr xmlnode, const char *name, const char *ns_uri)
+{
+    return name_matcher(xmlnode->doc,
+                        reinterpret_cast<const xmlChar*>(name),
+                        name_matcher::mode_for(ns_uri),
+                        reinterpret_cast<const xmlChar*>(ns_uri)).find_attr(xmlnode);
 }
 
 
@@ -414,6 +416,26 @@ xmlAttributePtr find_default_prop(xmlNodePtr xmlnode, const char *name)
     return nullptr;
 }
 
+xmlAttributePtr find_default_prop(xmlNodePtr xmlnode, const char *name, const char *ns_uri)
+{
+    if (!ns_uri || !*ns_uri)
+        return find_default_prop(xmlnode, name);
+
+    // For namespaced attributes, let libxml2 check the prefixes of the
+    // attributes declared in the DTD.
+    xmlAttrPtr prop = xmlHasNsProp(xmlnode,
+                                   reinterpret_cast<const xmlChar*>(name),
+                                   reinterpret_cast<const xmlChar*>(ns_uri));
+    if (prop != nullptr && prop->type == XML_ATTRIBUTE_DECL)
+    {
+        auto dtd_attr = reinterpret_cast<xmlAttributePtr>(prop);
+        if (dtd_attr->defaultValue != nullptr)
+            return dtd_attr;
+    }
+
+    return nullptr;
+}
+
 bool operator==(const ait_impl& lhs, const ait_impl& rhs)
 {
     if (lhs.fake_ || rhs.fake_)
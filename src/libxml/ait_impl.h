@@ -73,7 +73,9 @@ private:
 
 // a couple helper functions
 xmlAttrPtr find_prop(xmlNodePtr xmlnode, const char *name);
+xmlAttrPtr find_prop(xmlNodePtr xmlnode, const char *name, const char *ns_uri);
 xmlAttributePtr find_default_prop(xmlNodePtr xmlnode, const char *name);
+xmlAttributePtr find_default_prop(xmlNodePtr xmlnode, const char *name, const char *ns_uri);
 
 } // namespace impl
 
@@ -0,0 +1,568 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xml::allocator class and
+    the allocators provided by xmlwrapp.
+ */
+
+// xmlwrapp includes
+#include "xmlwrapp/allocator.h"
+
+// standard includes
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace xml
+{
+
+namespace
+{
+
+// Header preceding every block allocated by our allocators, its size
+// preserves the alignment of the block following it.
+struct alignas(alignof(std::max_align_t)) block_header
+{
+    std::size_t value;
+};
+
+inline block_header* get_header(void *ptr)
+{
+    return static_cast<block_header*>(ptr) - 1;
+}
+
+inline void* get_block(block_header *header)
+{
+    return header + 1;
+}
+
+inline bool is_too_big(std::size_t size)
+{
+    return size > std::numeric_limits<std::size_t>::max() - sizeof(block_header);
+}
+
+} // anonymous namespace
+
+
+allocator::~allocator() = default;
+
+
+// ------------------------------------------------------------------------
+// xml::counting_allocator
+// ------------------------------------------------------------------------
+
+namespace impl
+{
+
+struct counting_allocator_impl
+{
+    explicit counting_allocator_impl(allocator *underlying)
+        : underlying_(underlying)
+    {
+    }
+
+    void* raw_allocate(std::size_t size)
+    {
+        return underlying_ ? underlying_->allocate(size) : std::malloc(size);
+    }
+
+    void* raw_reallocate(void *ptr, std::size_t size)
+    {
+        return underlying_ ? underlying_->reallocate(ptr, size) : std::realloc(ptr, size);
+    }
+
+    void raw_deallocate(void *ptr)
+    {
+        if ( underlying_ )
+            underlying_->deallocate(ptr);
+        else
+            std::free(ptr);
+    }
+
+    void add_bytes(std::size_t size)
+    {
+        total_bytes_ += size;
+
+        const std::size_t in_use = bytes_in_use_ += size;
+        std::size_t peak = peak_bytes_in_use_;
+        while ( in_use > peak && !peak_bytes_in_use_.compare_exchange_weak(peak, in_use) )
+            ;
+    }
+
+    void remove_bytes(std::size_t size)
+    {
+        bytes_in_use_ -= size;
+    }
+
+    allocator * const underlying_;
+
+    std::atomic<std::size_t> allocations_{0};
+    std::atomic<std::size_t> deallocations_{0};
+    std::atomic<std::size_t> bytes_in_use_{0};
+    std::atomic<std::size_t> peak_bytes_in_use_{0};
+    std::atomic<unsigned long long> total_bytes_{0};
+};
+
+} // namespace impl
+
+
+counting_allocator::counting_allocator(allocator *underlying)
+    : pimpl_(new impl::counting_allocator_impl(underlying))
+{
+}
+
+
+counting_allocator::~counting_allocator() = default;
+
+
+void* counting_allocator::allocate(size_type size)
+{
+    if ( is_too_big(size) )
+        return nullptr;
+
+    auto header = static_cast<block_header*>(pimpl_->raw_allocate(sizeof(block_header) + size));
+    if ( !header )
+        return nullptr;
+
+    header->value = size;
+
+    pimpl_->allocations_++;
+    pimpl_->add_bytes(size);
+
+    return get_block(header);
+}
+
+
+void* counting_allocator::reallocate(void *ptr, size_type size)
+{
+    if ( !ptr )
+        return allocate(size);
+
+    if ( is_too_big(size) )
+        return nullptr;
+
+    block_header *header = get_header(ptr);
+    const size_type old_size = header->value;
+
+    header = static_cast<block_header*>(pimpl_->raw_reallocate(header, sizeof(block_header) + size));
+    if ( !header )
+        return nullptr;
+
+    header->value = size;
+
+    if ( size > old_size )
+        pimpl_->add_bytes(size - old_size);
+    else
+        pimpl_->remove_bytes(old_size - size);
+
+    return get_block(header);
+}
+
+
+void counting_allocator::deallocate(void *ptr)
+{
+    if ( !ptr )
+        return;
+
+    block_header *header = get_header(ptr);
+
+    pimpl_->deallocations_++;
+    pimpl_->remove_bytes(header->value);
+
+    pimpl_->raw_deallocate(header);
+}
+
+
+counting_allocator::statistics counting_allocator::get_statistics() const
+{
+    statistics stats;
+    stats.allocations = pimpl_->allocations_;
+    stats.deallocations = pimpl_->deallocations_;
+    stats.bytes_in_use = pimpl_->bytes_in_use_;
+    stats.peak_bytes_in_use = pimpl_->peak_bytes_in_use_;
+    stats.total_bytes = pimpl_->total_bytes_;
+    return stats;
+}
+
+
+// ------------------------------------------------------------------------
+// xml::pool_allocator
+// ------------------------------------------------------------------------
+
+namespace
+{
+
+// Blocks of up to max_pooled_size bytes are rounded up to a multiple of
+// this value and each size gets its own pool.
+const std::size_t pool_granularity = 16;
+const std::size_t num_pools = pool_allocator::max_pooled_size / pool_granularity;
+
+// Value stored in the header of the blocks not allocated from the pools.
+const std::size_t not_pooled = num_pools;
+
+// Size of the chunks of memory the blocks are carved from.
+const std::size_t chunk_size = 64*1024;
+
+// The maximal number of free blocks of each size kept by every thread and
+// the number of blocks moved between the thread and the shared pool at once.
+const std::size_t max_cached_blocks = 64;
+const std::size_t blocks_batch = 32;
+
+// Free blocks are linked together using the space of their headers.
+struct free_block
+{
+    free_block *next;
+};
+
+static_assert(sizeof(free_block) <= sizeof(block_header),
+              "free block must fit into the block header");
+
+struct free_list
+{
+    void push(free_block *block)
+    {
+        block->next = head;
+        head = block;
+        count++;
+    }
+
+    free_block* pop()
+    {
+        free_block * const block = head;
+        head = block->next;
+        count--;
+        return block;
+    }
+
+    // Move up to max_count blocks to the other list.
+    void move_to(free_list& other, std::size_t max_count)
+    {
+        while ( head && max_count-- )
+            other.push(pop());
+    }
+
+    free_block *head{nullptr};
+    std::size_t count{0};
+};
+
+inline std::size_t get_pool_index(std::size_t size)
+{
+    return size ? (size - 1) / pool_granularity : 0;
+}
+
+inline std::size_t get_pooled_size(std::size_t index)
+{
+    return (index + 1) * pool_granularity;
+}
+
+// All the existing pool allocators, indexed by their unique IDs: this is used
+// by the thread caches to avoid returning their blocks to the allocators
+// which don't exist any more. It is never freed, as the thread caches may be
+// destroyed after the end of static destruction.
+struct pool_registry
+{
+    std::mutex mutex;
+    std::unordered_map<std::uint64_t, impl::pool_allocator_impl*> pools;
+    std::uint64_t last_id{0};
+};
+
+pool_registry& get_pool_registry()
+{
+    static pool_registry* const registry = new pool_registry;
+    return *registry;
+}
+
+// Free blocks cached by the current thread: they all belong to the pool
+// allocator with the given ID, as the cache is emptied before using it with
+// a different one.
+struct thread_cache
+{
+    ~thread_cache()
+    {
+        release();
+    }
+
+    // Return all blocks to their allocator, if it still exists.
+    void release();
+
+    std::uint64_t pool_id{0};
+    free_list lists[num_pools];
+};
+
+thread_local thread_cache t_cache;
+
+} // anonymous namespace
+
+
+namespace impl
+{
+
+struct pool_allocator_impl
+{
+    pool_allocator_impl()
+    {
+        pool_registry& registry = get_pool_registry();
+
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        id_ = ++registry.last_id;
+        registry.pools[id_] = this;
+    }
+
+    ~pool_allocator_impl()
+    {
+        {
+            pool_registry& registry = get_pool_registry();
+
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.pools.erase(id_);
+        }
+
+        // The caches of the other threads are discarded when they're used
+        // with another allocator, but this one can be done immediately.
+        if ( t_cache.pool_id == id_ )
+            t_cache = thread_cache();
+
+        for ( void *chunk : chunks_ )
+            std::free(chunk);
+    }
+
+    thread_cache& get_cache()
+    {
+        thread_cache& cache = t_cache;
+        if ( cache.pool_id != id_ )
+        {
+            cache.release();
+            cache.pool_id = id_;
+        }
+
+        return cache;
+    }
+
+    // Fill the given (empty) thread list with the blocks of the given pool,
+    // return false if there is not enough memory.
+    bool refill(free_list& list, std::size_t index);
+
+    // Return the blocks from the thread list to the given pool.
+    void give_back(free_list& list, std::size_t index, std::size_t count);
+
+    std::uint64_t id_;
+
+    // Protects all the fields below.
+    mutable std::mutex mutex_;
+
+    free_list pools_[num_pools];
+    std::vector<void*> chunks_;
+};
+
+
+bool pool_allocator_impl::refill(free_list& list, std::size_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    free_list& pool = pools_[index];
+    if ( !pool.head )
+    {
+        void * const chunk = std::malloc(chunk_size);
+        if ( !chunk )
+            return false;
+
+        try
+        {
+            chunks_.push_back(chunk);
+        }
+        catch ( ... )
+        {
+            std::free(chunk);
+            return false;
+        }
+
+        const std::size_t stride = sizeof(block_header) + get_pooled_size(index);
+        auto p = static_cast<char*>(chunk);
+        for ( std::size_t n = chunk_size / stride; n; --n, p += stride )
+            pool.push(reinterpret_cast<free_block*>(p));
+    }
+
+    pool.move_to(list, blocks_batch);
+
+    return true;
+}
+
+
+void pool_allocator_impl::give_back(free_list& list, std::size_t index, std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    list.move_to(pools_[index], count);
+}
+
+} // namespace impl
+
+
+namespace
+{
+
+void thread_cache::release()
+{
+    if ( !pool_id )
+        return;
+
+    pool_registry& registry = get_pool_registry();
+
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        // If the allocator doesn't exist any more, its memory was already
+        // freed, so the blocks must be just forgotten.
+        auto i = registry.pools.find(pool_id);
+        if ( i != registry.pools.end() )
+        {
+            for ( std::size_t index = 0; index < num_pools; ++index )
+            {
+                if ( lists[index].head )
+                    i->second->give_back(lists[index], index, lists[index].count);
+            }
+        }
+    }
+
+    *this = thread_cache();
+}
+
+} // anonymous namespace
+
+
+pool_allocator::pool_allocator()
+    : pimpl_(new impl::pool_allocator_impl)
+{
+}
+
+
+pool_allocator::~pool_allocator() = default;
+
+
+void* pool_allocator::allocate(size_type size)
+{
+    block_header *header;
+    if ( size > max_pooled_size )
+    {
+        if ( is_too_big(size) )
+            return nullptr;
+
+        header = static_cast<block_header*>(std::malloc(sizeof(block_header) + size));
+        if ( !header )
+            return nullptr;
+
+        header->value = not_pooled;
+    }
+    else
+    {
+        const std::size_t index = get_pool_index(size);
+
+        free_list& list = pimpl_->get_cache().lists[index];
+        if ( !list.head && !pimpl_->refill(list, index) )
+            return nullptr;
+
+        header = reinterpret_cast<block_header*>(list.pop());
+        header->value = index;
+    }
+
+    return get_block(header);
+}
+
+
+void* pool_allocator::reallocate(void *ptr, size_type size)
+{
+    if ( !ptr )
+        return allocate(size);
+
+    block_header *header = get_header(ptr);
+    if ( header->value == not_pooled )
+    {
+        if ( is_too_big(size) )
+            return nullptr;
+
+        header = static_cast<block_header*>(std::realloc(header, sizeof(block_header) + size));
+        return header ? get_block(header) : nullptr;
+    }
+
+    // The block is big enough already.
+    const size_type old_size = get_pooled_size(header->value);
+    if ( size <= old_size )
+        return ptr;
+
+    void * const new_ptr = allocate(size);
+    if ( !new_ptr )
+        return nullptr;
+
+    std::memcpy(new_ptr, ptr, old_size);
+    deallocate(ptr);
+
+    return new_ptr;
+}
+
+
+void pool_allocator::deallocate(void *ptr)
+{
+    if ( !ptr )
+        return;
+
+    block_header * const header = get_header(ptr);
+    const std::size_t index = header->value;
+    if ( index == not_pooled )
+    {
+        std::free(header);
+        return;
+    }
+
+    free_list& list = pimpl_->get_cache().lists[index];
+    list.push(reinterpret_cast<free_block*>(header));
+
+    // Don't let a single thread keep too many free blocks.
+    if ( list.count > max_cached_blocks )
+        pimpl_->give_back(list, index, blocks_batch);
+}
+
+
+pool_allocator::size_type pool_allocator::get_pool_memory() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->chunks_.size() * chunk_size;
+}
+
+} // namespace xml
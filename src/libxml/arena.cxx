@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// xmlwrapp includes
+#include "xmlwrapp/init.h"
+#include "xmlwrapp/allocator.h"
+#include "xmlwrapp/errors.h"
+
+#include "arena.h"
+#include "doc_listener.h"
+
+// libxml includes
+#include <libxml/catalog.h>
+#include <libxml/valid.h>
+#include <libxml/xmlerror.h>
+
+// standard includes
+#include <cstring>
+
+namespace xml
+{
+
+namespace impl
+{
+
+namespace
+{
+
+const std::size_t header_size = sizeof(memory_block_header);
+
+// The size of the first chunk of the arena and the maximal size of all the
+// subsequent ones, which are twice bigger than the previous one.
+const std::size_t min_chunk_size = 8*1024;
+const std::size_t max_chunk_size = 1024*1024;
+
+std::size_t round_up(std::size_t size)
+{
+    const std::size_t align = alignof(std::max_align_t);
+    return (size + align - 1) & ~(align - 1);
+}
+
+} // anonymous namespace
+
+
+struct document_arena::chunk
+{
+    chunk *next;
+};
+
+
+thread_local document_arena *document_arena::current_ = nullptr;
+
+
+document_arena::document_arena()
+    : next_chunk_size_(min_chunk_size)
+{
+    if ( !init::get_allocator() )
+        throw exception("using arena documents requires setting the allocator first");
+
+#ifdef LIBXML_CATALOG_ENABLED
+    // The catalogs are global and initialized on first use, which must not
+    // happen while the arena is active, as they would be allocated from it.
+    xmlInitializeCatalog();
+#endif
+}
+
+
+document_arena::~document_arena()
+{
+    allocator * const alloc = init::get_allocator();
+
+    while ( chunks_ )
+    {
+        chunk * const next = chunks_->next;
+        alloc->deallocate(chunks_);
+        chunks_ = next;
+    }
+}
+
+
+char *document_arena::add_chunk(std::size_t size)
+{
+    // Make sure the chunk header doesn't break the blocks alignment.
+    const std::size_t chunk_header_size = round_up(sizeof(chunk));
+
+    auto c = static_cast<chunk*>(init::get_allocator()->allocate(chunk_header_size + size));
+    if ( !c )
+        return nullptr;
+
+    c->next = chunks_;
+    chunks_ = c;
+
+    return reinterpret_cast<char*>(c) + chunk_header_size;
+}
+
+
+void *document_arena::allocate(std::size_t size)
+{
+    const std::size_t block_size = header_size + round_up(size);
+    if ( block_size < size )
+        return nullptr;
+
+    char *block;
+    if ( static_cast<std::size_t>(end_ - pos_) >= block_size )
+    {
+        block = pos_;
+        pos_ += block_size;
+        last_block_ = block;
+    }
+    else if ( block_size > next_chunk_size_ / 4 )
+    {
+        // Use a dedicated chunk for big blocks, to avoid wasting the space
+        // remaining in the current one.
+        block = add_chunk(block_size);
+        if ( !block )
+            return nullptr;
+    }
+    else
+    {
+        block = add_chunk(next_chunk_size_);
+        if ( !block )
+            return nullptr;
+
+        end_ = block + next_chunk_size_;
+        pos_ = block + block_size;
+        last_block_ = block;
+
+        if ( next_chunk_size_ < max_chunk_size )
+            next_chunk_size_ *= 2;
+    }
+
+    auto header = reinterpret_cast<memory_block_header*>(block);
+    header->arena = this;
+    header->size = size;
+
+    return header + 1;
+}
+
+
+void *document_arena::reallocate(void *ptr, std::size_t size)
+{
+    memory_block_header * const header = memory_block_header::of(ptr);
+    if ( size <= header->size )
+        return ptr;
+
+    // The last allocated block can often be grown in place.
+    char * const block = reinterpret_cast<char*>(header);
+    if ( block == last_block_ )
+    {
+        const std::size_t block_size = header_size + round_up(size);
+        if ( block_size > size && static_cast<std::size_t>(end_ - block) >= block_size )
+        {
+            header->size = size;
+            pos_ = block + block_size;
+            return ptr;
+        }
+    }
+
+    void * const new_ptr = allocate(size);
+    if ( new_ptr )
+        std::memcpy(new_ptr, ptr, header->size);
+
+    return new_ptr;
+}
+
+
+arena_scope::~arena_scope()
+{
+    document_arena::current_ = previous_;
+
+    if ( !arena_ )
+        return;
+
+    // The last error is kept in the thread state and would outlive the
+    // arena, so forget about it if it was allocated from it: we don't use it
+    // anyhow, as the errors are always reported using callbacks.
+    xmlErrorPtr const error = xmlGetLastError();
+    if ( error &&
+            (arena_->owns(error->message) ||
+             arena_->owns(error->file) ||
+             arena_->owns(error->str1) ||
+             arena_->owns(error->str2) ||
+             arena_->owns(error->str3)) )
+    {
+        xmlResetLastError();
+    }
+}
+
+
+document_arena *get_document_arena(xmlDocPtr doc)
+{
+    doc_extra * const extra = doc_extra::get(doc);
+    return extra ? extra->arena_.get() : nullptr;
+}
+
+
+void attach_document_arena(xmlDocPtr doc, std::unique_ptr<document_arena> arena)
+{
+    doc_extra::get_or_create(doc).arena_ = std::move(arena);
+}
+
+
+void free_document(xmlDocPtr doc)
+{
+    doc_extra * const extra = doc_extra::get(doc);
+    std::unique_ptr<document_arena> arena;
+    if ( extra )
+        arena = std::move(extra->arena_);
+
+    doc_extra::destroy(doc);
+
+    if ( !arena )
+    {
+        xmlFreeDoc(doc);
+        return;
+    }
+
+    // All the nodes of the document come from the arena and are released
+    // together with it, but the DTDs and the tables of IDs and references may
+    // have been created outside of it, e.g. by document::validate(), and
+    // must be freed separately. Notice that this doesn't depend on the size
+    // of the document.
+    if ( doc->ids && !arena->owns(doc->ids) )
+        xmlFreeIDTable(static_cast<xmlIDTablePtr>(doc->ids));
+    if ( doc->refs && !arena->owns(doc->refs) )
+        xmlFreeRefTable(static_cast<xmlRefTablePtr>(doc->refs));
+
+    if ( doc->extSubset && doc->extSubset != doc->intSubset && !arena->owns(doc->extSubset) )
+        xmlFreeDtd(doc->extSubset);
+    if ( doc->intSubset && !arena->owns(doc->intSubset) )
+        xmlFreeDtd(doc->intSubset);
+
+    if ( doc->dict )
+        xmlDictFree(doc->dict);
+}
+
+} // namespace impl
+
+} // namespace xml
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the arena used for the documents created in
+    xml::document::arena_allocation mode.
+ */
+
+#ifndef _xmlwrapp_arena_h_
+#define _xmlwrapp_arena_h_
+
+// standard includes
+#include <cstddef>
+#include <memory>
+
+// libxml includes
+#include <libxml/tree.h>
+
+namespace xml
+{
+
+namespace impl
+{
+
+class document_arena;
+
+// Header preceding every block allocated by libxml2 when a custom allocator
+// is used, see xml::init::set_allocator(): it allows to recognize the blocks
+// allocated from an arena, which must not be freed individually.
+struct alignas(alignof(std::max_align_t)) memory_block_header
+{
+    // The arena owning this block or null if it was allocated directly from
+    // the allocator.
+    document_arena *arena;
+
+    // Size of the block, only used for the blocks allocated from an arena.
+    std::size_t size;
+
+    static memory_block_header *of(const void *ptr)
+    {
+        return reinterpret_cast<memory_block_header*>(
+                    const_cast<char*>(static_cast<const char*>(ptr))) - 1;
+    }
+};
+
+/*
+    Monotonic buffer used for allocating all nodes of a document.
+
+    The memory is taken from the allocator installed by set_allocator() in big
+    chunks, the blocks allocated from them are never freed individually (and
+    so freeing them is a no-op) and all the chunks are released at once when
+    the arena is destroyed.
+
+    All allocations done by libxml2 in the current thread come from the arena
+    while it is activated using arena_scope. Like the document itself, the
+    arena must not be used from several threads at the same time.
+ */
+class document_arena
+{
+public:
+    // Throws if no custom allocator is used, as the arena can't work without
+    // it.
+    document_arena();
+    ~document_arena();
+
+    // Allocate a new block, returns null on failure like malloc().
+    void *allocate(std::size_t size);
+
+    // Grow or shrink the block previously allocated from this arena.
+    void *reallocate(void *ptr, std::size_t size);
+
+    // Return true if the given block allocated by libxml2 comes from this
+    // arena.
+    bool owns(const void *ptr) const
+    {
+        return ptr && memory_block_header::of(ptr)->arena == this;
+    }
+
+    // Return the arena activated in the current thread, if any.
+    static document_arena *get_current() { return current_; }
+
+private:
+    struct chunk;
+
+    // Allocate a new chunk with the given usable size and return the start
+    // of its usable part or null on failure.
+    char *add_chunk(std::size_t size);
+
+    chunk *chunks_{nullptr};
+    char *pos_{nullptr};
+    char *end_{nullptr};
+    char *last_block_{nullptr};
+    std::size_t next_chunk_size_;
+
+    static thread_local document_arena *current_;
+
+    friend class arena_scope;
+
+    document_arena(const document_arena&) = delete;
+    document_arena& operator=(const document_arena&) = delete;
+};
+
+// Activates the given arena, which may be null to use the normal allocator
+// instead, in the current thread during its lifetime.
+class arena_scope
+{
+public:
+    explicit arena_scope(document_arena *arena)
+        : arena_(arena),
+          previous_(document_arena::current_)
+    {
+        document_arena::current_ = arena_;
+    }
+
+    ~arena_scope();
+
+private:
+    document_arena * const arena_;
+    document_arena * const previous_;
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+};
+
+// Return the arena used by the given document, possibly null.
+document_arena *get_document_arena(xmlDocPtr doc);
+
+// Make the document use the given arena, which must have been used for
+// allocating it.
+void attach_document_arena(xmlDocPtr doc, std::unique_ptr<document_arena> arena);
+
+// Free the document together with its extra data and its arena, if any.
+void free_document(xmlDocPtr doc);
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_arena_h_
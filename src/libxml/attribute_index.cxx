@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// xmlwrapp includes
+#include "xmlwrapp/attribute_index.h"
+#include "xmlwrapp/document.h"
+
+#include "doc_listener.h"
+#include "qname_impl.h"
+#include "utility.h"
+
+// standard includes
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// libxml includes
+#include <libxml/tree.h>
+#include <libxml/valid.h>
+#include <libxml/hash.h>
+
+namespace xml
+{
+
+using namespace impl;
+
+namespace
+{
+
+// Call the given function for the node and all elements under it, in the
+// document order.
+template <typename F>
+void for_each_element(xmlNodePtr top, F func)
+{
+    xmlNodePtr n = top;
+    while ( n )
+    {
+        if ( n->type == XML_ELEMENT_NODE )
+        {
+            func(n);
+
+            if ( n->children )
+            {
+                n = n->children;
+                continue;
+            }
+        }
+
+        if ( n == top )
+            return;
+
+        while ( !n->next )
+        {
+            n = n->parent;
+            if ( !n || n == top )
+                return;
+        }
+
+        n = n->next;
+    }
+}
+
+// Return the value of the attribute, avoiding allocating a copy of it in the
+// common case of attributes with a single text child.
+std::string get_attr_value(xmlAttrPtr attr)
+{
+    xmlNodePtr const child = attr->children;
+    if ( !child )
+        return std::string();
+
+    if ( !child->next && child->type == XML_TEXT_NODE && child->content )
+        return reinterpret_cast<const char*>(child->content);
+
+    xmlChar * const value = xmlNodeListGetString(attr->doc, child, 1);
+    if ( !value )
+        return std::string();
+
+    std::string s(reinterpret_cast<const char*>(value));
+    xmlFree(value);
+    return s;
+}
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------
+// xml::impl::attribute_index_impl
+// ------------------------------------------------------------------------
+
+namespace impl
+{
+
+class attribute_index_impl : public doc_listener
+{
+public:
+    attribute_index_impl(xmlDocPtr doc,
+                         const char *element_name,
+                         const char *attr_name,
+                         attribute_index::update_mode mode)
+        : doc_(doc),
+          mode_(mode),
+          use_ids_(false),
+          element_name_(element_name ? element_name : ""),
+          attr_name_(attr_name),
+          element_matcher_(doc, xml_string(element_name_)),
+          attr_matcher_(doc, xml_string(attr_name_))
+    {
+        add_all();
+        doc_extra::get_or_create(doc_).add_listener(this);
+    }
+
+    attribute_index_impl(xmlDocPtr doc, attribute_index::update_mode mode)
+        : doc_(doc),
+          mode_(mode),
+          use_ids_(true)
+    {
+        add_all();
+        doc_extra::get_or_create(doc_).add_listener(this);
+    }
+
+    ~attribute_index_impl()
+    {
+        if ( doc_extra *extra = doc_extra::get(doc_) )
+            extra->remove_listener(this);
+    }
+
+    xmlNodePtr find(const char *value) const
+    {
+        if ( !doc_ )
+            return nullptr;
+
+        if ( use_ids_ )
+        {
+            xmlAttrPtr attr = xmlGetID(doc_, reinterpret_cast<const xmlChar*>(value));
+            return attr ? attr->parent : nullptr;
+        }
+
+        const auto it = index_.find(value);
+        return it == index_.end() ? nullptr : it->second.front();
+    }
+
+    attribute_index::size_type count(const char *value) const
+    {
+        if ( use_ids_ )
+            return find(value) ? 1 : 0;
+
+        const auto it = index_.find(value);
+        return it == index_.end() ? 0 : it->second.size();
+    }
+
+    attribute_index::size_type size() const
+    {
+        if ( use_ids_ )
+        {
+            if ( !doc_ || !doc_->ids )
+                return 0;
+
+            const int size = xmlHashSize(static_cast<xmlHashTablePtr>(doc_->ids));
+            return size > 0 ? static_cast<attribute_index::size_type>(size) : 0;
+        }
+
+        return index_.size();
+    }
+
+    // doc_listener implementation
+    void on_subtree_added(xmlNodePtr node) override
+    {
+        if ( mode_ == attribute_index::auto_update )
+            for_each_element(node, [this](xmlNodePtr n) { add(n); });
+    }
+
+    void on_subtree_removing(xmlNodePtr node) override
+    {
+        // IDs are removed by libxml2 itself when the attributes are freed.
+        if ( mode_ == attribute_index::auto_update && !use_ids_ )
+            for_each_element(node, [this](xmlNodePtr n) { remove(n); });
+    }
+
+    void on_node_changing(xmlNodePtr node) override
+    {
+        if ( mode_ == attribute_index::auto_update && !use_ids_ &&
+                node->type == XML_ELEMENT_NODE )
+            remove(node);
+    }
+
+    void on_node_changed(xmlNodePtr node) override
+    {
+        if ( mode_ == attribute_index::auto_update &&
+                node->type == XML_ELEMENT_NODE )
+            add(node);
+    }
+
+    void on_children_reordered(xmlNodePtr) override
+    {
+    }
+
+    void on_document_destroyed() override
+    {
+        index_.clear();
+        doc_ = nullptr;
+    }
+
+private:
+    void add_all()
+    {
+        for ( xmlNodePtr n = doc_->children; n; n = n->next )
+            for_each_element(n, [this](xmlNodePtr e) { add(e); });
+    }
+
+    // Return the attribute used as key if this element should be indexed.
+    xmlAttrPtr get_key_attr(xmlNodePtr node) const
+    {
+        if ( !element_name_.empty() && !element_matcher_.matches_element(node) )
+            return nullptr;
+
+        return attr_matcher_.find_attr(node);
+    }
+
+    void add(xmlNodePtr node)
+    {
+        if ( use_ids_ )
+        {
+            add_ids(node);
+            return;
+        }
+
+        if ( xmlAttrPtr attr = get_key_attr(node) )
+            index_[get_attr_value(attr)].push_back(node);
+    }
+
+    void remove(xmlNodePtr node)
+    {
+        xmlAttrPtr attr = get_key_attr(node);
+        if ( !attr )
+            return;
+
+        const auto it = index_.find(get_attr_value(attr));
+        if ( it == index_.end() )
+            return;
+
+        std::vector<xmlNodePtr>& nodes = it->second;
+        nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
+        if ( nodes.empty() )
+            index_.erase(it);
+    }
+
+    // Register the IDs of this element not registered yet: this is needed
+    // for the nodes created outside of any document and then inserted into
+    // it, or for the documents created programmatically.
+    void add_ids(xmlNodePtr node)
+    {
+        for ( xmlAttrPtr attr = node->properties; attr; attr = attr->next )
+        {
+            if ( attr->atype == XML_ATTRIBUTE_ID || !xmlIsID(doc_, node, attr) )
+                continue;
+
+            const std::string value = get_attr_value(attr);
+            const xmlChar * const id = reinterpret_cast<const xmlChar*>(value.c_str());
+
+            // Don't replace the existing IDs, the first one wins.
+            if ( !xmlGetID(doc_, id) )
+                xmlAddID(nullptr, doc_, id, attr);
+        }
+    }
+
+    xmlDocPtr doc_;
+    const attribute_index::update_mode mode_;
+    const bool use_ids_;
+
+    const std::string element_name_;
+    const std::string attr_name_;
+    const name_matcher element_matcher_;
+    const name_matcher attr_matcher_;
+
+    std::unordered_map<std::string, std::vector<xmlNodePtr>> index_;
+};
+
+} // namespace impl
+
+
+// ------------------------------------------------------------------------
+// xml::attribute_index
+// ------------------------------------------------------------------------
+
+attribute_index::attribute_index(document& doc,
+                                 const char *element_name,
+                                 const char *attr_name,
+                                 update_mode mode)
+    : pimpl_{new attribute_index_impl(static_cast<xmlDocPtr>(doc.get_doc_data()),
+                                      element_name,
+                                      attr_name,
+                                      mode)}
+{
+}
+
+
+attribute_index::attribute_index(document& doc, ids_tag, update_mode mode)
+    : pimpl_{new attribute_index_impl(static_cast<xmlDocPtr>(doc.get_doc_data()),
+                                      mode)}
+{
+}
+
+
+attribute_index::~attribute_index() = default;
+
+
+node::iterator attribute_index::find(const char *value) const
+{
+    xmlNodePtr found = pimpl_->find(value);
+    if ( found )
+        return node::iterator(found);
+    return end();
+}
+
+
+attribute_index::size_type attribute_index::count(const char *value) const
+{
+    return pimpl_->count(value);
+}
+
+
+attribute_index::size_type attribute_index::size() const
+{
+    return pimpl_->size();
+}
+
+} // namespace xml
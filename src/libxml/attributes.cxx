@@ -32,7 +32,10 @@
 
 // xmlwrapp includes
 #include "xmlwrapp/attributes.h"
+#include "xmlwrapp/qname.h"
 #include "ait_impl.h"
+#include "doc_listener.h"
+#include "qname_impl.h"
 
 // standard includes
 #include <new>
@@ -182,6 +185,7 @@ attributes::const_iterator attributes::end() const
 
 void attributes::insert(const char *name, const char *value)
 {
+    node_change_notifier notify_change(pimpl_->xmlnode_);
     xmlSetProp(pimpl_->xmlnode_,
                reinterpret_cast<const xmlChar*>(name),
                reinterpret_cast<const xmlChar*>(value));
@@ -219,6 +223,66 @@ attributes::const_iterator attributes::find(const char *name) const
 }
 
 
+attributes::iterator attributes::find(const char *name, const char *ns_uri)
+{
+    xmlAttrPtr prop = find_prop(pimpl_->xmlnode_, name, ns_uri);
+    if ( prop != nullptr )
+        return iterator(pimpl_->xmlnode_, prop);
+
+    xmlAttributePtr dtd_prop = find_default_prop(pimpl_->xmlnode_, name, ns_uri);
+    if ( dtd_prop != nullptr )
+        return iterator(name, reinterpret_cast<const char*>(dtd_prop->defaultValue), true);
+
+    return iterator();
+}
+
+
+attributes::const_iterator attributes::find(const char *name, const char *ns_uri) const
+{
+    xmlAttrPtr prop = find_prop(pimpl_->xmlnode_, name, ns_uri);
+    if ( prop != nullptr )
+        return const_iterator(pimpl_->xmlnode_, prop);
+
+    xmlAttributePtr dtd_prop = find_default_prop(pimpl_->xmlnode_, name, ns_uri);
+    if ( dtd_prop != nullptr )
+        return const_iterator(name, reinterpret_cast<const char*>(dtd_prop->defaultValue), true);
+
+    return const_iterator();
+}
+
+
+attributes::iterator attributes::find(const qname& name)
+{
+    const qname_impl& qimpl = qname_impl::get(name);
+
+    xmlAttrPtr prop = qimpl.matcher().find_attr(pimpl_->xmlnode_);
+    if ( prop != nullptr )
+        return iterator(pimpl_->xmlnode_, prop);
+
+    xmlAttributePtr dtd_prop = find_default_prop(pimpl_->xmlnode_, name.get_name(), name.get_namespace());
+    if ( dtd_prop != nullptr )
+        return iterator(name.get_name(), reinterpret_cast<const char*>(dtd_prop->defaultValue), true);
+
+    return iterator();
+}
+
+
+attributes::const_iterator attributes::find(const qname& name) const
+{
+    const qname_impl& qimpl = qname_impl::get(name);
+
+    xmlAttrPtr prop = qimpl.matcher().find_attr(pimpl_->xmlnode_);
+    if ( prop != nullptr )
+        return const_iterator(pimpl_->xmlnode_, prop);
+
+    xmlAttributePtr dtd_prop = find_default_prop(pimpl_->xmlnode_, name.get_name(), name.get_namespace());
+    if ( dtd_prop != nullptr )
+        return const_iterator(name.get_name(), reinterpret_cast<const char*>(dtd_prop->defaultValue), true);
+
+    return const_iterator();
+}
+
+
 attributes::iterator attributes::erase (iterator to_erase)
 {
     auto prop = static_cast<xmlNodePtr>(to_erase.get_raw_attr());
@@ -226,6 +290,7 @@ attributes::iterator attributes::erase (iterator to_erase)
         return iterator(); // handle fake and bad iterators
     ++to_erase;
 
+    node_change_notifier notify_change(pimpl_->xmlnode_);
     xmlUnlinkNode(prop);
     xmlFreeNode(prop);
 
@@ -235,6 +300,7 @@ attributes::iterator attributes::erase (iterator to_erase)
 
 void attributes::erase(const char *name)
 {
+    node_change_notifier notify_change(pimpl_->xmlnode_);
     xmlUnsetProp(pimpl_->xmlnode_, reinterpret_cast<const xmlChar*>(name));
 }
 
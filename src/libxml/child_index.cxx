@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// xmlwrapp includes
+#include "child_index.h"
+
+namespace xml
+{
+
+namespace impl
+{
+
+child_index::entry& child_index::get_entry(xmlNodePtr parent)
+{
+    auto it = entries_.find(parent);
+    if ( it != entries_.end() )
+        return it->second;
+
+    entry& e = entries_[parent];
+    for ( xmlNodePtr child = parent->children; child; child = child->next )
+    {
+        if ( child->type == XML_ELEMENT_NODE )
+            add_child(e, child);
+    }
+
+    return e;
+}
+
+
+namespace
+{
+
+// Associate the name of the given node with it in the map.
+//
+// Notice that the key must always be updated, as it points to the name of
+// the node and must remain valid as long as it's in the map.
+template <typename Map>
+void set_node_for_name(Map& map, xmlNodePtr node)
+{
+    map.erase(node->name);
+    map.emplace(node->name, node);
+}
+
+} // anonymous namespace
+
+
+void child_index::add_child(entry& e, xmlNodePtr child)
+{
+    const auto last = e.last.find(child->name);
+    if ( last == e.last.end() )
+    {
+        set_node_for_name(e.first, child);
+        set_node_for_name(e.last, child);
+        return;
+    }
+
+    e.next[last->second] = child;
+    e.prev[child] = last->second;
+    set_node_for_name(e.last, child);
+}
+
+
+void child_index::remove_child(entry& e, xmlNodePtr child)
+{
+    xmlNodePtr prev = nullptr,
+               next = nullptr;
+
+    auto it = e.prev.find(child);
+    if ( it != e.prev.end() )
+    {
+        prev = it->second;
+        e.prev.erase(it);
+    }
+
+    it = e.next.find(child);
+    if ( it != e.next.end() )
+    {
+        next = it->second;
+        e.next.erase(it);
+    }
+
+    if ( prev )
+    {
+        if ( next )
+            e.next[prev] = next;
+        else
+            e.next.erase(prev);
+    }
+    else
+    {
+        if ( next )
+            set_node_for_name(e.first, next);
+        else
+            e.first.erase(child->name);
+    }
+
+    if ( next )
+    {
+        if ( prev )
+            e.prev[next] = prev;
+        else
+            e.prev.erase(next);
+    }
+    else
+    {
+        if ( prev )
+            set_node_for_name(e.last, prev);
+        else
+            e.last.erase(child->name);
+    }
+}
+
+
+void child_index::invalidate(xmlNodePtr parent)
+{
+    entries_.erase(parent);
+}
+
+
+void child_index::invalidate_subtree(xmlNodePtr node)
+{
+    // The descendants of this node are going to be destroyed and their
+    // addresses can be reused later, so make sure to forget about them.
+    for ( auto it = entries_.begin(); it != entries_.end(); )
+    {
+        bool inside = false;
+        for ( xmlNodePtr p = it->first; p; p = p->parent )
+        {
+            if ( p == node )
+            {
+                inside = true;
+                break;
+            }
+        }
+
+        if ( inside )
+            it = entries_.erase(it);
+        else
+            ++it;
+    }
+}
+
+
+xmlNodePtr child_index::find_first(xmlNodePtr parent, const xmlChar *name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const entry& e = get_entry(parent);
+    const auto it = e.first.find(name);
+    return it == e.first.end() ? nullptr : it->second;
+}
+
+
+xmlNodePtr child_index::find_next(xmlNodePtr node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( !node->parent )
+        return nullptr;
+
+    const entry& e = get_entry(node->parent);
+    const auto it = e.next.find(node);
+    return it == e.next.end() ? nullptr : it->second;
+}
+
+
+void child_index::on_subtree_added(xmlNodePtr node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto it = entries_.find(node->parent);
+    if ( it == entries_.end() )
+        return;
+
+    // Appending new elements is common and easy to handle, but for the
+    // elements inserted in the middle we'd have to find the previous element
+    // with the same name, so just rebuild the index when it's needed again.
+    if ( node->next )
+        entries_.erase(it);
+    else if ( node->type == XML_ELEMENT_NODE )
+        add_child(it->second, node);
+}
+
+
+void child_index::on_subtree_removing(xmlNodePtr node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( entries_.empty() )
+        return;
+
+    const auto it = entries_.find(node->parent);
+    if ( it != entries_.end() && node->type == XML_ELEMENT_NODE )
+        remove_child(it->second, node);
+
+    if ( node->children )
+        invalidate_subtree(node);
+}
+
+
+void child_index::on_node_changing(xmlNodePtr node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    changing_node_ = nullptr;
+    if ( node->type != XML_ELEMENT_NODE || !entries_.count(node->parent) )
+        return;
+
+    changing_node_ = node;
+    changing_name_ptr_ = node->name;
+    changing_name_ = reinterpret_cast<const char*>(node->name);
+}
+
+
+void child_index::on_node_changed(xmlNodePtr node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( node != changing_node_ )
+        return;
+
+    changing_node_ = nullptr;
+
+    // Only renaming the node affects the index of its parent, the changes to
+    // its attributes or namespace don't. But the name may be reallocated even
+    // if it doesn't change and the old pointer, possibly used as key in the
+    // index, is not valid any more then.
+    if ( node->name != changing_name_ptr_ ||
+            changing_name_ != reinterpret_cast<const char*>(node->name) )
+        invalidate(node->parent);
+}
+
+
+void child_index::on_children_reordered(xmlNodePtr parent)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    invalidate(parent);
+}
+
+
+void child_index::on_document_destroyed()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    entries_.clear();
+}
+
+} // namespace impl
+
+} // namespace xml
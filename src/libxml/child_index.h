@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _xmlwrapp_child_index_h_
+#define _xmlwrapp_child_index_h_
+
+#include "doc_listener.h"
+
+// standard includes
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// libxml includes
+#include <libxml/tree.h>
+
+namespace xml
+{
+
+namespace impl
+{
+
+/*
+    Index of the child elements by their (local) names.
+
+    The index is built lazily for each parent when its children are looked up
+    for the first time and is then updated or invalidated when the document
+    is changed. It allows to find the first child element with the given name
+    and the next sibling element with the same name in constant time.
+
+    This index is optional and must be explicitly enabled for the document
+    using document::enable_child_index().
+ */
+class child_index : public doc_listener
+{
+public:
+    child_index() = default;
+
+    // Return the index for this document if it's enabled.
+    static child_index *get(xmlDocPtr doc)
+    {
+        if ( doc_extra *extra = doc_extra::get(doc) )
+            return extra->child_index_.get();
+
+        return nullptr;
+    }
+
+    // Return the first child element of the given parent with this name.
+    xmlNodePtr find_first(xmlNodePtr parent, const xmlChar *name);
+
+    // Return the next sibling element with the same name as this one.
+    xmlNodePtr find_next(xmlNodePtr node);
+
+    // doc_listener implementation
+    void on_subtree_added(xmlNodePtr node) override;
+    void on_subtree_removing(xmlNodePtr node) override;
+    void on_node_changing(xmlNodePtr node) override;
+    void on_node_changed(xmlNodePtr node) override;
+    void on_children_reordered(xmlNodePtr parent) override;
+    void on_document_destroyed() override;
+
+private:
+    // Hash and comparison functions for the names used as keys.
+    struct name_hash
+    {
+        std::size_t operator()(const xmlChar *name) const
+        {
+            // This is FNV-1a hash.
+            std::size_t h = 2166136261u;
+            for ( ; *name; ++name )
+            {
+                h ^= *name;
+                h *= 16777619u;
+            }
+            return h;
+        }
+    };
+
+    struct name_equal
+    {
+        bool operator()(const xmlChar *n1, const xmlChar *n2) const
+        {
+            return xmlStrEqual(n1, n2) != 0;
+        }
+    };
+
+    using names_map = std::unordered_map<const xmlChar*, xmlNodePtr, name_hash, name_equal>;
+    using links_map = std::unordered_map<xmlNodePtr, xmlNodePtr>;
+
+    // The index of the children of a single parent: first and last elements
+    // with each name and the links between the elements with the same name.
+    struct entry
+    {
+        names_map first;
+        names_map last;
+        links_map next;
+        links_map prev;
+    };
+
+    entry& get_entry(xmlNodePtr parent);
+
+    void add_child(entry& e, xmlNodePtr child);
+    void remove_child(entry& e, xmlNodePtr child);
+
+    // Forget the index of the children of the given parent.
+    void invalidate(xmlNodePtr parent);
+
+    // Forget the index of the children of the given node and all of its
+    // descendants.
+    void invalidate_subtree(xmlNodePtr node);
+
+    // As the index may be updated when searching in a document which is
+    // logically const, it needs to be protected against concurrent accesses.
+    std::mutex mutex_;
+
+    std::unordered_map<xmlNodePtr, entry> entries_;
+
+    // The node being changed, if it is indexed, and its name before the
+    // change.
+    xmlNodePtr changing_node_{nullptr};
+    const xmlChar *changing_name_ptr_{nullptr};
+    std::string changing_name_;
+};
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_child_index_h_
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2001-2003 Peter J Jones (pjones@pmade.org)
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
  * All Rights Reserved
  * 
  * Redistribution and use in source and binary forms, with or without
@@ -31,90 +31,67 @@
  */
 
 // xmlwrapp includes
-#include "dtd_impl.h"
-#include "utility.h"
+#include "doc_listener.h"
+#include "child_index.h"
 
 // standard includes
-#include <string>
-#include <cstring>
+#include <algorithm>
 
-// libxml2 includes
-#include <libxml/parser.h>
-#include <libxml/valid.h>
-#include <libxml/tree.h>
-
-using namespace xml;
-using namespace xml::impl;
+namespace xml
+{
 
-namespace
+namespace impl
 {
 
-extern "C" void dtd_error(void *ctxt, const char *message, ...)
+doc_extra& doc_extra::get_or_create(xmlDocPtr doc)
 {
-    auto *dtd = static_cast<dtd_impl*>(ctxt);
+    doc_extra *extra = get(doc);
+    if ( !extra )
+    {
+        extra = new doc_extra;
+        doc->_private = extra;
+    }
 
-    va_list ap;
-    va_start(ap, message);
-    printf2string(dtd->error_, message, ap);
-    va_end(ap);
+    return *extra;
 }
 
-extern "C" void dtd_warning(void *ctxt, const char*, ...)
-{
-    auto *dtd = static_cast<dtd_impl*>(ctxt);
-    ++dtd->warnings_;
-}
 
-} // anonymous namespace
+void doc_extra::destroy(xmlDocPtr doc)
+{
+    doc_extra * const extra = get(doc);
+    if ( !extra )
+        return;
 
+    doc->_private = nullptr;
 
-dtd_impl::dtd_impl(const char *filename)
-    : warnings_(0), dtd_(nullptr)
-{
-    if ( (dtd_ = xmlParseDTD(nullptr, reinterpret_cast<const xmlChar*>(filename))) == nullptr)
-    {
-        error_ = "unable to parse DTD ";
-        error_ += filename;
-    }
-}
+    if ( extra->external_subset_ )
+        doc->extSubset = nullptr;
 
+    // Listeners may remove themselves from the list when notified, so iterate
+    // over a copy of it.
+    const std::vector<doc_listener*> listeners(extra->listeners_);
+    for ( doc_listener *l : listeners )
+        l->on_document_destroyed();
 
-dtd_impl::dtd_impl() : warnings_(0), dtd_(nullptr)
-{
+    delete extra;
 }
 
 
-dtd_impl::~dtd_impl()
-{
-    if (dtd_)
-        xmlFreeDtd(dtd_);
-}
+doc_extra::~doc_extra() = default;
 
 
-void dtd_impl::init_ctxt()
+void doc_extra::add_listener(doc_listener *listener)
 {
-    std::memset(&vctxt_, 0, sizeof(vctxt_));
-
-    vctxt_.userData = this;
-    vctxt_.error    = dtd_error;
-    vctxt_.warning  = dtd_warning;
+    listeners_.push_back(listener);
 }
 
 
-bool dtd_impl::validate(xmlDocPtr xmldoc)
+void doc_extra::remove_listener(doc_listener *listener)
 {
-    init_ctxt();
-
-    if (dtd_)
-        return xmlValidateDtd(&vctxt_, xmldoc, dtd_) != 0;
-    else
-        return xmlValidateDocument(&vctxt_, xmldoc) != 0;
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener),
+                     listeners_.end());
 }
 
+} // namespace impl
 
-xmlDtdPtr dtd_impl::release()
-{
-    xmlDtdPtr xmldtd = dtd_;
-    dtd_ = nullptr;
-    return xmldtd;
-}
+} // namespace xml
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _xmlwrapp_doc_listener_h_
+#define _xmlwrapp_doc_listener_h_
+
+// xmlwrapp includes
+#include "arena.h"
+
+// standard includes
+#include <memory>
+#include <vector>
+
+// libxml includes
+#include <libxml/tree.h>
+
+namespace xml
+{
+
+class dtd;
+
+namespace impl
+{
+
+class child_index;
+
+/*
+    Interface for the objects which need to be notified about the changes done
+    to a document using xmlwrapp API.
+
+    Notice that the changes done by calling libxml2 functions directly are not
+    reported, so the listeners can only be kept up to date if all changes to
+    the document are done via xmlwrapp.
+ */
+class doc_listener
+{
+public:
+    // Called after the node, together with all its children, has been added
+    // to the document.
+    virtual void on_subtree_added(xmlNodePtr node) = 0;
+
+    // Called before the node, together with all its children, is removed
+    // from the document. The node is still fully valid when this is called.
+    virtual void on_subtree_removing(xmlNodePtr node) = 0;
+
+    // Called before and after changing the name, the namespace or the
+    // attributes of the given node, but not its children.
+    virtual void on_node_changing(xmlNodePtr node) = 0;
+    virtual void on_node_changed(xmlNodePtr node) = 0;
+
+    // Called after the order of the children of the given node has changed,
+    // without adding or removing any of them.
+    virtual void on_children_reordered(xmlNodePtr parent) = 0;
+
+    // Called when the document is destroyed: the listener must not use it
+    // after this.
+    virtual void on_document_destroyed() = 0;
+
+protected:
+    ~doc_listener() = default;
+};
+
+/*
+    Extra data which xmlwrapp may associate with libxml2 documents.
+
+    It is stored in xmlDoc::_private and is only created when it's needed, so
+    most documents don't have it at all.
+ */
+class doc_extra
+{
+public:
+    // Return the extra data of the given document, possibly null.
+    static doc_extra *get(xmlDocPtr doc)
+    {
+        return doc ? static_cast<doc_extra*>(doc->_private) : nullptr;
+    }
+
+    // Return the extra data of the document, creating it if necessary.
+    static doc_extra& get_or_create(xmlDocPtr doc);
+
+    // Must be called before destroying or giving up the ownership of the
+    // document: notifies all the listeners and frees the extra data.
+    static void destroy(xmlDocPtr doc);
+
+    ~doc_extra();
+
+    void add_listener(doc_listener *listener);
+    void remove_listener(doc_listener *listener);
+
+    const std::vector<doc_listener*>& get_listeners() const { return listeners_; }
+
+    // The child elements index, if enabled. It's also one of the listeners.
+    std::unique_ptr<child_index> child_index_;
+
+    // The DTD used as the external subset of the document, if it was set
+    // using document::set_external_subset(): it is not owned by the document
+    // and must not be freed by xmlFreeDoc().
+    std::shared_ptr<const dtd> external_subset_;
+
+    // The arena all nodes of the document are allocated from, if it was
+    // created in document::arena_allocation mode.
+    std::unique_ptr<document_arena> arena_;
+
+private:
+    doc_extra() = default;
+
+    std::vector<doc_listener*> listeners_;
+};
+
+// Helpers for notifying the listeners of the document of the given node, if
+// any. All of them do nothing if the node doesn't belong to a document or if
+// this document doesn't have any listeners.
+
+#define XMLWRAPP_NOTIFY_LISTENERS(node, call)                       \
+    if ( doc_extra *extra = doc_extra::get((node)->doc) )           \
+    {                                                               \
+        for ( doc_listener *l : extra->get_listeners() )            \
+            l->call;                                                \
+    }
+
+inline void notify_subtree_added(xmlNodePtr node)
+{
+    XMLWRAPP_NOTIFY_LISTENERS(node, on_subtree_added(node))
+}
+
+inline void notify_subtree_removing(xmlNodePtr node)
+{
+    XMLWRAPP_NOTIFY_LISTENERS(node, on_subtree_removing(node))
+}
+
+inline void notify_children_reordered(xmlNodePtr parent)
+{
+    XMLWRAPP_NOTIFY_LISTENERS(parent, on_children_reordered(parent))
+}
+
+#undef XMLWRAPP_NOTIFY_LISTENERS
+
+// Notifies about the change of the node itself during its lifetime, any nodes
+// created while doing it are allocated from the document arena, if any.
+class node_change_notifier
+{
+public:
+    explicit node_change_notifier(xmlNodePtr node)
+        : node_(node),
+          extra_(doc_extra::get(node->doc)),
+          use_arena_(extra_ ? extra_->arena_.get() : nullptr)
+    {
+        if ( extra_ )
+        {
+            for ( doc_listener *l : extra_->get_listeners() )
+                l->on_node_changing(node_);
+        }
+    }
+
+    ~node_change_notifier()
+    {
+        if ( extra_ )
+        {
+            for ( doc_listener *l : extra_->get_listeners() )
+                l->on_node_changed(node_);
+        }
+    }
+
+private:
+    xmlNodePtr const node_;
+    doc_extra * const extra_;
+    arena_scope use_arena_;
+
+    node_change_notifier(const node_change_notifier&) = delete;
+    node_change_notifier& operator=(const node_change_notifier&) = delete;
+};
+
+// Notifies about replacing all children of the node during its lifetime:
+// the existing children are reported as removed and the children the node
+// has when this object is destroyed as added. As with node_change_notifier,
+// the document arena is used for the new nodes.
+class children_change_notifier
+{
+public:
+    explicit children_change_notifier(xmlNodePtr node)
+        : node_(node),
+          extra_(doc_extra::get(node->doc)),
+          use_arena_(extra_ ? extra_->arena_.get() : nullptr)
+    {
+        if ( extra_ )
+        {
+            for ( xmlNodePtr child = node_->children; child; child = child->next )
+            {
+                for ( doc_listener *l : extra_->get_listeners() )
+                    l->on_subtree_removing(child);
+            }
+        }
+    }
+
+    ~children_change_notifier()
+    {
+        if ( extra_ )
+        {
+            for ( xmlNodePtr child = node_->children; child; child = child->next )
+            {
+                for ( doc_listener *l : extra_->get_listeners() )
+                    l->on_subtree_added(child);
+            }
+        }
+    }
+
+private:
+    xmlNodePtr const node_;
+    doc_extra * const extra_;
+    arena_scope use_arena_;
+
+    children_change_notifier(const children_change_notifier&) = delete;
+    children_change_notifier& operator=(const children_change_notifier&) = delete;
+};
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_doc_listener_h_
@@ -41,6 +41,9 @@
 #include "utility.h"
 #include "dtd_impl.h"
 #include "node_manip.h"
+#include "doc_listener.h"
+#include "child_index.h"
+#include "arena.h"
 
 // standard includes
 #include <new>
@@ -96,9 +99,27 @@ struct doc_impl
     }
 
 
+    explicit doc_impl(std::unique_ptr<document_arena> arena)
+        : doc_(nullptr), xslt_result_(nullptr)
+    {
+        arena_scope use_arena(arena.get());
+
+        xmlDocPtr tmpdoc;
+        if ( (tmpdoc = xmlNewDoc(nullptr)) == nullptr)
+            throw std::bad_alloc();
+        attach_document_arena(tmpdoc, std::move(arena));
+
+        // This creates the root node in the arena too.
+        set_doc_data(tmpdoc, false);
+    }
+
+
     doc_impl(const doc_impl& other)
         : doc_(nullptr), xslt_result_(nullptr)
     {
+        // Notice that the copies of the arena documents don't use arenas.
+        arena_scope use_arena(nullptr);
+
         xmlDocPtr tmpdoc;
         if ( (tmpdoc = xmlCopyDoc(other.doc_, 1)) == nullptr)
             throw std::bad_alloc();
@@ -108,8 +129,7 @@ struct doc_impl
 
     void set_doc_data(xmlDocPtr newdoc, bool root_is_okay)
     {
-        if (doc_)
-            xmlFreeDoc(doc_);
+        free_doc();
         doc_ = newdoc;
 
         if (doc_->version)
@@ -141,26 +161,56 @@ struct doc_impl
     void set_root_node(const node& n)
     {
         node &non_const_node = const_cast<node&>(n);
-        xmlNodePtr new_root_node = xmlCopyNode(static_cast<xmlNodePtr>(non_const_node.get_node_data()), 1);
+        xmlNodePtr new_root_node;
+        {
+            arena_scope use_arena(get_document_arena(doc_));
+            new_root_node = xmlDocCopyNode(static_cast<xmlNodePtr>(non_const_node.get_node_data()), doc_, 1);
+        }
         if (!new_root_node)
             throw std::bad_alloc();
 
+        if (xmlNodePtr old_root_node = xmlDocGetRootElement(doc_))
+            impl::notify_subtree_removing(old_root_node);
+
         xmlNodePtr old_root_node = xmlDocSetRootElement(doc_, new_root_node);
         root_.set_node_data(new_root_node);
         if (old_root_node)
             xmlFreeNode(old_root_node);
 
+        impl::notify_subtree_added(new_root_node);
+
         xslt_result_ = nullptr;
     }
 
 
     ~doc_impl()
     {
-        if (doc_)
-            xmlFreeDoc(doc_);
+        free_doc();
         delete xslt_result_;
     }
 
+    // Replace the external subset of the document, which is only referenced
+    // by it if ref is non-null.
+    void set_external_subset(xmlDtdPtr xmldtd, const std::shared_ptr<const dtd>& ref)
+    {
+        doc_extra *extra = doc_extra::get(doc_);
+        if (extra && extra->external_subset_)
+            extra->external_subset_.reset();
+        else if (doc_->extSubset)
+            xmlFreeDtd(doc_->extSubset);
+
+        doc_->extSubset = xmldtd;
+
+        if (ref)
+            doc_extra::get_or_create(doc_).external_subset_ = ref;
+    }
+
+    void free_doc()
+    {
+        if (doc_)
+            free_document(doc_);
+    }
+
     xmlDocPtr doc_;
     xslt::impl::result *xslt_result_;
     node root_;
@@ -180,6 +230,15 @@ document::document()
 }
 
 
+document::document(memory_mode mode)
+{
+    if (mode == arena_allocation)
+        pimpl_.reset(new doc_impl(std::unique_ptr<document_arena>(new document_arena)));
+    else
+        pimpl_.reset(new doc_impl);
+}
+
+
 document::document(const char *root_name)
     : pimpl_{new doc_impl(root_name)}
 {
@@ -208,6 +267,38 @@ document::document(const char *data, size_type len, error_handler& on_error)
     swap(p.get_document());
 }
 
+document::document(const char *filename, name_dictionary& dict, error_handler& on_error)
+{
+    tree_parser p(filename, dict, on_error);
+    if ( !p )
+        throw exception(p.messages());
+    swap(p.get_document());
+}
+
+document::document(const char *data, size_type len, name_dictionary& dict, error_handler& on_error)
+{
+    tree_parser p(data, len, dict, on_error);
+    if ( !p )
+        throw exception(p.messages());
+    swap(p.get_document());
+}
+
+document::document(const char *filename, memory_mode mode, error_handler& on_error)
+{
+    tree_parser p(filename, mode, on_error);
+    if ( !p )
+        throw exception(p.messages());
+    swap(p.get_document());
+}
+
+document::document(const char *data, size_type len, memory_mode mode, error_handler& on_error)
+{
+    tree_parser p(data, len, mode, on_error);
+    if ( !p )
+        throw exception(p.messages());
+    swap(p.get_document());
+}
+
 document::document(const document& other)
     : pimpl_{new doc_impl(*(other.pimpl_))}
 {
@@ -257,6 +348,8 @@ const std::string& document::get_version() const
 
 void document::set_version(const char *version)
 {
+    arena_scope use_arena(get_document_arena(pimpl_->doc_));
+
     const xmlChar *old_version = pimpl_->doc_->version;
     if ( (pimpl_->doc_->version = xmlStrdup(reinterpret_cast<const xmlChar*>(version))) == nullptr)
         throw std::bad_alloc();
@@ -281,6 +374,8 @@ std::string document::get_encoding() const
 
 void document::set_encoding(const char *encoding)
 {
+    arena_scope use_arena(get_document_arena(pimpl_->doc_));
+
     if (pimpl_->doc_->encoding)
         xmlFree(const_cast<xmlChar*>(pimpl_->doc_->encoding));
 
@@ -305,6 +400,8 @@ void document::set_is_standalone(bool sa)
 
 bool document::process_xinclude()
 {
+    children_change_notifier notify_change(reinterpret_cast<xmlNodePtr>(pimpl_->doc_));
+
     // xmlXIncludeProcess does not return what is says it does
     return xmlXIncludeProcess(pimpl_->doc_) >= 0;
 }
@@ -322,32 +419,75 @@ bool document::has_external_subset() const
 }
 
 
+void document::set_external_subset(const std::shared_ptr<const dtd>& dtd)
+{
+    pimpl_->set_external_subset(dtd ? dtd_impl::get(*dtd).dtd_ : nullptr, dtd);
+}
+
+
 bool document::validate()
 {
-    dtd_impl dtd;
-    return dtd.validate(pimpl_->doc_);
+    errors_collector err;
+    return dtd_impl::validate(pimpl_->doc_, nullptr, err);
 }
 
 
 bool document::validate(const char *dtdname)
 {
-    dtd_impl dtd(dtdname);
+    errors_collector err;
 
-    if (!dtd.error_.empty())
-        return false;
-    if (!dtd.validate(pimpl_->doc_))
+    xmlDtdPtr xmldtd = dtd_impl::parse(dtdname, err);
+    if (!xmldtd)
         return false;
 
-    // remove the old DTD
-    if (pimpl_->doc_->extSubset != nullptr)
-        xmlFreeDtd(pimpl_->doc_->extSubset);
+    if (!dtd_impl::validate(pimpl_->doc_, xmldtd, err))
+    {
+        xmlFreeDtd(xmldtd);
+        return false;
+    }
 
-    pimpl_->doc_->extSubset = dtd.release();
+    // this removes the old DTD
+    pimpl_->set_external_subset(xmldtd, nullptr);
 
     return true;
 }
 
 
+void document::enable_child_index(bool enable)
+{
+    if (enable)
+    {
+        doc_extra& extra = doc_extra::get_or_create(pimpl_->doc_);
+        if (!extra.child_index_)
+        {
+            extra.child_index_.reset(new child_index);
+            extra.add_listener(extra.child_index_.get());
+        }
+    }
+    else
+    {
+        doc_extra *extra = doc_extra::get(pimpl_->doc_);
+        if (extra && extra->child_index_)
+        {
+            extra->remove_listener(extra->child_index_.get());
+            extra->child_index_.reset();
+        }
+    }
+}
+
+
+bool document::has_child_index() const
+{
+    return child_index::get(pimpl_->doc_) != nullptr;
+}
+
+
+document::memory_mode document::get_memory_mode() const
+{
+    return get_document_arena(pimpl_->doc_) ? arena_allocation : individual_allocation;
+}
+
+
 document::size_type document::size() const
 {
     using namespace std;
@@ -534,9 +674,26 @@ void* document::get_doc_data_read_only() const
 
 void* document::release_doc_data()
 {
+    // The arena can't be given away together with the document, so the
+    // callers must use a copy of the arena documents.
+    if (get_document_arena(pimpl_->doc_))
+        throw std::logic_error("arena document can't be released");
+
     xmlDocPtr xmldoc = pimpl_->doc_;
     pimpl_->doc_ = nullptr;
 
+    // The new owner of the document would free the shared DTD, so give it a
+    // copy of it instead.
+    doc_extra *extra = doc_extra::get(xmldoc);
+    if (extra && extra->external_subset_)
+    {
+        extra->external_subset_.reset();
+        xmldoc->extSubset = xmlCopyDtd(xmldoc->extSubset);
+    }
+
+    // The document will be used elsewhere, forget about it.
+    doc_extra::destroy(xmldoc);
+
     return xmldoc;
 }
 
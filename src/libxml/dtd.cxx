@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2001-2003 Peter J Jones (pjones@pmade.org)
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+// xmlwrapp includes
+#include "xmlwrapp/dtd.h"
+#include "xmlwrapp/document.h"
+#include "xmlwrapp/errors.h"
+
+#include "dtd_impl.h"
+#include "errors_impl.h"
+#include "init_impl.h"
+#include "utility.h"
+
+// standard includes
+#include <new>
+#include <string>
+#include <cstring>
+
+// libxml2 includes
+#include <libxml/parser.h>
+#include <libxml/valid.h>
+#include <libxml/tree.h>
+
+namespace xml
+{
+
+using namespace impl;
+
+// ------------------------------------------------------------------------
+// xml::impl::dtd_impl
+// ------------------------------------------------------------------------
+
+namespace impl
+{
+
+namespace
+{
+
+void init_ctxt(xmlValidCtxt& vctxt, error_messages& errors)
+{
+    std::memset(&vctxt, 0, sizeof(vctxt));
+
+    vctxt.userData = &errors;
+    vctxt.error    = cb_messages_error;
+    vctxt.warning  = cb_messages_warning;
+}
+
+} // anonymous namespace
+
+
+dtd_impl::dtd_impl(xmlDtdPtr dtd)
+    : dtd_(dtd)
+{
+#ifdef LIBXML_REGEXP_ENABLED
+    // Content models of the elements are normally built lazily during the
+    // first validation, which modifies the DTD. Build them now to avoid this,
+    // as this object can be used by several threads concurrently.
+    errors_collector ignore;
+    xmlValidCtxt vctxt;
+    init_ctxt(vctxt, ignore);
+
+    for (xmlNodePtr n = dtd_->children; n; n = n->next)
+    {
+        if (n->type == XML_ELEMENT_DECL)
+            xmlValidBuildContentModel(&vctxt, reinterpret_cast<xmlElementPtr>(n));
+    }
+
+    if (vctxt.vstateTab)
+        xmlFree(vctxt.vstateTab);
+    if (vctxt.nodeTab)
+        xmlFree(vctxt.nodeTab);
+#endif // LIBXML_REGEXP_ENABLED
+}
+
+
+dtd_impl::~dtd_impl()
+{
+    xmlFreeDtd(dtd_);
+}
+
+
+xmlDtdPtr dtd_impl::parse(const char *filename, error_messages& errors)
+{
+    global_errors_installer install_as_global(errors);
+
+    return xmlParseDTD(nullptr, reinterpret_cast<const xmlChar*>(filename));
+}
+
+
+xmlDtdPtr dtd_impl::parse(const char *data, std::size_t size, error_messages& errors)
+{
+    global_errors_installer install_as_global(errors);
+
+    xmlParserInputBufferPtr input = xmlParserInputBufferCreateMem
+                                    (
+                                        data,
+                                        checked_int_cast(size),
+                                        XML_CHAR_ENCODING_NONE
+                                    );
+    if (!input)
+        throw std::bad_alloc();
+
+    // The input buffer is freed by this function.
+    return xmlIOParseDTD(nullptr, input, XML_CHAR_ENCODING_NONE);
+}
+
+
+bool dtd_impl::validate(xmlDocPtr xmldoc, xmlDtdPtr xmldtd, error_messages& errors)
+{
+    in_flight_operation in_flight;
+
+    xmlValidCtxt vctxt;
+    init_ctxt(vctxt, errors);
+
+    int ret;
+    if (xmldtd)
+        ret = xmlValidateDtd(&vctxt, xmldoc, xmldtd);
+    else
+        ret = xmlValidateDocument(&vctxt, xmldoc);
+
+    if (vctxt.vstateTab)
+        xmlFree(vctxt.vstateTab);
+    if (vctxt.nodeTab)
+        xmlFree(vctxt.nodeTab);
+
+    return ret != 0;
+}
+
+} // namespace impl
+
+
+// ------------------------------------------------------------------------
+// xml::dtd
+// ------------------------------------------------------------------------
+
+namespace
+{
+
+// Take ownership of the parsed DTD, or report the errors if it couldn't be
+// parsed.
+dtd_impl *make_dtd_impl(xmlDtdPtr xmldtd,
+                        errors_collector& err,
+                        error_handler& on_error,
+                        const char *what)
+{
+    if (!xmldtd)
+    {
+        if (!err.has_errors())
+            err.on_error(std::string("unable to parse DTD ") + what);
+
+        err.replay(on_error);
+        // if the handler didn't throw, do it ourselves -- it's the only
+        // way to signal fatal errors from a ctor:
+        throw exception(err);
+    }
+
+    std::unique_ptr<dtd_impl> impl;
+    try
+    {
+        impl.reset(new dtd_impl(xmldtd));
+    }
+    catch (...)
+    {
+        xmlFreeDtd(xmldtd);
+        throw;
+    }
+
+    err.replay(on_error);
+
+    return impl.release();
+}
+
+} // anonymous namespace
+
+
+dtd::dtd(const char *filename, error_handler& on_error)
+{
+    errors_collector err;
+    xmlDtdPtr xmldtd = dtd_impl::parse(filename, err);
+    pimpl_.reset(make_dtd_impl(xmldtd, err, on_error, filename));
+}
+
+
+dtd::dtd(const char *data, size_type size, error_handler& on_error)
+{
+    errors_collector err;
+    xmlDtdPtr xmldtd = dtd_impl::parse(data, size, err);
+    pimpl_.reset(make_dtd_impl(xmldtd, err, on_error, "from memory"));
+}
+
+
+dtd::~dtd() = default;
+
+
+bool dtd::validate(const document& doc, error_handler& on_error) const
+{
+    auto xmldoc = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+
+    errors_collector err;
+    err.set_limits_from(on_error);
+    const bool ok = dtd_impl::validate(xmldoc, pimpl_->dtd_, err);
+
+    err.replay(on_error);
+
+    return ok && !err.has_errors();
+}
+
+} // namespace xml
@@ -33,8 +33,7 @@
 #ifndef _xmlwrapp_dtd_impl_h_
 #define _xmlwrapp_dtd_impl_h_
 
-// standard includes
-#include <string>
+#include "xmlwrapp/dtd.h"
 
 // libxml2 includes
 #include <libxml/parser.h>
@@ -47,38 +46,28 @@ namespace xml
 namespace impl
 {
 
-class dtd_impl
+struct dtd_impl
 {
-public:
-    // load the given DTD. you should check to see if error_ is empty or
-    // not, which will tell you if the DTD was loaded okay.
-    explicit dtd_impl(const char *filename);
-
-    // Don't load a DTD
-    dtd_impl();
-
+    // Takes ownership of the given DTD, which must not be null.
+    explicit dtd_impl(xmlDtdPtr dtd);
     ~dtd_impl();
 
-    // check the document against the loaded DTD, or in the case where no
-    // DTD is loaded try to use the one inside the document.
-    bool validate(xmlDocPtr xmldoc);
-
-    // return the dtd pointer and never again free it.
-    xmlDtdPtr release();
+    static const dtd_impl& get(const dtd& d) { return *d.pimpl_; }
 
-    // count of DTD parsing/validating warnings
-    int warnings_;
+    // Parse the DTD from the given file or memory buffer, returns null and
+    // reports the errors to the given collector if it fails.
+    static xmlDtdPtr parse(const char *filename, error_messages& errors);
+    static xmlDtdPtr parse(const char *data, std::size_t size, error_messages& errors);
 
-    // last DTD parsing/validating error message
-    std::string error_;
+    // Check the document against the given DTD or, if it's null, against
+    // the DTD of the document itself.
+    static bool validate(xmlDocPtr xmldoc, xmlDtdPtr xmldtd, error_messages& errors);
 
-private:
-    xmlValidCtxt vctxt_;
     xmlDtdPtr dtd_;
 
+private:
     dtd_impl(const dtd_impl&) = delete;
     dtd_impl& operator=(const dtd_impl&) = delete;
-    void init_ctxt();
 };
 
 } // namespace impl
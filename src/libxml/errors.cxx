@@ -46,20 +46,131 @@ error_handler_ignore_errors              ignore_errors;
 error_handler_throw_on_error             throw_on_error;
 error_handler_throw_on_error_or_warning  throw_on_error_or_warning;
 
+// ------------------------------------------------------------------------
+// xml::error_handler
+// ------------------------------------------------------------------------
+
+void error_handler::on_message(const error_message& msg)
+{
+    switch (msg.type())
+    {
+        case error_message::type_error:
+            on_error(msg.message());
+            break;
+        case error_message::type_warning:
+            on_warning(msg.message());
+            break;
+    }
+}
+
+// ------------------------------------------------------------------------
+// xml::error_message
+// ------------------------------------------------------------------------
+
+std::string error_message::message() const
+{
+    if (!has_details_)
+        return text_;
+
+    std::ostringstream oss;
+
+    oss << "XML ";
+    switch (level_)
+    {
+        case XML_ERR_WARNING:
+            // Some warnings are treated as errors, see treat_warning_as_error().
+            oss << (type_ == type_error ? "error" : "warning");
+            break;
+
+        case XML_ERR_ERROR:
+            oss << "error";
+            break;
+
+        case XML_ERR_FATAL:
+            oss << "fatal error";
+            break;
+
+        default:
+            oss << "message of unknown level " << level_;
+    }
+
+    // We currently don't decode domain and code to their symbolic
+    // representation as it doesn't seem to be worth it in practice, the error
+    // message is usually clear enough, while these numbers can be used for
+    // automatic classification of messages.
+    oss << " " << domain_ << "." << code_ << ": " << text_;
+
+    if (!file_.empty())
+    {
+        oss << " at " << file_;
+        if (line_)
+        {
+            oss << ":" << line_;
+            if (column_)
+            {
+                oss << "," << column_;
+            }
+        }
+    }
+    else if (line_)
+    {
+        // This happens for the documents parsed from memory, e.g. when
+        // validating them while parsing.
+        oss << " at line " << line_;
+        if (column_)
+        {
+            oss << ", column " << column_;
+        }
+    }
+
+    if (!str1_.empty())
+    {
+        oss << " while processing \"" << str1_ << "\"";
+        if (int1_)
+        {
+            oss << " at position " << int1_;
+        }
+    }
+
+    return oss.str();
+}
+
 // ------------------------------------------------------------------------
 // xml::error_messages
 // ------------------------------------------------------------------------
 
 void error_messages::on_error(const std::string& msg)
 {
-    messages_.emplace_back(msg, error_message::type_error);
-    has_errors_ = true;
+    on_message(error_message(msg, error_message::type_error));
 }
 
 void error_messages::on_warning(const std::string& msg)
 {
-    messages_.emplace_back(msg, error_message::type_warning);
-    has_warnings_ = true;
+    on_message(error_message(msg, error_message::type_warning));
+}
+
+void error_messages::on_message(const error_message& msg)
+{
+    if (msg.type() == error_message::type_error)
+        has_errors_ = true;
+
+    if (limit_reached())
+    {
+        suppressed_count_++;
+        return;
+    }
+
+    messages_.push_back(msg);
+
+    switch (msg.type())
+    {
+        case error_message::type_error:
+            num_errors_++;
+            break;
+        case error_message::type_warning:
+            has_warnings_ = true;
+            break;
+    }
 }
 
 std::string error_messages::print() const
@@ -73,6 +184,17 @@ std::string error_messages::print() const
         buffer += format_for_print(msg);
     }
 
+    if (suppressed_count_)
+    {
+        if (!buffer.empty())
+            buffer += "\n";
+
+        std::ostringstream oss;
+        oss << "(" << suppressed_count_ << " more message"
+            << (suppressed_count_ == 1 ? "" : "s") << " suppressed)";
+        buffer += oss.str();
+    }
+
     return buffer;
 }
 
@@ -106,43 +228,29 @@ namespace impl
 // desirable). So we collect the errors and "replay" them after returning from
 // C code.
 
-std::string build_message(const std::string& what, const xmlError& error)
+error_message error_message_builder::build(const xmlError& error,
+                                           error_message::message_type type)
 {
-    std::ostringstream oss;
-
-    // We currently don't decode domain and code to their symbolic
-    // representation as it doesn't seem to be worth it in practice, the error
-    // message is usually clear enough, while these numbers can be used for
-    // automatic classification of messages.
-    oss << "XML " << what << " " << error.domain << "." << error.code << ": "
-        << error.message;
+    error_message msg(error.message ? error.message : "", type);
 
     if (error.file)
-    {
-        oss << " at " << error.file;
-        if (error.line)
-        {
-            oss << ":" << error.line;
+        msg.file_ = error.file;
+    if (error.str1)
+        msg.str1_ = error.str1;
 
-            // Column information, if available, is passed in the second int
-            // field (first one is used with the first string field, see below).
-            if (error.int2)
-            {
-                oss << "," << error.int2;
-            }
-        }
-    }
+    msg.domain_ = error.domain;
+    msg.code_ = error.code;
+    msg.level_ = error.level;
+    msg.line_ = error.line;
 
-    if (error.str1)
-    {
-        oss << " while processing \"" << error.str1 << "\"";
-        if (error.int1)
-        {
-            oss << " at position " << error.int1;
-        }
-    }
+    // Column information, if available, is passed in the second int field
+    // (first one is used with the first string field).
+    msg.column_ = error.int2;
+    msg.int1_ = error.int1;
 
-    return oss.str();
+    msg.has_details_ = true;
+
+    return msg;
 }
 
 bool treat_warning_as_error(const xmlError& error)
@@ -196,37 +304,29 @@ extern "C" void cb_messages_structured_error(void *out, xmlErrorPtr error)
 
         auto* const messages = static_cast<error_messages*>(out);
 
+        error_message::message_type type = error_message::type_warning;
         switch (error->level)
         {
-            case XML_ERR_NONE:
-                break;
-
             case XML_ERR_WARNING:
                 // Some libxml warnings are pretty fatal errors, e.g. failing
                 // to open the input file is reported as a warning with code
                 // XML_IO_LOAD_ERROR, so treat them as such.
-                if (!treat_warning_as_error(*error))
-                {
-                    messages->on_warning(build_message("warning", *error));
-                    return;
-                }
-                // fallthrough
+                if (treat_warning_as_error(*error))
+                    type = error_message::type_error;
+                break;
 
             case XML_ERR_ERROR:
-                messages->on_error(build_message("error", *error));
-                return;
-
             case XML_ERR_FATAL:
-                messages->on_error(build_message("fatal error", *error));
-                return;
-        }
+                type = error_message::type_error;
+                break;
 
-        // This is not supposed to happen neither, but at least warn about it
-        // if it does, in case there is anything useful in the message.
-        std::ostringstream oss;
-        oss << "message of unknown level " << error->level;
+            default:
+                // This is not supposed to happen, but at least warn about it
+                // if it does, in case there is anything useful in the message.
+                break;
+        }
 
-        messages->on_warning(build_message(oss.str(), *error));
+        messages->on_message(error_message_builder::build(*error, type));
     }
     catch (...) {}
 }
@@ -268,19 +368,29 @@ extern "C" void cb_messages_error(void *out, const char *message, ...)
 }
 
 
+void errors_collector::set_limits_from(const error_handler& dest)
+{
+    auto const messages = dynamic_cast<const error_messages*>(&dest);
+    set_max_errors(messages ? messages->get_max_errors() : 0);
+}
+
+void errors_collector::on_message(const error_message& msg)
+{
+    error_messages::on_message(msg);
+
+    if (parser_to_stop_ && limit_reached())
+        xmlStopParser(parser_to_stop_);
+}
+
 void errors_collector::replay(error_handler& dest)
 {
     for (const auto& msg : messages())
+        dest.on_message(msg);
+
+    if (suppressed_count_)
     {
-        switch (msg.type())
-        {
-            case error_message::type_error:
-                dest.on_error(msg.message());
-                break;
-            case error_message::type_warning:
-                dest.on_warning(msg.message());
-                break;
-        }
+        if (auto const messages = dynamic_cast<error_messages*>(&dest))
+            messages->suppressed_count_ += suppressed_count_;
     }
 }
 
@@ -307,6 +417,10 @@ std::string errors_collector::format_for_print(const error_message& msg) const
 // global_errors_installer
 // ----------------------------------------------------------------------------
 
+// The handlers set by xmlSetStructuredErrorFunc() and xmlSetGenericErrorFunc()
+// are only thread-local if libxml2 was built with thread support, without it
+// they're shared by all threads, but libxml2 can't be used from multiple
+// threads at all then anyhow.
 global_errors_installer::global_errors_installer(error_messages& on_error) :
     xml_generic_error_orig_(xmlGenericError),
     xml_generic_error_context_orig_(xmlGenericErrorContext),
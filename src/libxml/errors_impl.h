@@ -34,6 +34,7 @@
 #define _xmlwrapp_errors_impl_h_
 
 #include <cstdarg>
+#include <libxml/parser.h>
 #include <libxml/xmlerror.h>
 #include <xmlwrapp/errors.h>
 
@@ -43,21 +44,46 @@ namespace xml
 namespace impl
 {
 
+// Creates error_message objects with all the details of libxml2 errors.
+struct error_message_builder
+{
+    static error_message build(const xmlError& error,
+                               error_message::message_type type);
+};
+
 // This handler collects all error & warning messages from libxml2 callbacks,
 // without throwing any exceptions, and then replays them, in order, to the
 // "real" error handler.
 class XMLWRAPP_API errors_collector : public error_messages
 {
 public:
-    // replay all errors into target handler
+    // use the same limit on the number of errors as the target handler, if
+    // it is an error_messages object, or no limit otherwise
+    void set_limits_from(const error_handler& dest);
+
+    // stop the given parser when the errors limit is reached, must be reset
+    // to null before the parser is freed
+    void set_parser_to_stop(xmlParserCtxtPtr ctxt) { parser_to_stop_ = ctxt; }
+
+    // replay all errors into target handler, including the number of the
+    // suppressed messages if it is an error_messages object
     void replay(error_handler& dest);
 
+    void on_message(const error_message& msg) override;
+
 protected:
     std::string format_for_print(const error_message& msg) const override;
+
+private:
+    xmlParserCtxtPtr parser_to_stop_{nullptr};
 };
 
 // RAII helper installing the given error collector as the global error sink
 // for libxml2 error messages.
+//
+// Notice that libxml2 keeps these "global" handlers in per-thread state, so
+// this only affects the errors happening in the current thread and objects
+// of this class can be used from different threads at the same time.
 class XMLWRAPP_API global_errors_installer
 {
 public:
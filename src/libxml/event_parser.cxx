@@ -38,10 +38,19 @@
 // xmlwrapp includes
 #include "xmlwrapp/event_parser.h"
 #include "xmlwrapp/node.h"
+#include "xmlwrapp/errors.h"
 #include "utility.h"
+#include "errors_impl.h"
+#include "init_impl.h"
+#include "name_dictionary_impl.h"
+#include "relaxng_impl.h"
+#include "schema_impl.h"
 
 // libxml includes
 #include <libxml/parser.h>
+#include <libxml/relaxng.h>
+#include <libxml/SAX2.h>
+#include <libxml/xmlschemas.h>
 #include <libxml/xmlversion.h>
 
 // standard includes
@@ -49,12 +58,247 @@
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 namespace xml
 {
 
 using namespace xml::impl;
 
+// ------------------------------------------------------------------------
+// xml::impl::relaxng_stream_validator
+// ------------------------------------------------------------------------
+
+namespace impl
+{
+
+// Validates the document against a RelaxNG schema using libxml2 streaming
+// API. This requires creating the nodes for the element being validated and
+// its ancestors, but not for their siblings, unless the schema can't be
+// validated in streaming mode for some element, in which case the entire
+// subtree of this element is built and validated at once.
+class relaxng_stream_validator
+{
+public:
+    relaxng_stream_validator(xmlRelaxNGPtr schema, errors_collector& errors);
+    ~relaxng_stream_validator();
+
+    void start_element(const xmlChar *localname,
+                       const xmlChar *prefix,
+                       const xmlChar *URI,
+                       int nb_attributes,
+                       const xmlChar **attributes,
+                       int line);
+    void end_element();
+    void text(const xmlChar *text, int length);
+
+    bool is_valid() const { return valid_; }
+
+private:
+    xmlNsPtr get_ns(xmlNodePtr node, const xmlChar *URI, const xmlChar *prefix);
+    void flush_text();
+
+    xmlRelaxNGValidCtxtPtr ctxt_;
+
+    // Document containing the nodes being validated.
+    xmlDocPtr doc_;
+
+    // The innermost element which hasn't ended yet.
+    xmlNodePtr current_{nullptr};
+
+    // The element whose subtree is being built, if any.
+    xmlNodePtr full_node_{nullptr};
+
+    // Text is accumulated until the next tag, as libxml2 may report it in
+    // several chunks, while it must be validated at once.
+    std::string text_;
+
+    bool valid_{true};
+
+    relaxng_stream_validator(const relaxng_stream_validator&) = delete;
+    relaxng_stream_validator& operator=(const relaxng_stream_validator&) = delete;
+};
+
+
+relaxng_stream_validator::relaxng_stream_validator(xmlRelaxNGPtr schema,
+                                                   errors_collector& errors)
+{
+    ctxt_ = xmlRelaxNGNewValidCtxt(schema);
+    if (!ctxt_)
+        throw std::bad_alloc();
+
+    doc_ = xmlNewDoc(reinterpret_cast<const xmlChar*>("1.0"));
+    if (!doc_)
+    {
+        xmlRelaxNGFreeValidCtxt(ctxt_);
+        throw std::bad_alloc();
+    }
+
+    xmlRelaxNGSetValidStructuredErrors(ctxt_, cb_messages_structured_error, &errors);
+}
+
+
+relaxng_stream_validator::~relaxng_stream_validator()
+{
+    xmlRelaxNGFreeValidCtxt(ctxt_);
+    xmlFreeDoc(doc_);
+}
+
+
+xmlNsPtr relaxng_stream_validator::get_ns(xmlNodePtr node,
+                                          const xmlChar *URI,
+                                          const xmlChar *prefix)
+{
+    // The "xml" prefix is always bound and can't be declared.
+    if (prefix && xmlStrEqual(prefix, reinterpret_cast<const xmlChar*>("xml")))
+        return xmlSearchNs(doc_, node, prefix);
+
+    for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next)
+    {
+        if (xmlStrEqual(ns->href, URI) && xmlStrEqual(ns->prefix, prefix))
+            return ns;
+    }
+
+    xmlNsPtr ns = xmlNewNs(node, URI, prefix);
+    if (!ns)
+        throw std::bad_alloc();
+
+    return ns;
+}
+
+
+void relaxng_stream_validator::start_element(const xmlChar *localname,
+                                             const xmlChar *prefix,
+                                             const xmlChar *URI,
+                                             int nb_attributes,
+                                             const xmlChar **attributes,
+                                             int line)
+{
+    flush_text();
+
+    xmlNodePtr node = xmlNewDocNode(doc_, nullptr, localname, nullptr);
+    if (!node)
+        throw std::bad_alloc();
+
+    if (current_)
+        xmlAddChild(current_, node);
+    else
+        xmlDocSetRootElement(doc_, node);
+
+    current_ = node;
+
+    // The line is used in the error messages, notice that it is truncated
+    // to 16 bits by libxml2.
+    node->line = static_cast<unsigned short>(line > 65535 ? 65535 : line);
+
+    if (URI)
+        xmlSetNs(node, get_ns(node, URI, prefix));
+
+    for (int i = 0; i < nb_attributes; ++i)
+    {
+        const xmlChar **attr = attributes + 5*i;
+
+        xmlNsPtr ns = attr[2] ? get_ns(node, attr[2], attr[1]) : nullptr;
+        std::string value(reinterpret_cast<const char*>(attr[3]),
+                          static_cast<std::string::size_type>(attr[4] - attr[3]));
+
+        if (!xmlNewNsProp(node, ns, attr[0], reinterpret_cast<const xmlChar*>(value.c_str())))
+            throw std::bad_alloc();
+    }
+
+    // The subtree is being built, it will be validated when it ends.
+    if (full_node_)
+        return;
+
+    switch (xmlRelaxNGValidatePushElement(ctxt_, doc_, node))
+    {
+        case 1:
+            break;
+
+        case 0:
+            // This element can't be validated in streaming mode.
+            full_node_ = node;
+            break;
+
+        default:
+            valid_ = false;
+    }
+}
+
+
+void relaxng_stream_validator::end_element()
+{
+    flush_text();
+
+    xmlNodePtr node = current_;
+    if (!node)
+        return;
+
+    current_ = node->parent && node->parent->type == XML_ELEMENT_NODE
+                ? node->parent
+                : nullptr;
+
+    if (full_node_)
+    {
+        // Keep building the subtree until it ends.
+        if (node != full_node_)
+            return;
+
+        full_node_ = nullptr;
+
+        if (xmlRelaxNGValidateFullElement(ctxt_, doc_, node) != 1)
+            valid_ = false;
+    }
+    else
+    {
+        if (xmlRelaxNGValidatePopElement(ctxt_, doc_, node) != 1)
+            valid_ = false;
+    }
+
+    xmlUnlinkNode(node);
+    xmlFreeNode(node);
+}
+
+
+void relaxng_stream_validator::text(const xmlChar *text, int length)
+{
+    // Text outside of the root element can only be whitespace.
+    if (!current_)
+        return;
+
+    if (full_node_)
+    {
+        xmlNodePtr node = xmlNewDocTextLen(doc_, text, length);
+        if (!node)
+            throw std::bad_alloc();
+
+        xmlAddChild(current_, node);
+    }
+    else
+    {
+        text_.append(reinterpret_cast<const char*>(text),
+                     static_cast<std::string::size_type>(length));
+    }
+}
+
+
+void relaxng_stream_validator::flush_text()
+{
+    if (text_.empty())
+        return;
+
+    if (xmlRelaxNGValidatePushCData(ctxt_,
+                                    reinterpret_cast<const xmlChar*>(text_.c_str()),
+                                    checked_int_cast(text_.size())) != 1)
+    {
+        valid_ = false;
+    }
+
+    text_.clear();
+}
+
+} // namespace impl
+
 // ------------------------------------------------------------------------
 // xml::impl::epimpl
 // ------------------------------------------------------------------------
@@ -62,16 +306,42 @@ using namespace xml::impl;
 struct impl::epimpl
 {
 public:
-    epimpl(event_parser& parent);
+    epimpl(event_parser& parent, name_dictionary *dict);
     ~epimpl();
 
+    // This must be the first member to be destroyed after all the others.
+    in_flight_operation in_flight_;
+
     xmlSAXHandler sax_handler_;
     xmlParserCtxt *parser_context_;
     bool parser_status_{true};
+    bool parsing_started_{false};
     std::string last_error_message_;
 
-    void event_start_element(const xmlChar *tag, const xmlChar **props);
-    void event_end_element(const xmlChar *tag);
+    // Schema validation context, only used if set_schema() was called.
+    xmlSchemaValidCtxtPtr schema_context_{nullptr};
+    xmlSchemaSAXPlugPtr schema_plug_{nullptr};
+    errors_collector validation_errors_;
+    error_handler *validation_handler_{nullptr};
+
+    // RelaxNG validator, only used if set_relaxng() was called.
+    std::unique_ptr<relaxng_stream_validator> relaxng_validator_;
+
+    bool is_validating() const { return schema_context_ || relaxng_validator_; }
+    void reset_validation();
+    void set_schema(xmlSchemaPtr schema, error_handler& on_error);
+    void set_relaxng(xmlRelaxNGPtr schema, error_handler& on_error);
+    void parse_chunk(const char *chunk, size_t length, bool terminate);
+    void finish_validation();
+
+    void event_start_element(const xmlChar *prefix,
+                             const xmlChar *localname,
+                             const xmlChar *URI,
+                             int nb_namespaces,
+                             const xmlChar **namespaces,
+                             int nb_attributes,
+                             const xmlChar **attributes);
+    void event_end_element(const xmlChar *prefix, const xmlChar *localname);
     void event_text(const xmlChar *text, int length);
     void event_pi(const xmlChar *target, const xmlChar *data);
     void event_comment(const xmlChar *text);
@@ -94,11 +364,26 @@ const std::size_t BUFFER_SIZE = 4096;
 extern "C"
 {
 
-void cb_start_element(void *parser, const xmlChar *tag, const xmlChar **props)
-    { static_cast<epimpl*>(parser)->event_start_element(tag, props); }
+void cb_start_element(void *parser,
+                      const xmlChar *localname,
+                      const xmlChar *prefix,
+                      const xmlChar *URI,
+                      int nb_namespaces,
+                      const xmlChar **namespaces,
+                      int nb_attributes,
+                      int /* nb_defaulted */,
+                      const xmlChar **attributes)
+{
+    static_cast<epimpl*>(parser)->event_start_element(prefix, localname, URI,
+                                                      nb_namespaces, namespaces,
+                                                      nb_attributes, attributes);
+}
 
-void cb_end_element(void *parser, const xmlChar *tag)
-    { static_cast<epimpl*>(parser)->event_end_element(tag); }
+void cb_end_element(void *parser,
+                    const xmlChar *localname,
+                    const xmlChar *prefix,
+                    const xmlChar * /* URI */)
+    { static_cast<epimpl*>(parser)->event_end_element(prefix, localname); }
 
 void cb_text(void *parser, const xmlChar *text, int length)
     { static_cast<epimpl*>(parser)->event_text(text, length); }
@@ -133,25 +418,115 @@ void cb_error(void *parser, const char *message, ...)
     printf2string(complete_message, message, ap);
     va_end(ap);
 
-    static_cast<epimpl*>(parser)->event_error(complete_message);
+    epimpl *p = static_cast<epimpl*>(parser);
+
+    // Namespace errors, such as using undeclared prefixes, didn't use to be
+    // detected at all when we used SAX1 API, so don't fail because of them.
+    if (p->parser_context_->lastError.domain == XML_FROM_NAMESPACE)
+        p->event_warning(complete_message);
+    else
+        p->event_error(complete_message);
 }
 
+// This callback is used instead of cb_error() and cb_warning() when
+// validating, as libxml2 doesn't forward the errors to the SAX handler
+// callbacks once the schema validation is plugged into it.
+#if LIBXML_VERSION >= 21200
+void cb_structured_error(void *parser, const xmlError *error)
+#else
+void cb_structured_error(void *parser, xmlErrorPtr error)
+#endif
+{
+    if (!error || error->level == XML_ERR_NONE)
+        return;
+
+    epimpl *p = static_cast<epimpl*>(parser);
+
+    try
+    {
+        std::string message(error->message ? error->message : "");
+        if (error->level == XML_ERR_WARNING || error->domain == XML_FROM_NAMESPACE)
+            p->event_warning(message);
+        else
+            p->event_error(message);
+    }
+    catch ( ... )
+    {
+        p->parser_status_ = false;
+        xmlStopParser(p->parser_context_);
+    }
+}
+
+#if LIBXML_VERSION >= 20900
+int cb_schema_locator(void *context, const char **file, unsigned long *line)
+{
+    auto ctxt = static_cast<xmlParserCtxtPtr>(context);
+    if (!ctxt->input)
+        return -1;
+
+    if (file)
+        *file = ctxt->input->filename;
+    if (line)
+        *line = static_cast<unsigned long>(ctxt->input->line);
+
+    return 0;
+}
+#endif // libxml2 >= 2.9.0
+
 void cb_ignore(void*, const xmlChar*, int)
 {
 }
 
 } // extern "C"
 
+// Redirects the errors of the parser being validated to epimpl during this
+// object lifetime.
+class validation_errors_redirector
+{
+public:
+    explicit validation_errors_redirector(epimpl& parser)
+        : structured_error_orig_(xmlStructuredError),
+          structured_error_context_orig_(xmlStructuredErrorContext)
+    {
+        xmlSetStructuredErrorFunc(&parser, cb_structured_error);
+    }
+
+    ~validation_errors_redirector()
+    {
+        xmlSetStructuredErrorFunc(structured_error_context_orig_, structured_error_orig_);
+    }
+
+private:
+    xmlStructuredErrorFunc structured_error_orig_;
+    void *structured_error_context_orig_;
+
+    validation_errors_redirector(const validation_errors_redirector&) = delete;
+    validation_errors_redirector& operator=(const validation_errors_redirector&) = delete;
+};
+
+std::string make_qname(const xmlChar *prefix, const xmlChar *localname)
+{
+    std::string name;
+    if (prefix)
+    {
+        name = reinterpret_cast<const char*>(prefix);
+        name += ':';
+    }
+    name += reinterpret_cast<const char*>(localname);
+    return name;
+}
+
 } // anonymous namespace
 
 
-epimpl::epimpl(event_parser& parent)
+epimpl::epimpl(event_parser& parent, name_dictionary *dict)
     : parent_(parent)
 {
     std::memset(&sax_handler_, 0, sizeof(sax_handler_));
 
-    sax_handler_.startElement           = cb_start_element;
-    sax_handler_.endElement             = cb_end_element;
+    sax_handler_.initialized            = XML_SAX2_MAGIC;
+    sax_handler_.startElementNs         = cb_start_element;
+    sax_handler_.endElementNs           = cb_end_element;
     sax_handler_.characters             = cb_text;
     sax_handler_.processingInstruction  = cb_pi;
     sax_handler_.comment                = cb_comment;
@@ -169,33 +544,205 @@ epimpl::epimpl(event_parser& parent)
     {
         throw std::bad_alloc();
     }
+
+    if (dict)
+    {
+        try
+        {
+            use_dictionary(parser_context_, name_dictionary_impl::acquire_for_parsing(*dict));
+        }
+        catch ( ... )
+        {
+            xmlFreeParserCtxt(parser_context_);
+            throw;
+        }
+    }
 }
 
 
 epimpl::~epimpl()
 {
+    reset_validation();
+
     xmlFreeParserCtxt(parser_context_);
 }
 
 
-void epimpl::event_start_element(const xmlChar *tag, const xmlChar **props)
+void epimpl::reset_validation()
+{
+    if (schema_plug_)
+    {
+        xmlSchemaSAXUnplug(schema_plug_);
+        schema_plug_ = nullptr;
+    }
+
+    if (schema_context_)
+    {
+        xmlSchemaFreeValidCtxt(schema_context_);
+        schema_context_ = nullptr;
+    }
+
+    relaxng_validator_.reset();
+
+    validation_errors_.set_parser_to_stop(nullptr);
+}
+
+
+void epimpl::set_schema(xmlSchemaPtr schema, error_handler& on_error)
+{
+    if (parsing_started_)
+        throw exception("schema must be set before starting parsing");
+
+    reset_validation();
+
+    schema_context_ = xmlSchemaNewValidCtxt(schema);
+    if (!schema_context_)
+        throw std::bad_alloc();
+
+    xmlSchemaSetValidStructuredErrors(schema_context_,
+                                      cb_messages_structured_error,
+                                      &validation_errors_);
+#if LIBXML_VERSION >= 20900
+    xmlSchemaValidateSetLocator(schema_context_, cb_schema_locator, parser_context_);
+#endif
+
+    // This replaces the SAX handler and user data of the parser context with
+    // the ones of the validator, which forwards the events to us.
+    schema_plug_ = xmlSchemaSAXPlug(schema_context_,
+                                    &parser_context_->sax,
+                                    &parser_context_->userData);
+    if (!schema_plug_)
+        throw exception("failed to initialize schema validation");
+
+    validation_errors_.set_limits_from(on_error);
+    validation_errors_.set_parser_to_stop(parser_context_);
+    validation_handler_ = &on_error;
+}
+
+
+void epimpl::set_relaxng(xmlRelaxNGPtr schema, error_handler& on_error)
+{
+    if (parsing_started_)
+        throw exception("schema must be set before starting parsing");
+
+    reset_validation();
+
+    relaxng_validator_.reset(new relaxng_stream_validator(schema, validation_errors_));
+
+    validation_errors_.set_limits_from(on_error);
+    validation_errors_.set_parser_to_stop(parser_context_);
+    validation_handler_ = &on_error;
+}
+
+
+void epimpl::parse_chunk(const char *chunk, size_t length, bool terminate)
+{
+    parsing_started_ = true;
+
+    if (schema_plug_)
+    {
+        validation_errors_redirector redirect(*this);
+        xmlParseChunk(parser_context_, chunk, checked_int_cast(length), terminate);
+    }
+    else
+    {
+        xmlParseChunk(parser_context_, chunk, checked_int_cast(length), terminate);
+    }
+
+    // The parser was stopped because of too many validation errors, report
+    // them now as parse_finish() is not going to be called in this case.
+    if (is_validating() && validation_errors_.limit_reached())
+        finish_validation();
+}
+
+
+void epimpl::finish_validation()
+{
+    if (!is_validating())
+        return;
+
+    const bool valid = schema_context_
+                        ? xmlSchemaIsValid(schema_context_) == 1
+                        : relaxng_validator_->is_valid();
+
+    if (parser_status_ && (validation_errors_.has_errors() || !valid))
+    {
+        parser_status_ = false;
+
+        last_error_message_.clear();
+        for (const auto& msg : validation_errors_.messages())
+        {
+            if (msg.type() == error_message::type_error)
+            {
+                last_error_message_ = msg.message();
+                break;
+            }
+        }
+
+        if (last_error_message_.empty())
+            last_error_message_ = "document is not valid";
+    }
+
+    // Validation is done, so make sure we don't report the errors twice.
+    error_handler& on_error = *validation_handler_;
+    reset_validation();
+
+    validation_errors_.replay(on_error);
+}
+
+
+void epimpl::event_start_element(const xmlChar *prefix,
+                                 const xmlChar *localname,
+                                 const xmlChar *URI,
+                                 int nb_namespaces,
+                                 const xmlChar **namespaces,
+                                 int nb_attributes,
+                                 const xmlChar **attributes)
 {
     if (!parser_status_)
         return;
 
     try
     {
+        if (relaxng_validator_)
+        {
+            relaxng_validator_->start_element(localname, prefix, URI,
+                                              nb_attributes, attributes,
+                                              xmlSAX2GetLineNumber(parser_context_));
+        }
+
         event_parser::attrs_type attrs;
-        const xmlChar **attrp;
 
-        for (attrp = props; attrp && *attrp; attrp += 2)
+        // Namespace declarations are reported as attributes for
+        // compatibility with the previous versions.
+        for (int i = 0; i < nb_namespaces; ++i)
         {
-            attrs[reinterpret_cast<const char*>(*attrp)] =
-                    reinterpret_cast<const char*>(*(attrp+1));
+            const xmlChar *ns_prefix = namespaces[2*i];
+            const xmlChar *ns_uri = namespaces[2*i + 1];
+
+            std::string name("xmlns");
+            if (ns_prefix)
+            {
+                name += ':';
+                name += reinterpret_cast<const char*>(ns_prefix);
+            }
+
+            attrs[name] = ns_uri ? reinterpret_cast<const char*>(ns_uri) : "";
         }
 
-        std::string name = reinterpret_cast<const char*>(tag);
-        parser_status_ = parent_.start_element(name, attrs);
+        // Each attribute is described by its local name, prefix, URI and the
+        // start and the end of its value.
+        for (int i = 0; i < nb_attributes; ++i)
+        {
+            const xmlChar **attr = attributes + 5*i;
+            attrs[make_qname(attr[1], attr[0])].assign
+            (
+                reinterpret_cast<const char*>(attr[3]),
+                static_cast<std::string::size_type>(attr[4] - attr[3])
+            );
+        }
+
+        parser_status_ = parent_.start_element(make_qname(prefix, localname), attrs);
     }
     catch ( ... )
     {
@@ -207,15 +754,17 @@ void epimpl::event_start_element(const xmlChar *tag, const xmlChar **props)
 }
 
 
-void epimpl::event_end_element(const xmlChar *tag)
+void epimpl::event_end_element(const xmlChar *prefix, const xmlChar *localname)
 {
     if (!parser_status_)
         return;
 
     try
     {
-        std::string name = reinterpret_cast<const char*>(tag);
-        parser_status_ = parent_.end_element(name);
+        if (relaxng_validator_)
+            relaxng_validator_->end_element();
+
+        parser_status_ = parent_.end_element(make_qname(prefix, localname));
     }
     catch ( ... )
     {
@@ -234,6 +783,9 @@ void epimpl::event_text(const xmlChar *text, int length)
 
     try
     {
+        if (relaxng_validator_)
+            relaxng_validator_->text(text, length);
+
         std::string contents(reinterpret_cast<const char*>(text), static_cast<std::string::size_type>(length));
         parser_status_ = parent_.text(contents);
     }
@@ -295,6 +847,9 @@ void epimpl::event_cdata(const xmlChar *text, int length)
 
     try
     {
+        if (relaxng_validator_)
+            relaxng_validator_->text(text, length);
+
         std::string contents(reinterpret_cast<const char*>(text), static_cast<std::string::size_type>(length));
         parser_status_ = parent_.cdata(contents);
     }
@@ -346,7 +901,13 @@ void epimpl::event_error(const std::string& message)
 // ------------------------------------------------------------------------
 
 event_parser::event_parser()
-    : pimpl_{new epimpl(*this)}
+    : pimpl_{new epimpl(*this, nullptr)}
+{
+}
+
+
+event_parser::event_parser(name_dictionary& dict)
+    : pimpl_{new epimpl(*this, &dict)}
 {
 }
 
@@ -354,6 +915,18 @@ event_parser::event_parser()
 event_parser::~event_parser() = default;
 
 
+void event_parser::set_schema(const schema& xsd, error_handler& on_error)
+{
+    pimpl_->set_schema(schema_impl::get(xsd).schema_, on_error);
+}
+
+
+void event_parser::set_relaxng(const relaxng& rng, error_handler& on_error)
+{
+    pimpl_->set_relaxng(relaxng_impl::get(rng).relaxng_, on_error);
+}
+
+
 bool event_parser::parse_file(const char *filename)
 {
     std::ifstream file(filename);
@@ -390,14 +963,17 @@ bool event_parser::parse_stream(std::istream& stream)
 
 bool xml::event_parser::parse_chunk(const char *chunk, size_type length)
 {
-    xmlParseChunk(pimpl_->parser_context_, chunk, xml::impl::checked_int_cast(length), 0);
+    pimpl_->parse_chunk(chunk, length, false);
     return pimpl_->parser_status_;
 }
 
 
 bool event_parser::parse_finish()
 {
-    xmlParseChunk(pimpl_->parser_context_, nullptr, 0, 0);
+    // When validating, we need to be sure that the entire document was
+    // parsed, as otherwise the missing elements wouldn't be detected.
+    pimpl_->parse_chunk(nullptr, 0, pimpl_->is_validating());
+    pimpl_->finish_validation();
     return pimpl_->parser_status_;
 }
 
@@ -33,15 +33,140 @@
 
 // xmlwrapp includes
 #include "xmlwrapp/init.h"
+#include "xmlwrapp/allocator.h"
+#include "xmlwrapp/errors.h"
+
+#include "init_impl.h"
+#include "arena.h"
 
 // libxml includes
 #include <libxml/globals.h>
 #include <libxml/xmlerror.h>
 #include <libxml/parser.h>
+#include <libxml/xmlmemory.h>
+
+// standard includes
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
 
 namespace
 {
 
+// The library state is allocated on the heap and never freed, as xml::init
+// objects may be created and destroyed during static initialization and
+// destruction, i.e. before or after any global objects defined here would
+// be constructed or destroyed.
+struct library_state
+{
+    // Protects init_counter and serializes the library initialization and
+    // shutdown.
+    std::mutex init_mutex;
+    int init_counter{0};
+
+    // Number of operations in progress and the condition used to wait until
+    // it becomes 0, see in_flight_operation.
+    std::atomic<int> operations{0};
+    std::atomic<bool> waiting{false};
+    std::mutex operations_mutex;
+    std::condition_variable operations_done;
+
+    // Used for restarting libxslt together with libxml2.
+    xml::impl::library_hook shutdown_hook{nullptr};
+    xml::impl::library_hook init_hook{nullptr};
+
+    // The libxml2 memory functions used before set_allocator() was called.
+    bool has_default_memory_functions{false};
+    xmlFreeFunc default_free{nullptr};
+    xmlMallocFunc default_malloc{nullptr};
+    xmlMallocFunc default_malloc_atomic{nullptr};
+    xmlReallocFunc default_realloc{nullptr};
+    xmlStrdupFunc default_strdup{nullptr};
+};
+
+library_state& get_library_state()
+{
+    static library_state* const state = new library_state;
+    return *state;
+}
+
+// The allocator used by the functions below, it is only changed by
+// set_allocator() when libxml2 is not used.
+xml::allocator *g_allocator = nullptr;
+
+using xml::impl::document_arena;
+using xml::impl::memory_block_header;
+
+// All blocks are preceded by a header allowing to recognize the ones
+// allocated from the document arenas, which are never freed individually.
+const size_t header_size = sizeof(memory_block_header);
+
+extern "C"
+{
+
+static void* xmlwrapp_malloc(size_t size)
+{
+    if ( document_arena *arena = document_arena::get_current() )
+        return arena->allocate(size);
+
+    if ( size > static_cast<size_t>(-1) - header_size )
+        return nullptr;
+
+    auto header = static_cast<memory_block_header*>(g_allocator->allocate(header_size + size));
+    if ( !header )
+        return nullptr;
+
+    header->arena = nullptr;
+    header->size = size;
+    return header + 1;
+}
+
+static void* xmlwrapp_realloc(void *ptr, size_t size)
+{
+    if ( !ptr )
+        return xmlwrapp_malloc(size);
+
+    // Notice that the blocks remain in the arena they were allocated from
+    // (or outside of any arena), whichever arena is currently active.
+    memory_block_header *header = memory_block_header::of(ptr);
+    if ( header->arena )
+        return header->arena->reallocate(ptr, size);
+
+    if ( size > static_cast<size_t>(-1) - header_size )
+        return nullptr;
+
+    header = static_cast<memory_block_header*>(g_allocator->reallocate(header, header_size + size));
+    if ( !header )
+        return nullptr;
+
+    header->size = size;
+    return header + 1;
+}
+
+static void xmlwrapp_free(void *ptr)
+{
+    if ( !ptr )
+        return;
+
+    memory_block_header * const header = memory_block_header::of(ptr);
+    if ( header->arena )
+        return;
+
+    g_allocator->deallocate(header);
+}
+
+static char* xmlwrapp_strdup(const char *str)
+{
+    const size_t size = std::strlen(str) + 1;
+    auto copy = static_cast<char*>(xmlwrapp_malloc(size));
+    if ( copy )
+        std::memcpy(copy, str, size);
+    return copy;
+}
+
+} // extern "C"
+
 bool change_flag_and_return_old_value(int* flag, bool new_value)
 {
     const bool old_value = *flag != 0;
@@ -54,19 +179,28 @@ bool change_flag_and_return_old_value(int* flag, bool new_value)
 namespace xml
 {
 
-int init::ms_counter = 0;
-
 init::init()
 {
-    if ( ms_counter++ == 0 )
+    library_state& state = get_library_state();
+
+    // Notice that the other threads creating init objects at the same time
+    // wait until the library is fully initialized.
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+    if ( state.init_counter++ == 0 )
         init_library();
 }
 
 
 init::~init()
 {
-    if ( --ms_counter == 0 )
+    library_state& state = get_library_state();
+
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+    if ( --state.init_counter == 0 )
+    {
+        impl::wait_for_operations();
         shutdown_library();
+    }
 }
 
 
@@ -90,6 +224,124 @@ void init::shutdown_library()
 }
 
 
+allocator* init::set_allocator(allocator *alloc)
+{
+    library_state& state = get_library_state();
+
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+
+    allocator* const old_alloc = g_allocator;
+    if ( alloc == old_alloc )
+        return old_alloc;
+
+    if ( state.operations )
+        throw exception("allocator can't be changed while the library is in use");
+
+    // All the memory allocated by libxml2 so far must be freed by the
+    // allocator it was allocated with, so shut it down before changing it
+    // and initialize it again afterwards.
+    const bool restart = state.init_counter != 0;
+    if ( restart )
+    {
+        if ( state.shutdown_hook )
+            (*state.shutdown_hook)();
+        xmlCleanupParser();
+    }
+
+    if ( !state.has_default_memory_functions )
+    {
+        xmlGcMemGet(&state.default_free,
+                    &state.default_malloc,
+                    &state.default_malloc_atomic,
+                    &state.default_realloc,
+                    &state.default_strdup);
+        state.has_default_memory_functions = true;
+    }
+
+    // Notice that xmlGcMemSetup() sets all the functions which would be set
+    // by xmlMemSetup() too.
+    g_allocator = alloc;
+    if ( alloc )
+    {
+        xmlGcMemSetup(xmlwrapp_free,
+                      xmlwrapp_malloc,
+                      xmlwrapp_malloc,
+                      xmlwrapp_realloc,
+                      xmlwrapp_strdup);
+    }
+    else
+    {
+        xmlGcMemSetup(state.default_free,
+                      state.default_malloc,
+                      state.default_malloc_atomic,
+                      state.default_realloc,
+                      state.default_strdup);
+    }
+
+    if ( restart )
+    {
+        xmlInitParser();
+        if ( state.init_hook )
+            (*state.init_hook)();
+    }
+
+    return old_alloc;
+}
+
+
+allocator* init::get_allocator()
+{
+    return g_allocator;
+}
+
+
+namespace impl
+{
+
+in_flight_operation::in_flight_operation()
+{
+    ++get_library_state().operations;
+}
+
+
+in_flight_operation::~in_flight_operation()
+{
+    library_state& state = get_library_state();
+
+    if ( --state.operations == 0 && state.waiting )
+    {
+        std::lock_guard<std::mutex> lock(state.operations_mutex);
+        state.operations_done.notify_all();
+    }
+}
+
+
+void wait_for_operations()
+{
+    library_state& state = get_library_state();
+
+    std::unique_lock<std::mutex> lock(state.operations_mutex);
+
+    // This must be set before checking the number of operations, so that
+    // the operation finishing concurrently notifies us.
+    state.waiting = true;
+    state.operations_done.wait(lock, [&state]() { return state.operations == 0; });
+    state.waiting = false;
+}
+
+
+void set_restart_hooks(library_hook shutdown, library_hook init)
+{
+    library_state& state = get_library_state();
+
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+    state.shutdown_hook = shutdown;
+    state.init_hook = init;
+}
+
+} // namespace impl
+
+
 bool init::indent_output(bool flag)
 {
     return change_flag_and_return_old_value(&xmlIndentTreeOutput, flag);
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains helpers for safely shutting down the library.
+ */
+
+#ifndef _xmlwrapp_init_impl_h_
+#define _xmlwrapp_init_impl_h_
+
+// xmlwrapp includes
+#include "xmlwrapp/export.h"
+
+namespace xml
+{
+
+namespace impl
+{
+
+// RAII helper marking an operation using libxml2 as being in progress: the
+// library is not shut down, even if the last xml::init object is destroyed
+// in another thread, until all such operations finish.
+class XMLWRAPP_API in_flight_operation
+{
+public:
+    in_flight_operation();
+    ~in_flight_operation();
+
+private:
+    in_flight_operation(const in_flight_operation&) = delete;
+    in_flight_operation& operator=(const in_flight_operation&) = delete;
+};
+
+// Wait until all the operations in progress in the other threads finish.
+//
+// This is called before shutting down the library.
+XMLWRAPP_API void wait_for_operations();
+
+// Functions called to shut down and initialize libxslt when libxml2 is
+// restarted by xml::init::set_allocator(), they're set by xsltwrapp while it
+// is initialized and are null otherwise.
+using library_hook = void (*)();
+
+XMLWRAPP_API void set_restart_hooks(library_hook shutdown, library_hook init);
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_init_impl_h_
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// xmlwrapp includes
+#include "xmlwrapp/name_dictionary.h"
+#include "xmlwrapp/errors.h"
+
+#include "name_dictionary_impl.h"
+
+// standard includes
+#include <new>
+
+namespace xml
+{
+
+using namespace impl;
+
+// ------------------------------------------------------------------------
+// xml::impl::name_dictionary_impl
+// ------------------------------------------------------------------------
+
+impl::name_dictionary_impl::name_dictionary_impl(name_dictionary::threading_mode mode)
+    : dict_(xmlDictCreate()),
+      mode_(mode)
+{
+    if ( !dict_ )
+        throw std::bad_alloc();
+}
+
+impl::name_dictionary_impl::~name_dictionary_impl()
+{
+    xmlDictFree(dict_);
+}
+
+xmlDictPtr impl::name_dictionary_impl::acquire_for_parsing()
+{
+    if ( mode_ == name_dictionary::single_threaded )
+    {
+        xmlDictReference(dict_);
+        return dict_;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // From now on the shared dictionary is never modified, so it's safe to
+    // look up names in it from any number of sub-dictionaries concurrently.
+    used_for_parsing_ = true;
+
+    xmlDictPtr sub = xmlDictCreateSub(dict_);
+    if ( !sub )
+        throw std::bad_alloc();
+
+    return sub;
+}
+
+
+void impl::use_dictionary(xmlParserCtxtPtr ctxt, xmlDictPtr dict)
+{
+    if ( ctxt->dict )
+        xmlDictFree(ctxt->dict);
+
+    ctxt->dict = dict;
+    ctxt->dictNames = 1;
+
+    // These strings are compared by pointer by the parser, so they must come
+    // from the dictionary actually used.
+    ctxt->str_xml = xmlDictLookup(dict, BAD_CAST "xml", 3);
+    ctxt->str_xmlns = xmlDictLookup(dict, BAD_CAST "xmlns", 5);
+    ctxt->str_xml_ns = xmlDictLookup(dict, XML_XML_NAMESPACE, -1);
+}
+
+
+// ------------------------------------------------------------------------
+// xml::name_dictionary
+// ------------------------------------------------------------------------
+
+name_dictionary::name_dictionary(threading_mode mode)
+    : pimpl_{new name_dictionary_impl(mode)}
+{
+}
+
+
+name_dictionary::~name_dictionary() = default;
+
+
+name_dictionary::threading_mode name_dictionary::get_threading_mode() const
+{
+    return pimpl_->mode_;
+}
+
+
+const char *name_dictionary::intern(const char *name)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_, std::defer_lock);
+    if ( pimpl_->mode_ == thread_safe )
+    {
+        lock.lock();
+        if ( pimpl_->used_for_parsing_ )
+            throw exception("thread-safe dictionary can't be modified after being used for parsing");
+    }
+
+    const xmlChar *interned = xmlDictLookup(pimpl_->dict_, reinterpret_cast<const xmlChar*>(name), -1);
+    if ( !interned )
+        throw std::bad_alloc();
+
+    return reinterpret_cast<const char*>(interned);
+}
+
+
+const char *name_dictionary::find(const char *name) const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_, std::defer_lock);
+    if ( pimpl_->mode_ == thread_safe )
+        lock.lock();
+
+    return reinterpret_cast<const char*>(
+        xmlDictExists(pimpl_->dict_, reinterpret_cast<const xmlChar*>(name), -1));
+}
+
+
+name_dictionary::size_type name_dictionary::size() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_, std::defer_lock);
+    if ( pimpl_->mode_ == thread_safe )
+        lock.lock();
+
+    return static_cast<size_type>(xmlDictSize(pimpl_->dict_));
+}
+
+} // namespace xml
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _xmlwrapp_name_dictionary_impl_h_
+#define _xmlwrapp_name_dictionary_impl_h_
+
+#include "xmlwrapp/name_dictionary.h"
+
+// libxml2 includes
+#include <libxml/parser.h>
+
+// standard includes
+#include <mutex>
+
+namespace xml
+{
+
+namespace impl
+{
+
+struct name_dictionary_impl
+{
+    explicit name_dictionary_impl(name_dictionary::threading_mode mode);
+    ~name_dictionary_impl();
+
+    // Return the dictionary to be used by a new parser. The caller receives
+    // its own reference to it and must release it with xmlDictFree().
+    xmlDictPtr acquire_for_parsing();
+
+    static xmlDictPtr acquire_for_parsing(name_dictionary& dict)
+        { return dict.pimpl_->acquire_for_parsing(); }
+
+    xmlDictPtr dict_;
+    const name_dictionary::threading_mode mode_;
+
+    // Only used in thread-safe mode, protects dict_ modifications.
+    std::mutex mutex_;
+    bool used_for_parsing_{false};
+};
+
+// Make the parser context use the given dictionary instead of its own one.
+// Takes ownership of the dictionary reference. This must be done before
+// starting parsing.
+void use_dictionary(xmlParserCtxtPtr ctxt, xmlDictPtr dict);
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_name_dictionary_impl_h_
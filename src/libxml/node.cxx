@@ -36,10 +36,14 @@
 #include "xmlwrapp/nodes_view.h"
 #include "xmlwrapp/attributes.h"
 #include "xmlwrapp/errors.h"
+#include "xmlwrapp/qname.h"
 #include "utility.h"
 #include "ait_impl.h"
 #include "node_manip.h"
 #include "node_iterator.h"
+#include "doc_listener.h"
+#include "child_index.h"
+#include "qname_impl.h"
 
 // standard includes
 #include <cstring>
@@ -209,16 +213,58 @@ struct insert_node
 // an element node finder
 xmlNodePtr find_element(const char *name, xmlNodePtr first)
 {
-    while (first != nullptr)
+    if (!first)
+        return nullptr;
+
+    return name_matcher(first->doc, reinterpret_cast<const xmlChar*>(name)).find_element(first);
+}
+
+
+// find the first child element matching the given name, using the child
+// index if it's enabled for the document
+xmlNodePtr find_child_element(xmlNodePtr parent, const name_matcher& matcher)
+{
+    if (child_index *index = child_index::get(parent->doc))
     {
-        if (first->type == XML_ELEMENT_NODE && xmlStrcmp(first->name, reinterpret_cast<const xmlChar*>(name)) == 0)
-        {
-            return first;
-        }
-        first = first->next;
+        xmlNodePtr n = index->find_first(parent, matcher.get_name());
+        while (n != nullptr && !matcher.matches_ns(n->ns))
+            n = index->find_next(n);
+        return n;
     }
 
-    return nullptr;
+    return matcher.find_element(parent->children);
+}
+
+
+xmlNodePtr find_child_element(xmlNodePtr parent, const char *name)
+{
+    return find_child_element(parent, name_matcher(parent->doc, reinterpret_cast<const xmlChar*>(name)));
+}
+
+
+xmlNodePtr find_child_element(xmlNodePtr parent, const char *name, const char *ns_uri)
+{
+    return find_child_element(parent,
+                              name_matcher(parent->doc,
+                                           reinterpret_cast<const xmlChar*>(name),
+                                           name_matcher::mode_for(ns_uri),
+                                           reinterpret_cast<const xmlChar*>(ns_uri)));
+}
+
+
+// find the next sibling element matching the given name, the node itself
+// must match it
+xmlNodePtr find_next_element(xmlNodePtr node, const name_matcher& matcher)
+{
+    if (child_index *index = child_index::get(node->doc))
+    {
+        xmlNodePtr n = index->find_next(node);
+        while (n != nullptr && !matcher.matches_ns(n->ns))
+            n = index->find_next(n);
+        return n;
+    }
+
+    return matcher.find_element(node->next);
 }
 
 
@@ -246,11 +292,30 @@ public:
 class next_named_element_functor : public iter_advance_functor
 {
 public:
-    next_named_element_functor(const char *name) : name_(name) {}
+    next_named_element_functor(xmlDocPtr doc, const char *name)
+        : name_(name), matcher_(doc, xml_string(name_)) {}
+    next_named_element_functor(xmlDocPtr doc, const char *name, const char *ns_uri)
+        : name_(name),
+          ns_uri_(ns_uri ? ns_uri : ""),
+          matcher_(doc, xml_string(name_),
+                   name_matcher::mode_for(ns_uri), xml_string(ns_uri_)) {}
     xmlNodePtr operator()(xmlNodePtr node) const override
-        { return find_element(name_.c_str(), node->next); }
+        { return find_next_element(node, matcher_); }
 private:
-    std::string name_;
+    const std::string name_;
+    const std::string ns_uri_;
+    const name_matcher matcher_;
+};
+
+
+class next_qname_element_functor : public iter_advance_functor
+{
+public:
+    next_qname_element_functor(const qname& name) : name_(name) {}
+    xmlNodePtr operator()(xmlNodePtr node) const override
+        { return find_next_element(node, qname_impl::get(name_).matcher()); }
+private:
+    const qname name_;
 };
 
 } // anonymous namespace
@@ -390,6 +455,8 @@ void node::move_under(node& new_parent)
     // the new parent would have been our child and we would have thrown above.
     xmlNodePtr& old_parent_node = this_node->parent;
 
+    notify_subtree_removing(this_node);
+
     // Remove the node from the old parent children list.
     if (this_node->prev)
         this_node->prev->next = this_node->next;
@@ -412,6 +479,8 @@ void node::move_under(node& new_parent)
     else
         new_parent_node->children = this_node;
     new_parent_node->last = this_node;
+
+    notify_subtree_added(this_node);
 }
 
 
@@ -441,6 +510,7 @@ void* node::release_node_data()
 
 void node::set_name(const char *name)
 {
+    node_change_notifier notify_change(pimpl_->xmlnode_);
     xmlNodeSetName(pimpl_->xmlnode_, reinterpret_cast<const xmlChar*>(name));
 }
 
@@ -453,6 +523,7 @@ const char* node::get_name() const
 
 void node::set_content(const char *content)
 {
+    children_change_notifier notify_change(pimpl_->xmlnode_);
     xmlNodeSetContent(pimpl_->xmlnode_, reinterpret_cast<const xmlChar*>(content));
 }
 
@@ -461,6 +532,7 @@ void node::set_text_content(const char *content)
 {
     xmlChar *escaped = xmlEncodeSpecialChars(pimpl_->xmlnode_->doc,
                                              reinterpret_cast<const xmlChar*>(content));
+    children_change_notifier notify_change(pimpl_->xmlnode_);
     xmlNodeSetContent(pimpl_->xmlnode_, escaped);
     if ( escaped )
         xmlFree(escaped);
@@ -558,6 +630,8 @@ void node::set_namespace(const std::string& href)
     if (pimpl_->xmlnode_->type != XML_ELEMENT_NODE)
         throw xml::exception("set_namespace called on non-element node");
 
+    arena_scope use_arena(get_document_arena(pimpl_->xmlnode_->doc));
+
     xmlNsPtr ns = xmlNewNs(pimpl_->xmlnode_, xmlHref, nullptr);
 
     if ( !ns )
@@ -583,6 +657,7 @@ void node::set_namespace(const std::string& href)
     // namespace yet, children namespaces will remain unset, which would break
     // the expected namespace inheritance and so we need to set them explicitly
     // to avoid this.
+    node_change_notifier notify_change(pimpl_->xmlnode_);
     if ( pimpl_->xmlnode_->ns )
         xmlSetNs(pimpl_->xmlnode_, ns);
     else
@@ -657,7 +732,7 @@ node::const_iterator node::parent() const
 
 node::iterator node::find(const char *name)
 {
-    xmlNodePtr found = find_element(name, pimpl_->xmlnode_->children);
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, name);
     if (found)
         return iterator(found);
     return end();
@@ -666,7 +741,7 @@ node::iterator node::find(const char *name)
 
 node::const_iterator node::find(const char *name) const
 {
-    xmlNodePtr found = find_element(name, pimpl_->xmlnode_->children);
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, name);
     if (found)
         return const_iterator(found);
     return end();
@@ -691,6 +766,60 @@ node::const_iterator node::find(const char *name, const const_iterator& start) c
 }
 
 
+node::iterator node::find(const char *name, const char *ns_uri)
+{
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, name, ns_uri);
+    if (found)
+        return iterator(found);
+    return end();
+}
+
+
+node::const_iterator node::find(const char *name, const char *ns_uri) const
+{
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, name, ns_uri);
+    if (found)
+        return const_iterator(found);
+    return end();
+}
+
+
+node::iterator node::find(const qname& name)
+{
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, qname_impl::get(name).matcher());
+    if (found)
+        return iterator(found);
+    return end();
+}
+
+
+node::const_iterator node::find(const qname& name) const
+{
+    xmlNodePtr found = find_child_element(pimpl_->xmlnode_, qname_impl::get(name).matcher());
+    if (found)
+        return const_iterator(found);
+    return end();
+}
+
+
+node::iterator node::find(const qname& name, const iterator& start)
+{
+    auto n = static_cast<xmlNodePtr>(start.get_raw_node());
+    if ((n = qname_impl::get(name).matcher().find_element(n)) != nullptr)
+        return iterator(n);
+    return end();
+}
+
+
+node::const_iterator node::find(const qname& name, const const_iterator& start) const
+{
+    auto n = static_cast<xmlNodePtr>(start.get_raw_node());
+    if ((n = qname_impl::get(name).matcher().find_element(n)) != nullptr)
+        return const_iterator(n);
+    return end();
+}
+
+
 nodes_view node::elements()
 {
     return nodes_view
@@ -713,8 +842,8 @@ nodes_view node::elements(const char *name)
 {
     return nodes_view
            (
-               find_element(name, pimpl_->xmlnode_->children),
-               new next_named_element_functor(name)
+               find_child_element(pimpl_->xmlnode_, name),
+               new next_named_element_functor(pimpl_->xmlnode_->doc, name)
            );
 }
 
@@ -722,8 +851,44 @@ xml::const_nodes_view node::elements(const char *name) const
 {
     return const_nodes_view
            (
-               find_element(name, pimpl_->xmlnode_->children),
-               new next_named_element_functor(name)
+               find_child_element(pimpl_->xmlnode_, name),
+               new next_named_element_functor(pimpl_->xmlnode_->doc, name)
+           );
+}
+
+nodes_view node::elements(const char *name, const char *ns_uri)
+{
+    return nodes_view
+           (
+               find_child_element(pimpl_->xmlnode_, name, ns_uri),
+               new next_named_element_functor(pimpl_->xmlnode_->doc, name, ns_uri)
+           );
+}
+
+xml::const_nodes_view node::elements(const char *name, const char *ns_uri) const
+{
+    return const_nodes_view
+           (
+               find_child_element(pimpl_->xmlnode_, name, ns_uri),
+               new next_named_element_functor(pimpl_->xmlnode_->doc, name, ns_uri)
+           );
+}
+
+nodes_view node::elements(const qname& name)
+{
+    return nodes_view
+           (
+               find_child_element(pimpl_->xmlnode_, qname_impl::get(name).matcher()),
+               new next_qname_element_functor(name)
+           );
+}
+
+xml::const_nodes_view node::elements(const qname& name) const
+{
+    return const_nodes_view
+           (
+               find_child_element(pimpl_->xmlnode_, qname_impl::get(name).matcher()),
+               new next_qname_element_functor(name)
            );
 }
 
@@ -781,6 +946,7 @@ void node::clear()
     if ( !n->children )
         return;
 
+    children_change_notifier notify_change(n);
     xmlFreeNodeList(n->children);
     n->children =
     n->last = nullptr;
@@ -810,6 +976,8 @@ void node::sort(const char *node_name, const char *attr_name)
 
     std::sort(node_list.begin(), node_list.end(), compare_attr(attr_name));
     std::for_each(node_list.begin(), node_list.end(), insert_node(pimpl_->xmlnode_));
+
+    notify_children_reordered(pimpl_->xmlnode_);
 }
 
 
@@ -835,6 +1003,8 @@ void node::sort_fo(cbfo_node_compare& cb)
 
     std::sort(node_list.begin(), node_list.end(), node_cmp(cb));
     std::for_each(node_list.begin(), node_list.end(), insert_node(pimpl_->xmlnode_));
+
+    notify_children_reordered(pimpl_->xmlnode_);
 }
 
 
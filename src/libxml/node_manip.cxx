@@ -34,6 +34,7 @@
 #include "xmlwrapp/errors.h"
 
 #include "node_manip.h"
+#include "doc_listener.h"
 
 // standard includes
 #include <stdexcept>
@@ -93,7 +94,14 @@ void replace_ns_recursively(xmlNodePtr node, xmlNsPtr old_ns, xmlNsPtr new_ns)
 // freed with xmlFreeNode().
 xmlNodePtr copy_node_under_parent(xmlNodePtr parent, xmlNodePtr orig_node)
 {
-    xmlNodePtr new_xml_node = xmlCopyNode(orig_node, 1);
+    // Create the copy directly in the target document, so that its names are
+    // stored in the document dictionary, if it has one, and its memory comes
+    // from the document arena, if it uses one.
+    xmlNodePtr new_xml_node;
+    {
+        xml::impl::arena_scope use_arena(xml::impl::get_document_arena(parent->doc));
+        new_xml_node = xmlDocCopyNode(orig_node, parent->doc, 1);
+    }
     if ( !new_xml_node )
         throw std::bad_alloc();
 
@@ -171,6 +179,8 @@ xml::impl::node_insert(xmlNodePtr parent, xmlNodePtr before, xmlNodePtr to_add)
         }
     }
 
+    notify_subtree_added(new_xml_node);
+
     return new_xml_node;
 }
 
@@ -183,17 +193,26 @@ xml::impl::node_replace(xmlNodePtr old_node, xmlNodePtr new_node)
     // hack to see if xmlReplaceNode was successful: it only updates doc
     // pointer of the new node if everything went well, so check that it will
     // change
+    //
+    // Note that the dummy document must use the same dictionary as the real
+    // one, as the names of the copied node come from it.
     xmlDoc dummyDoc{};
+    dummyDoc.dict = copied_node->doc ? copied_node->doc->dict : nullptr;
     copied_node->doc = &dummyDoc;
+
+    notify_subtree_removing(old_node);
     xmlReplaceNode(old_node, copied_node);
 
     if ( copied_node->doc == &dummyDoc )
     {
         xmlFreeNode(copied_node);
+        notify_subtree_added(old_node);
         throw xml::exception("failed to replace xml::node; xmlReplaceNode() failed");
     }
 
     xmlFreeNode(old_node);
+    notify_subtree_added(copied_node);
+
     return copied_node;
 }
 
@@ -205,6 +224,7 @@ xmlNodePtr xml::impl::node_erase(xmlNodePtr to_erase)
 
     xmlNodePtr after = to_erase->next;
 
+    notify_subtree_removing(to_erase);
     xmlUnlinkNode(to_erase);
     xmlFreeNode(to_erase);
 
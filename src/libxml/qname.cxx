@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// xmlwrapp includes
+#include "xmlwrapp/qname.h"
+#include "xmlwrapp/document.h"
+
+#include "qname_impl.h"
+#include "utility.h"
+
+namespace xml
+{
+
+using namespace impl;
+
+// ------------------------------------------------------------------------
+// xml::impl::qname_impl
+// ------------------------------------------------------------------------
+
+impl::qname_impl::qname_impl(xmlDocPtr doc, const char *name,
+                             name_matcher::ns_mode mode, const char *ns_uri)
+    : name_(name),
+      ns_uri_(ns_uri ? ns_uri : ""),
+      mode_(mode),
+      matcher_(doc, xml_string(name_), mode_, xml_string(ns_uri_))
+{
+    if ( matcher_.get_dict() )
+        xmlDictReference(matcher_.get_dict());
+}
+
+impl::qname_impl::qname_impl(const qname_impl& other)
+    : name_(other.name_),
+      ns_uri_(other.ns_uri_),
+      mode_(other.mode_),
+      matcher_(other.matcher_.get_dict(),
+               xml_string(name_), mode_, xml_string(ns_uri_))
+{
+    if ( matcher_.get_dict() )
+        xmlDictReference(matcher_.get_dict());
+}
+
+impl::qname_impl::~qname_impl()
+{
+    if ( matcher_.get_dict() )
+        xmlDictFree(matcher_.get_dict());
+}
+
+
+// ------------------------------------------------------------------------
+// xml::qname
+// ------------------------------------------------------------------------
+
+qname::qname(const document& doc, const char *local_name)
+    : pimpl_{new qname_impl(static_cast<xmlDocPtr>(doc.get_doc_data_read_only()),
+                            local_name,
+                            name_matcher::any_namespace,
+                            nullptr)}
+{
+}
+
+qname::qname(const document& doc, const char *local_name, const char *ns_uri)
+    : pimpl_{new qname_impl(static_cast<xmlDocPtr>(doc.get_doc_data_read_only()),
+                            local_name,
+                            name_matcher::mode_for(ns_uri),
+                            ns_uri)}
+{
+}
+
+qname::qname(const qname& other)
+    : pimpl_{new qname_impl(*other.pimpl_)}
+{
+}
+
+qname& qname::operator=(const qname& other)
+{
+    pimpl_.reset(new qname_impl(*other.pimpl_));
+    return *this;
+}
+
+qname::~qname() = default;
+
+
+const char *qname::get_name() const
+{
+    return pimpl_->name_.c_str();
+}
+
+const char *qname::get_namespace() const
+{
+    return pimpl_->mode_ == name_matcher::in_namespace ? pimpl_->ns_uri_.c_str()
+                                                       : nullptr;
+}
+
+bool qname::matches_any_namespace() const
+{
+    return pimpl_->mode_ == name_matcher::any_namespace;
+}
+
+} // namespace xml
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _xmlwrapp_qname_impl_h_
+#define _xmlwrapp_qname_impl_h_
+
+#include "xmlwrapp/qname.h"
+
+// standard includes
+#include <string>
+
+// libxml2 includes
+#include <libxml/tree.h>
+
+namespace xml
+{
+
+namespace impl
+{
+
+// Helper used for finding elements or attributes with the given name.
+//
+// It doesn't own the strings it uses, so it must not outlive them: it's either
+// used temporarily, during a single lookup, or as part of qname_impl.
+//
+// If the name is found in the document dictionary, the names of the nodes of
+// this document are compared with it by pointer: this relies on all of them
+// being stored in the dictionary if the document has one, which is always the
+// case for the documents parsed or modified by xmlwrapp.
+class name_matcher
+{
+public:
+    enum ns_mode
+    {
+        any_namespace,
+        no_namespace,
+        in_namespace
+    };
+
+    // Return the mode to use for matching the given namespace URI, which may
+    // be null or empty to match only the nodes without namespace.
+    static ns_mode mode_for(const char *ns_uri)
+    {
+        return ns_uri && *ns_uri ? in_namespace : no_namespace;
+    }
+
+    name_matcher() = default;
+
+    name_matcher(xmlDocPtr doc, const xmlChar *name,
+                 ns_mode mode = any_namespace, const xmlChar *ns_uri = nullptr)
+        : name_matcher(doc ? doc->dict : nullptr, name, mode, ns_uri)
+    {
+    }
+
+    name_matcher(xmlDictPtr dict, const xmlChar *name,
+                 ns_mode mode, const xmlChar *ns_uri)
+        : name_(name),
+          ns_uri_(ns_uri),
+          mode_(mode)
+    {
+        // Notice that we only look up the name here, but don't add it to the
+        // dictionary, as this would modify a possibly shared object. If the
+        // name is not present in it, we simply fall back to comparing strings.
+        if ( dict )
+        {
+            const xmlChar *interned = xmlDictExists(dict, name, -1);
+            if ( interned )
+            {
+                name_ = interned;
+                dict_ = dict;
+            }
+        }
+    }
+
+    const xmlChar *get_name() const { return name_; }
+    xmlDictPtr get_dict() const { return dict_; }
+
+    // Return true if the names of the nodes from this document can be
+    // compared with ours by pointer.
+    bool is_interned_for(xmlDocPtr doc) const
+    {
+        return dict_ && doc && doc->dict == dict_;
+    }
+
+    bool matches_name(const xmlChar *name, bool interned) const
+    {
+        return interned ? name == name_ : xmlStrEqual(name, name_) != 0;
+    }
+
+    bool matches_ns(xmlNsPtr ns) const
+    {
+        switch ( mode_ )
+        {
+            case any_namespace:
+                return true;
+
+            case no_namespace:
+                return ns == nullptr;
+
+            case in_namespace:
+                return ns && xmlStrEqual(ns->href, ns_uri_);
+        }
+
+        return false;
+    }
+
+    // Check if the given element has our name.
+    bool matches_element(xmlNodePtr node) const
+    {
+        return matches_name(node->name, is_interned_for(node->doc)) &&
+                    matches_ns(node->ns);
+    }
+
+    // Find the first element with our name starting from the given node.
+    xmlNodePtr find_element(xmlNodePtr first) const
+    {
+        if ( !first )
+            return nullptr;
+
+        const bool interned = is_interned_for(first->doc);
+        for ( ; first; first = first->next )
+        {
+            if ( first->type == XML_ELEMENT_NODE &&
+                    matches_name(first->name, interned) &&
+                        matches_ns(first->ns) )
+                return first;
+        }
+
+        return nullptr;
+    }
+
+    // Find the attribute with our name of the given element.
+    xmlAttrPtr find_attr(xmlNodePtr element) const
+    {
+        const bool interned = is_interned_for(element->doc);
+        for ( xmlAttrPtr prop = element->properties; prop; prop = prop->next )
+        {
+            if ( matches_name(prop->name, interned) && matches_ns(prop->ns) )
+                return prop;
+        }
+
+        return nullptr;
+    }
+
+private:
+    const xmlChar *name_{nullptr};
+    const xmlChar *ns_uri_{nullptr};
+    xmlDictPtr dict_{nullptr};
+    ns_mode mode_{any_namespace};
+};
+
+
+struct qname_impl
+{
+    qname_impl(xmlDocPtr doc, const char *name,
+               name_matcher::ns_mode mode, const char *ns_uri);
+    qname_impl(const qname_impl& other);
+    ~qname_impl();
+
+    static const qname_impl& get(const qname& q) { return *q.pimpl_; }
+
+    const name_matcher& matcher() const { return matcher_; }
+
+    std::string name_;
+    std::string ns_uri_;
+    name_matcher::ns_mode mode_;
+
+private:
+    // The matcher uses the strings above and keeps a reference to the
+    // document dictionary, if it uses it.
+    name_matcher matcher_;
+
+    qname_impl& operator=(const qname_impl&) = delete;
+};
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_qname_impl_h_
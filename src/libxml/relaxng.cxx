@@ -36,9 +36,8 @@
 #include "xmlwrapp/errors.h"
 
 #include "errors_impl.h"
-
-// libxml includes
-#include <libxml/relaxng.h>
+#include "init_impl.h"
+#include "relaxng_impl.h"
 
 namespace xml
 {
@@ -52,39 +51,56 @@ using namespace impl;
 namespace impl
 {
 
-struct relaxng_impl
+relaxng_impl::relaxng_impl(xmlDocPtr xmldoc, error_handler& on_error)
 {
-    relaxng_impl(xmlDocPtr xmldoc, error_handler& on_error)
-    {
-        impl::errors_collector err;
-
-        xmlRelaxNGParserCtxtPtr ctxt = xmlRelaxNGNewDocParserCtxt(xmldoc);
-        if ( !ctxt )
-            throw std::bad_alloc();
-        xmlRelaxNGSetParserErrors(ctxt,
-                                  cb_messages_error, cb_messages_warning,
-                                  &err);
-
-        relaxng_ = xmlRelaxNGParse(ctxt);
-        xmlRelaxNGFreeParserCtxt(ctxt);
-
-        if ( !relaxng_ )
-        {
-            err.replay(on_error);
-            // if the handler didn't throw, do it ourselves -- it's the only
-            // way to signal fatal errors from a ctor:
-            throw exception(err);
-        }
-    }
+    impl::errors_collector err;
 
-    ~relaxng_impl()
+    xmlRelaxNGParserCtxtPtr ctxt = xmlRelaxNGNewDocParserCtxt(xmldoc);
+    if ( !ctxt )
+        throw std::bad_alloc();
+    xmlRelaxNGSetParserErrors(ctxt,
+                              cb_messages_error, cb_messages_warning,
+                              &err);
+
+    relaxng_ = xmlRelaxNGParse(ctxt);
+    xmlRelaxNGFreeParserCtxt(ctxt);
+
+    if ( !relaxng_ )
     {
-        if (relaxng_)
-            xmlRelaxNGFree(relaxng_);
+        err.replay(on_error);
+        // if the handler didn't throw, do it ourselves -- it's the only
+        // way to signal fatal errors from a ctor:
+        throw exception(err);
     }
+}
+
+relaxng_impl::~relaxng_impl()
+{
+    if (relaxng_)
+        xmlRelaxNGFree(relaxng_);
+}
+
+int relaxng_impl::validate(xmlDocPtr xmldoc, error_messages& errors) const
+{
+    in_flight_operation in_flight;
+
+    decltype(contexts_)::lease ctxt(contexts_,
+                                    [this]() { return xmlRelaxNGNewValidCtxt(relaxng_); });
+
+    xmlRelaxNGSetValidErrors(ctxt.get(),
+                             cb_messages_error, cb_messages_warning,
+                             &errors);
+
+    int ret = xmlRelaxNGValidateDoc(ctxt.get(), xmldoc);
 
-    xmlRelaxNGPtr relaxng_{nullptr};
-};
+    // Don't leave the dangling pointer to the errors in the pooled context.
+    xmlRelaxNGSetValidErrors(ctxt.get(), nullptr, nullptr, nullptr);
+
+    if ( ret == -1 )
+        ctxt.discard();
+
+    return ret;
+}
 
 } // namespace impl
 
@@ -110,18 +126,9 @@ bool relaxng::validate(const document& doc, error_handler& on_error) const
 {
     auto xmldoc = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
 
-    xmlRelaxNGValidCtxtPtr ctxt = xmlRelaxNGNewValidCtxt(pimpl_->relaxng_);
-    if ( !ctxt )
-        throw std::bad_alloc();
-
     impl::errors_collector err;
-    xmlRelaxNGSetValidErrors(ctxt,
-                             cb_messages_error, cb_messages_warning,
-                             &err);
-
-    int ret = xmlRelaxNGValidateDoc(ctxt, xmldoc);
-
-    xmlRelaxNGFreeValidCtxt(ctxt);
+    err.set_limits_from(on_error);
+    int ret = pimpl_->validate(xmldoc, err);
 
     if ( ret == -1 )
         throw xml::exception("internal validation error");
@@ -131,4 +138,24 @@ bool relaxng::validate(const document& doc, error_handler& on_error) const
     return ret == 0;
 }
 
+
+std::vector<error_messages>
+relaxng::validate_batch(const std::vector<const document*>& docs, unsigned num_threads) const
+{
+    std::vector<error_messages> results(docs.size());
+
+    impl::run_in_parallel(docs.size(), num_threads, [&](std::size_t i)
+    {
+        auto xmldoc = static_cast<xmlDocPtr>(docs[i]->get_doc_data_read_only());
+
+        const int ret = pimpl_->validate(xmldoc, results[i]);
+        if ( ret == -1 )
+            results[i].on_error("internal validation error");
+        else if ( ret != 0 && !results[i].has_errors() )
+            results[i].on_error("document is not valid");
+    });
+
+    return results;
+}
+
 } // namespace xml
@@ -36,9 +36,8 @@
 #include "xmlwrapp/errors.h"
 
 #include "errors_impl.h"
-
-// libxml includes
-#include <libxml/xmlschemas.h>
+#include "init_impl.h"
+#include "schema_impl.h"
 
 namespace xml
 {
@@ -49,47 +48,58 @@ using namespace impl;
 // xml::impl::schema_impl
 // ------------------------------------------------------------------------
 
-namespace impl
+schema_impl::schema_impl(xmlDocPtr xmldoc, error_handler& on_error)
 {
+    impl::errors_collector err;
 
-struct schema_impl
-{
-    schema_impl(xmlDocPtr xmldoc, error_handler& on_error)
-    {
-        impl::errors_collector err;
-
-        xmlSchemaParserCtxtPtr ctxt = xmlSchemaNewDocParserCtxt(xmldoc);
-        if ( !ctxt )
-            throw std::bad_alloc();
-        xmlSchemaSetParserErrors(ctxt,
-                                 cb_messages_error, cb_messages_warning,
-                                 &err);
-
-        schema_ = xmlSchemaParse(ctxt);
-        xmlSchemaFreeParserCtxt(ctxt);
-
-        if ( !schema_ )
-        {
-            err.replay(on_error);
-            // if the handler didn't throw, do it ourselves -- it's the only
-            // way to signal fatal errors from a ctor:
-            throw exception(err);
-        }
-    }
+    xmlSchemaParserCtxtPtr ctxt = xmlSchemaNewDocParserCtxt(xmldoc);
+    if ( !ctxt )
+        throw std::bad_alloc();
+    xmlSchemaSetParserErrors(ctxt,
+                             cb_messages_error, cb_messages_warning,
+                             &err);
 
-    ~schema_impl()
+    schema_ = xmlSchemaParse(ctxt);
+    xmlSchemaFreeParserCtxt(ctxt);
+
+    if ( !schema_ )
     {
-        if (schema_)
-            xmlSchemaFree(schema_);
-        if (retainDoc_)
-            xmlFreeDoc(retainDoc_);
+        err.replay(on_error);
+        // if the handler didn't throw, do it ourselves -- it's the only
+        // way to signal fatal errors from a ctor:
+        throw exception(err);
     }
+}
 
-    xmlSchemaPtr schema_{nullptr};
-    xmlDocPtr    retainDoc_{nullptr};
-};
+schema_impl::~schema_impl()
+{
+    if (schema_)
+        xmlSchemaFree(schema_);
+    if (retainDoc_)
+        xmlFreeDoc(retainDoc_);
+}
 
-} // namespace impl
+int schema_impl::validate(xmlDocPtr xmldoc, error_messages& errors) const
+{
+    in_flight_operation in_flight;
+
+    decltype(contexts_)::lease ctxt(contexts_,
+                                    [this]() { return xmlSchemaNewValidCtxt(schema_); });
+
+    xmlSchemaSetValidErrors(ctxt.get(),
+                            cb_messages_error, cb_messages_warning,
+                            &errors);
+
+    int ret = xmlSchemaValidateDoc(ctxt.get(), xmldoc);
+
+    // Don't leave the dangling pointer to the errors in the pooled context.
+    xmlSchemaSetValidErrors(ctxt.get(), nullptr, nullptr, nullptr);
+
+    if ( ret == -1 )
+        ctxt.discard();
+
+    return ret;
+}
 
 
 // ------------------------------------------------------------------------
@@ -122,18 +132,9 @@ bool schema::validate(const document& doc, error_handler& on_error) const
 {
     auto xmldoc = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
 
-    xmlSchemaValidCtxtPtr ctxt = xmlSchemaNewValidCtxt(pimpl_->schema_);
-    if ( !ctxt )
-        throw std::bad_alloc();
-
     impl::errors_collector err;
-    xmlSchemaSetValidErrors(ctxt,
-                            cb_messages_error, cb_messages_warning,
-                            &err);
-
-    int ret = xmlSchemaValidateDoc(ctxt, xmldoc);
-
-    xmlSchemaFreeValidCtxt(ctxt);
+    err.set_limits_from(on_error);
+    int ret = pimpl_->validate(xmldoc, err);
 
     if ( ret == -1 )
         throw xml::exception("internal validation error");
@@ -143,4 +144,24 @@ bool schema::validate(const document& doc, error_handler& on_error) const
     return ret == 0;
 }
 
+
+std::vector<error_messages>
+schema::validate_batch(const std::vector<const document*>& docs, unsigned num_threads) const
+{
+    std::vector<error_messages> results(docs.size());
+
+    impl::run_in_parallel(docs.size(), num_threads, [&](std::size_t i)
+    {
+        auto xmldoc = static_cast<xmlDocPtr>(docs[i]->get_doc_data_read_only());
+
+        const int ret = pimpl_->validate(xmldoc, results[i]);
+        if ( ret == -1 )
+            results[i].on_error("internal validation error");
+        else if ( ret != 0 && !results[i].has_errors() )
+            results[i].on_error("document is not valid");
+    });
+
+    return results;
+}
+
 } // namespace xml
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the private part of the xml::schema class.
+ */
+
+#ifndef _xmlwrapp_schema_impl_h_
+#define _xmlwrapp_schema_impl_h_
+
+#include "xmlwrapp/schema.h"
+
+#include "validation_pool.h"
+
+// libxml includes
+#include <libxml/xmlschemas.h>
+
+namespace xml
+{
+
+namespace impl
+{
+
+struct schema_impl
+{
+    schema_impl(xmlDocPtr xmldoc, error_handler& on_error);
+    ~schema_impl();
+
+    static const schema_impl& get(const schema& s) { return *s.pimpl_; }
+
+    // Validate the document using one of the pooled contexts, returns the
+    // value of xmlSchemaValidateDoc().
+    int validate(xmlDocPtr xmldoc, error_messages& errors) const;
+
+    xmlSchemaPtr schema_{nullptr};
+    xmlDocPtr    retainDoc_{nullptr};
+
+    mutable validation_context_pool<xmlSchemaValidCtxtPtr, xmlSchemaFreeValidCtxt> contexts_;
+};
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_schema_impl_h_
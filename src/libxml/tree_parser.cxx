@@ -37,6 +37,9 @@
 #include "xmlwrapp/errors.h"
 #include "utility.h"
 #include "errors_impl.h"
+#include "init_impl.h"
+#include "name_dictionary_impl.h"
+#include "arena.h"
 
 // libxml includes
 #include <libxml/parser.h>
@@ -71,6 +74,16 @@ struct impl::tree_impl
 {
     tree_impl();
 
+    // Parse the document using the given context, which is freed by this
+    // function, and return it or null on error.
+    //
+    // If the arena is specified, everything allocated while parsing comes
+    // from it, including the document itself, and is freed together with it.
+    xmlDocPtr parse(xmlParserCtxtPtr ctxt,
+                    name_dictionary *dict,
+                    document_arena *arena,
+                    error_handler *on_error);
+
     document doc_;
     xmlSAXHandler sax_;
     errors_collector messages_;
@@ -119,38 +132,130 @@ impl::tree_impl::tree_impl()
 }
 
 
+xmlDocPtr impl::tree_impl::parse(xmlParserCtxtPtr ctxt,
+                                 name_dictionary *dict,
+                                 document_arena *arena,
+                                 error_handler *on_error)
+{
+    if (dict)
+    {
+        xmlDictPtr shared_dict;
+        try
+        {
+            shared_dict = name_dictionary_impl::acquire_for_parsing(*dict);
+        }
+        catch ( ... )
+        {
+            xmlFreeParserCtxt(ctxt);
+            throw;
+        }
+
+        use_dictionary(ctxt, shared_dict);
+    }
+    else if (arena)
+    {
+        // The parser dictionary is freed together with the parser, before
+        // the arena in which it grows, so the document must not use it.
+        ctxt->dictNames = 0;
+    }
+    else
+    {
+        // Always store the names in the document dictionary, this allows
+        // xml::qname to compare them by pointer.
+        ctxt->dictNames = 1;
+    }
+
+    if (ctxt->sax)
+        xmlFree(ctxt->sax);
+
+    ctxt->sax = &sax_;
+
+    ctxt->_private = this;
+
+    if (on_error)
+        messages_.set_limits_from(*on_error);
+    messages_.set_parser_to_stop(ctxt);
+
+    int retval;
+    {
+        arena_scope use_arena(arena);
+        retval = xmlParseDocument(ctxt);
+    }
+
+    messages_.set_parser_to_stop(nullptr);
+
+    if (!ctxt->wellFormed || retval != 0 || messages_.has_errors())
+    {
+        if (!arena)
+            xmlFreeDoc(ctxt->myDoc);
+        ctxt->myDoc = nullptr;
+        ctxt->sax = nullptr;
+        xmlFreeParserCtxt(ctxt);
+
+        if ( !messages_.has_errors() )
+            messages_.on_error(DEFAULT_ERROR);
+
+        if (on_error)
+            messages_.replay(*on_error);
+
+        return nullptr; // handle non-exception case
+    }
+
+    xmlDocPtr const doc = ctxt->myDoc;
+    ctxt->sax = nullptr;
+
+    xmlFreeParserCtxt(ctxt);
+
+    return doc;
+}
+
+
 // ------------------------------------------------------------------------
 // xml::tree_parser
 // ------------------------------------------------------------------------
 
 tree_parser::tree_parser(const char *name, bool allow_exceptions)
 {
-    init(name, allow_exceptions ? &throw_on_error : nullptr);
+    init(name, nullptr, document::individual_allocation,
+         allow_exceptions ? &throw_on_error : nullptr);
 }
 
 tree_parser::tree_parser(const char *name, error_handler& on_error)
 {
-    init(name, &on_error);
+    init(name, nullptr, document::individual_allocation, &on_error);
+}
+
+tree_parser::tree_parser(const char *name, name_dictionary& dict, error_handler& on_error)
+{
+    init(name, &dict, document::individual_allocation, &on_error);
+}
+
+tree_parser::tree_parser(const char *name, document::memory_mode mode, error_handler& on_error)
+{
+    init(name, nullptr, mode, &on_error);
 }
 
-void tree_parser::init(const char *name, error_handler *on_error)
+void tree_parser::init(const char *name,
+                       name_dictionary *dict,
+                       document::memory_mode mode,
+                       error_handler *on_error)
 {
+    in_flight_operation in_flight;
+
     pimpl_.reset(new tree_impl());
 
+    std::unique_ptr<document_arena> arena;
+    if ( mode == document::arena_allocation )
+        arena.reset(new document_arena);
+
     // Errors happening before the document is parsed, e.g. IO errors, are
     // logged using the global function and not the SAX handler callbacks, so
     // it's important to install our sink as global one in order to receive
     // these messages too.
     impl::global_errors_installer install_as_global(pimpl_->messages_);
 
-    xmlDocPtr tmpdoc = xmlSAXParseFileWithData(&(pimpl_->sax_), name, 0, pimpl_.get());
-
-    if (tmpdoc && !pimpl_->messages_.has_errors())
-    {
-        // all is fine
-        pimpl_->doc_.set_doc_data(tmpdoc);
-    }
-    else
+    xmlParserCtxtPtr ctxt = xmlCreateFileParserCtxt(name);
+    if ( !ctxt )
     {
         if ( !pimpl_->messages_.has_errors() )
         {
@@ -158,63 +263,71 @@ void tree_parser::init(const char *name, error_handler *on_error)
             pimpl_->messages_.on_error(DEFAULT_ERROR);
         }
 
-        // a problem appeared
-        if (tmpdoc)
-            xmlFreeDoc(tmpdoc);
-
         if (on_error)
             pimpl_->messages_.replay(*on_error);
+
+        return;
+    }
+
+    if ( xmlDocPtr doc = pimpl_->parse(ctxt, dict, arena.get(), on_error) )
+    {
+        if ( arena )
+            attach_document_arena(doc, std::move(arena));
+
+        pimpl_->doc_.set_doc_data(doc);
     }
 }
 
 
 tree_parser::tree_parser(const char *data, size_type size, bool allow_exceptions)
 {
-    init(data, size, allow_exceptions ? &throw_on_error : nullptr);
+    init(data, size, nullptr, document::individual_allocation,
+         allow_exceptions ? &throw_on_error : nullptr);
 }
 
 tree_parser::tree_parser(const char *data, size_type size, error_handler& on_error)
 {
-    init(data, size, &on_error);
+    init(data, size, nullptr, document::individual_allocation, &on_error);
 }
 
-void tree_parser::init(const char *data, size_type size, error_handler *on_error)
+tree_parser::tree_parser(const char *data, size_type size, name_dictionary& dict, error_handler& on_error)
 {
-    pimpl_.reset(new tree_impl());
-    xmlParserCtxtPtr ctxt;
+    init(data, size, &dict, document::individual_allocation, &on_error);
+}
 
-    if ( (ctxt = xmlCreateMemoryParserCtxt(data, xml::impl::checked_int_cast(size))) == nullptr)
-        throw std::bad_alloc();
+tree_parser::tree_parser(const char *data, size_type size, document::memory_mode mode, error_handler& on_error)
+{
+    init(data, size, nullptr, mode, &on_error);
+}
 
-    if (ctxt->sax)
-        xmlFree(ctxt->sax);
+void tree_parser::init(const char *data,
+                       size_type size,
+                       name_dictionary *dict,
+                       document::memory_mode mode,
+                       error_handler *on_error)
+{
+    in_flight_operation in_flight;
 
-    ctxt->sax = &(pimpl_->sax_);
+    pimpl_.reset(new tree_impl());
 
-    ctxt->_private = pimpl_.get();
+    std::unique_ptr<document_arena> arena;
+    if ( mode == document::arena_allocation )
+        arena.reset(new document_arena);
 
-    const int retval = xmlParseDocument(ctxt);
+    xmlParserCtxtPtr ctxt;
 
-    if (!ctxt->wellFormed || retval != 0 || pimpl_->messages_.has_errors())
-    {
-        xmlFreeDoc(ctxt->myDoc);
-        ctxt->myDoc = nullptr;
-        ctxt->sax = nullptr;
-        xmlFreeParserCtxt(ctxt);
+    if ( (ctxt = xmlCreateMemoryParserCtxt(data, xml::impl::checked_int_cast(size))) == nullptr)
+        throw std::bad_alloc();
 
-        if (on_error)
-            pimpl_->messages_.replay(*on_error);
+    if ( xmlDocPtr doc = pimpl_->parse(ctxt, dict, arena.get(), on_error) )
+    {
+        if ( arena )
+            attach_document_arena(doc, std::move(arena));
 
-        return; // handle non-exception case
+        pimpl_->doc_.set_doc_data(doc);
     }
-
-    pimpl_->doc_.set_doc_data(ctxt->myDoc);
-    ctxt->sax = nullptr;
-
-    xmlFreeParserCtxt(ctxt);
 }
 
-
 tree_parser::~tree_parser() = default;
 
 
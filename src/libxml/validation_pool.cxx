@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the helpers for validating
+    documents from several threads.
+ */
+
+#include "validation_pool.h"
+
+// standard includes
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace xml
+{
+
+namespace impl
+{
+
+void run_in_parallel(std::size_t count,
+                     unsigned num_threads,
+                     const std::function<void (std::size_t)>& func)
+{
+    if ( !num_threads )
+    {
+        num_threads = std::thread::hardware_concurrency();
+        if ( !num_threads )
+            num_threads = 1;
+    }
+
+    if ( num_threads > count )
+        num_threads = static_cast<unsigned>(count);
+
+    std::atomic<std::size_t> next(0);
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto work = [&]()
+    {
+        for ( ;; )
+        {
+            const std::size_t i = next++;
+            if ( i >= count )
+                return;
+
+            try
+            {
+                func(i);
+            }
+            catch ( ... )
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if ( !error )
+                    error = std::current_exception();
+
+                // don't start any new work
+                next = count;
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    try
+    {
+        for ( unsigned n = 1; n < num_threads; ++n )
+            threads.emplace_back(work);
+    }
+    catch ( ... )
+    {
+        // just use the threads which could be created
+    }
+
+    work();
+
+    for ( auto& t : threads )
+        t.join();
+
+    if ( error )
+        std::rethrow_exception(error);
+}
+
+} // namespace impl
+
+} // namespace xml
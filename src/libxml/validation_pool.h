@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains helpers for validating documents from several threads.
+ */
+
+#ifndef _xmlwrapp_validation_pool_h_
+#define _xmlwrapp_validation_pool_h_
+
+// standard includes
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace xml
+{
+
+namespace impl
+{
+
+// Pool of libxml2 validation contexts for the same schema.
+//
+// Creating a validation context is relatively expensive, so instead of doing
+// it for every document, the contexts are returned to the pool after use and
+// reused later, possibly by a different thread. The pool grows up to the
+// maximal number of documents validated concurrently.
+template<typename TPtr, void (*FreeFunc)(TPtr)>
+class validation_context_pool
+{
+public:
+    validation_context_pool() = default;
+
+    ~validation_context_pool()
+    {
+        for ( TPtr ctxt : contexts_ )
+            FreeFunc(ctxt);
+    }
+
+    // RAII helper taking a context from the pool, or creating a new one if
+    // the pool is empty, and returning it to the pool when it's done.
+    class lease
+    {
+    public:
+        template<typename CreateFunc>
+        lease(validation_context_pool& pool, CreateFunc create)
+            : pool_(pool), ctxt_(pool.acquire())
+        {
+            if ( !ctxt_ )
+            {
+                ctxt_ = create();
+                if ( !ctxt_ )
+                    throw std::bad_alloc();
+            }
+        }
+
+        ~lease()
+        {
+            if ( ctxt_ )
+                pool_.release(ctxt_);
+        }
+
+        TPtr get() const { return ctxt_; }
+
+        // Free the context instead of returning it to the pool, this should
+        // be done if it could have been left in an inconsistent state.
+        void discard()
+        {
+            FreeFunc(ctxt_);
+            ctxt_ = nullptr;
+        }
+
+    private:
+        validation_context_pool& pool_;
+        TPtr ctxt_;
+
+        lease(const lease&) = delete;
+        lease& operator=(const lease&) = delete;
+    };
+
+private:
+    TPtr acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if ( contexts_.empty() )
+            return nullptr;
+
+        TPtr ctxt = contexts_.back();
+        contexts_.pop_back();
+        return ctxt;
+    }
+
+    void release(TPtr ctxt)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            contexts_.push_back(ctxt);
+        }
+        catch ( ... )
+        {
+            FreeFunc(ctxt);
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<TPtr> contexts_;
+
+    validation_context_pool(const validation_context_pool&) = delete;
+    validation_context_pool& operator=(const validation_context_pool&) = delete;
+};
+
+// Call the given function for all indices in [0, count) range using the
+// given number of threads, or the number of processors if it is 0. The
+// calling thread is used as one of the workers.
+//
+// If the function throws, no new calls to it are started and the first
+// exception is rethrown after all threads finish.
+void run_in_parallel(std::size_t count,
+                     unsigned num_threads,
+                     const std::function<void (std::size_t)>& func);
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_validation_pool_h_
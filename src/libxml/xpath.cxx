@@ -37,8 +37,10 @@
 #include "xmlwrapp/node.h"
 
 #include "errors_impl.h"
+#include "init_impl.h"
 #include "node_iterator.h"
 #include "utility.h"
+#include "xpath_impl.h"
 
 // libxml includes
 #include <libxml/xmlversion.h>
@@ -46,7 +48,9 @@
 #include <libxml/xpath.h>
 #include <libxml/xpathInternals.h>
 
+#include <algorithm>
 #include <map>
+#include <utility>
 
 using namespace xml::impl;
 
@@ -110,11 +114,100 @@ inline void wrap_xmlXPathFreeObject(xmlXPathObjectPtr ptr)
     xmlXPathFreeObject(ptr);
 }
 
+xpath_value xpath_value_impl::wrap(xmlXPathObjectPtr obj)
+{
+    switch ( obj->type )
+    {
+        case XPATH_NODESET:
+        case XPATH_XSLT_TREE:
+        case XPATH_BOOLEAN:
+        case XPATH_NUMBER:
+        case XPATH_STRING:
+            break;
+
+        default:
+            // other types are not used in XPath 1.0 expressions
+            obj = xmlXPathConvertString(obj);
+    }
+
+    xpath_value value;
+    value.pimpl_.reset(new xpath_value_impl(obj));
+    return value;
+}
+
+
+xmlXPathObjectPtr xpath_value_impl::copy(const xpath_value& value)
+{
+    return xmlXPathObjectCopy(value.pimpl_->obj_);
+}
+
+
+xmlNodePtr xpath_value_impl::get_node(const node& n)
+{
+    return static_cast<xmlNodePtr>(const_cast<node&>(n).get_node_data());
+}
+
+
+const_nodes_view xpath_value_impl::make_view(xmlXPathObjectPtr obj)
+{
+    if ( xmlXPathNodeSetIsEmpty(obj->nodesetval) )
+        return const_nodes_view();
+
+    return const_nodes_view(obj->nodesetval->nodeTab[0], new nodeset_next_functor(obj));
+}
+
+
+void call_xpath_function(xmlXPathParserContextPtr ctxt,
+                         int nargs,
+                         const xpath_function& func)
+{
+    const xmlChar * const name = ctxt->context->function;
+
+    try
+    {
+        std::vector<xpath_value> args;
+        args.reserve(nargs);
+        for ( int n = 0; n < nargs; ++n )
+        {
+            xmlXPathObjectPtr arg = valuePop(ctxt);
+            if ( !arg )
+            {
+                xmlXPathErr(ctxt, XPATH_STACK_ERROR);
+                return;
+            }
+
+            args.push_back(xpath_value_impl::wrap(arg));
+        }
+
+        std::reverse(args.begin(), args.end());
+
+        const xpath_value result = func(args);
+        valuePush(ctxt, xpath_value_impl::copy(result));
+    }
+    catch ( const std::exception& e )
+    {
+        xmlGenericError(xmlGenericErrorContext,
+                        "XPath function \"%s\" failed: %s\n",
+                        reinterpret_cast<const char*>(name), e.what());
+        ctxt->error = XPATH_EXPR_ERROR;
+    }
+    catch ( ... )
+    {
+        xmlGenericError(xmlGenericErrorContext,
+                        "XPath function \"%s\" failed\n",
+                        reinterpret_cast<const char*>(name));
+        ctxt->error = XPATH_EXPR_ERROR;
+    }
+}
+
+
 struct xpath_context_impl
 {
     explicit xpath_context_impl(const document& doc) : doc_(doc)
     {
         ctxt_ = xmlXPathNewContext(static_cast<xmlDocPtr>(doc.get_doc_data_read_only()));
+        if ( ctxt_ )
+            ctxt_->userData = this;
     }
 
     ~xpath_context_impl()
@@ -132,6 +225,7 @@ struct xpath_context_impl
             throw xml::exception("node doesn't belong to context's document");
         }
 
+        in_flight_operation in_flight;
         impl::global_errors_collector err;
 
         xml_scoped_ptr<xmlXPathObjectPtr, wrap_xmlXPathFreeObject> nsptr(
@@ -152,6 +246,9 @@ struct xpath_context_impl
     const document&    doc_;
     xmlXPathContextPtr ctxt_;
 
+    // Extension functions indexed by their names and namespace URIs.
+    std::map<std::pair<std::string, std::string>, xpath_function> functions_;
+
 private:
     // non-copyable
     xpath_context_impl(const xpath_context_impl&) = delete;
@@ -161,6 +258,132 @@ private:
 } // namespace impl
 
 
+extern "C"
+{
+
+static void xpath_context_function(xmlXPathParserContextPtr ctxt, int nargs)
+{
+    auto impl = static_cast<impl::xpath_context_impl*>(ctxt->context->userData);
+
+    const xmlChar *name = ctxt->context->function;
+    const xmlChar *ns_uri = ctxt->context->functionURI;
+    auto i = impl->functions_.find(std::make_pair(
+                std::string(reinterpret_cast<const char*>(name)),
+                std::string(ns_uri ? reinterpret_cast<const char*>(ns_uri) : "")));
+    if ( i == impl->functions_.end() )
+    {
+        xmlXPathErr(ctxt, XPATH_UNKNOWN_FUNC_ERROR);
+        return;
+    }
+
+    impl::call_xpath_function(ctxt, nargs, i->second);
+}
+
+} // extern "C"
+
+
+xpath_value::xpath_value()
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewNodeSet(nullptr)))
+{
+}
+
+xpath_value::xpath_value(bool value)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewBoolean(value ? 1 : 0)))
+{
+}
+
+xpath_value::xpath_value(double value)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewFloat(value)))
+{
+}
+
+xpath_value::xpath_value(int value)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewFloat(value)))
+{
+}
+
+xpath_value::xpath_value(const std::string& value)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewString(xml_string(value))))
+{
+}
+
+xpath_value::xpath_value(const char *value)
+    : pimpl_(new impl::xpath_value_impl(
+                xmlXPathNewString(reinterpret_cast<const xmlChar*>(value))))
+{
+}
+
+xpath_value::xpath_value(const node& n)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewNodeSet(
+                impl::xpath_value_impl::get_node(n))))
+{
+}
+
+xpath_value::xpath_value(const const_nodes_view& nodes)
+    : pimpl_(new impl::xpath_value_impl(xmlXPathNewNodeSet(nullptr)))
+{
+    for ( auto const& n : nodes )
+    {
+        xmlXPathNodeSetAdd(pimpl_->obj_->nodesetval,
+                           impl::xpath_value_impl::get_node(n));
+    }
+}
+
+xpath_value::xpath_value(const xpath_value& other)
+    : pimpl_(new impl::xpath_value_impl(impl::xpath_value_impl::copy(other)))
+{
+}
+
+xpath_value& xpath_value::operator=(const xpath_value& other)
+{
+    if ( this != &other )
+        pimpl_.reset(new impl::xpath_value_impl(impl::xpath_value_impl::copy(other)));
+
+    return *this;
+}
+
+xpath_value::~xpath_value() = default;
+
+xpath_value::value_type xpath_value::get_type() const
+{
+    switch ( pimpl_->obj_->type )
+    {
+        case XPATH_BOOLEAN:
+            return type_boolean;
+        case XPATH_NUMBER:
+            return type_number;
+        case XPATH_STRING:
+            return type_string;
+        default:
+            return type_node_set;
+    }
+}
+
+bool xpath_value::as_boolean() const
+{
+    return xmlXPathCastToBoolean(pimpl_->obj_) != 0;
+}
+
+double xpath_value::as_number() const
+{
+    return xmlXPathCastToNumber(pimpl_->obj_);
+}
+
+std::string xpath_value::as_string() const
+{
+    xmlchar_helper helper(xmlXPathCastToString(pimpl_->obj_));
+    return helper.get() ? helper.get() : std::string();
+}
+
+const_nodes_view xpath_value::as_nodes() const
+{
+    if ( get_type() != type_node_set )
+        throw xml::exception("XPath value is not a node-set");
+
+    return impl::xpath_value_impl::make_view(pimpl_->obj_);
+}
+
+
 xpath_context::xpath_context(const document& doc)
     : pimpl_{new impl::xpath_context_impl(doc)}
 {
@@ -173,6 +396,18 @@ void xpath_context::register_namespace(const std::string& prefix, const std::str
     xmlXPathRegisterNs(pimpl_->ctxt_, xml_string(prefix), xml_string(href));
 }
 
+void xpath_context::register_function(const std::string& name,
+                                      const std::string& ns_uri,
+                                      xpath_function func)
+{
+    pimpl_->functions_[std::make_pair(name, ns_uri)] = std::move(func);
+
+    xmlXPathRegisterFuncNS(pimpl_->ctxt_,
+                           xml_string(name),
+                           ns_uri.empty() ? nullptr : xml_string(ns_uri),
+                           xpath_context_function);
+}
+
 const_nodes_view xpath_context::evaluate(const std::string& expr, error_handler& on_error)
 {
     return evaluate(expr, const_cast<document&>(pimpl_->doc_).get_root_node(), on_error);
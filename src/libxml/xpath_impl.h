@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the helpers used for implementing XPath extension
+    functions in xmlwrapp and xsltwrapp.
+ */
+
+#ifndef _xmlwrapp_xpath_impl_h_
+#define _xmlwrapp_xpath_impl_h_
+
+#include "xmlwrapp/xpath.h"
+
+#include <libxml/xpath.h>
+#include <libxml/xpathInternals.h>
+
+namespace xml
+{
+
+namespace impl
+{
+
+struct xpath_value_impl
+{
+    // Takes ownership of the given object.
+    explicit xpath_value_impl(xmlXPathObjectPtr obj) : obj_(obj) {}
+    ~xpath_value_impl() { xmlXPathFreeObject(obj_); }
+
+    // Create a value taking ownership of the given object.
+    static xpath_value wrap(xmlXPathObjectPtr obj);
+
+    // Return a copy of the object stored in the value.
+    static xmlXPathObjectPtr copy(const xpath_value& value);
+
+    // Helpers for converting between the nodes and the node-sets.
+    static xmlNodePtr get_node(const node& n);
+    static const_nodes_view make_view(xmlXPathObjectPtr obj);
+
+    xmlXPathObjectPtr obj_;
+
+private:
+    xpath_value_impl(const xpath_value_impl&) = delete;
+    xpath_value_impl& operator=(const xpath_value_impl&) = delete;
+};
+
+// Call the function with the arguments taken from the stack of the given
+// XPath parser context and push its result on the stack.
+//
+// If the function throws, the error is reported using libxml2 generic error
+// function and XPath evaluation is stopped.
+XMLWRAPP_API void call_xpath_function(xmlXPathParserContextPtr ctxt,
+                                      int nargs,
+                                      const xpath_function& func);
+
+} // namespace impl
+
+} // namespace xml
+
+#endif // _xmlwrapp_xpath_impl_h_
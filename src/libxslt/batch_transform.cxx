@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::batch_transform class.
+ */
+
+// xmlwrapp includes
+#include "xsltwrapp/batch_transform.h"
+#include "xsltwrapp/param_set.h"
+#include "xmlwrapp/document.h"
+#include "xmlwrapp/tree_parser.h"
+
+#include "loader.h"
+
+// standard includes
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+struct batch_transform_impl
+{
+    // State shared by the worker threads during a single run.
+    struct run_state
+    {
+        run_state(const batch_transform::input_source& source_,
+                  const batch_transform::output_sink& sink_)
+            : source(source_), sink(sink_)
+        {
+        }
+
+        const batch_transform::input_source& source;
+        const batch_transform::output_sink& sink;
+
+        // Protects all the fields below and serializes the calls to the
+        // source and the sink.
+        std::mutex mutex;
+
+        batch_transform::size_type next_index{0};
+        bool done{false};
+        std::exception_ptr error;
+
+        batch_transform::statistics stats;
+    };
+
+    batch_transform_impl(const stylesheet& style, batch_transform::size_type num_threads)
+        : style_(style), num_threads_(num_threads)
+    {
+    }
+
+    // Parse, transform and serialize a single document, return false if it
+    // failed. Notice that this is called without holding any locks.
+    bool transform(const batch_transform::input& in,
+                   batch_transform::result& res,
+                   unsigned long long& input_bytes) const;
+
+    // Function executed by each of the worker threads.
+    void work(run_state& state) const;
+
+    const stylesheet& style_;
+    batch_transform::size_type num_threads_;
+    std::unique_ptr<param_set> params_;
+};
+
+
+bool batch_transform_impl::transform(const batch_transform::input& in,
+                                     batch_transform::result& res,
+                                     unsigned long long& input_bytes) const
+{
+    std::unique_ptr<xml::tree_parser> parser;
+    if ( !in.filename.empty() )
+    {
+        input_bytes = get_file_stamp(in.filename).size;
+        parser.reset(new xml::tree_parser(in.filename.c_str(), res.errors));
+    }
+    else
+    {
+        input_bytes = in.data.size();
+        parser.reset(new xml::tree_parser(in.data.data(), in.data.size(), res.errors));
+    }
+
+    if ( !*parser )
+        return false;
+
+    xml::document result;
+    const bool ok = params_
+        ? style_.apply(parser->get_document(), result, *params_, res.errors)
+        : style_.apply(parser->get_document(), result, res.errors);
+    if ( !ok )
+        return false;
+
+    result.save_to_string(res.output);
+    return true;
+}
+
+
+void batch_transform_impl::work(run_state& state) const
+{
+    for ( ;; )
+    {
+        batch_transform::input in;
+        batch_transform::result res;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if ( state.done )
+                return;
+
+            try
+            {
+                if ( !state.source(in) )
+                {
+                    state.done = true;
+                    return;
+                }
+            }
+            catch ( ... )
+            {
+                state.error = std::current_exception();
+                state.done = true;
+                return;
+            }
+
+            res.index = state.next_index++;
+        }
+
+        res.name = in.name;
+
+        unsigned long long input_bytes = 0;
+        try
+        {
+            res.success = transform(in, res, input_bytes);
+        }
+        catch ( const std::exception& e )
+        {
+            res.errors.on_error(e.what());
+            res.success = false;
+        }
+
+        if ( !res.success )
+            res.output.clear();
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        state.stats.documents++;
+        if ( !res.success )
+            state.stats.failures++;
+        state.stats.input_bytes += input_bytes;
+        state.stats.output_bytes += res.output.size();
+
+        // don't report anything more after an error
+        if ( state.error )
+            continue;
+
+        try
+        {
+            state.sink(res);
+        }
+        catch ( ... )
+        {
+            state.error = std::current_exception();
+            state.done = true;
+        }
+    }
+}
+
+} // namespace impl
+
+
+double batch_transform::statistics::documents_per_second() const
+{
+    if ( elapsed.count() <= 0 )
+        return 0;
+
+    return documents * 1e6 / elapsed.count();
+}
+
+
+double batch_transform::statistics::bytes_per_second() const
+{
+    if ( elapsed.count() <= 0 )
+        return 0;
+
+    return input_bytes * 1e6 / elapsed.count();
+}
+
+
+batch_transform::batch_transform(const stylesheet& style, size_type num_threads)
+{
+    if ( !num_threads )
+    {
+        num_threads = std::thread::hardware_concurrency();
+        if ( !num_threads )
+            num_threads = 1;
+    }
+
+    pimpl_.reset(new impl::batch_transform_impl(style, num_threads));
+}
+
+
+batch_transform::~batch_transform() = default;
+
+
+batch_transform::size_type batch_transform::get_num_threads() const
+{
+    return pimpl_->num_threads_;
+}
+
+
+void batch_transform::set_params(const param_set& params)
+{
+    pimpl_->params_.reset(new param_set(params));
+}
+
+
+batch_transform::statistics
+batch_transform::run(const input_source& source, const output_sink& sink)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    impl::batch_transform_impl::run_state state(source, sink);
+
+    std::vector<std::thread> threads;
+    try
+    {
+        for ( size_type n = 0; n < pimpl_->num_threads_; ++n )
+            threads.emplace_back(&impl::batch_transform_impl::work, pimpl_.get(), std::ref(state));
+    }
+    catch ( ... )
+    {
+        // stop the threads which were already created
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.done = true;
+        }
+
+        for ( auto& t : threads )
+            t.join();
+
+        throw;
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    if ( state.error )
+        std::rethrow_exception(state.error);
+
+    state.stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start);
+
+    return state.stats;
+}
+
+
+batch_transform::statistics
+batch_transform::run(const std::vector<std::string>& filenames, const output_sink& sink)
+{
+    auto i = filenames.begin();
+    return run([&i, &filenames](input& next)
+               {
+                   if ( i == filenames.end() )
+                       return false;
+
+                   next.name = next.filename = *i++;
+                   return true;
+               },
+               sink);
+}
+
+} // namespace xslt
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::document_cache class.
+ */
+
+// xmlwrapp includes
+#include "xsltwrapp/document_cache.h"
+#include "xmlwrapp/errors.h"
+
+#include "document_cache_impl.h"
+
+namespace xslt
+{
+
+namespace impl
+{
+
+namespace
+{
+
+size_t estimate_text_memory(const xmlChar *text)
+{
+    return text ? xmlStrlen(text) + 1 : 0;
+}
+
+// Estimate the memory used by the given document: this only takes into
+// account the nodes and their contents, as the names are normally stored
+// in the document dictionary only once.
+size_t estimate_memory(xmlDocPtr doc)
+{
+    size_t total = sizeof(xmlDoc);
+
+    xmlNodePtr node = doc->children;
+    while ( node )
+    {
+        total += sizeof(xmlNode);
+
+        // Only the nodes of these types are really xmlNode structs, the DTD
+        // declarations use different structs.
+        switch ( node->type )
+        {
+            case XML_ELEMENT_NODE:
+                for ( xmlNsPtr ns = node->nsDef; ns; ns = ns->next )
+                    total += sizeof(xmlNs) + estimate_text_memory(ns->href);
+
+                for ( xmlAttrPtr attr = node->properties; attr; attr = attr->next )
+                {
+                    total += sizeof(xmlAttr);
+                    for ( xmlNodePtr v = attr->children; v; v = v->next )
+                        total += sizeof(xmlNode) + estimate_text_memory(v->content);
+                }
+                break;
+
+            case XML_TEXT_NODE:
+            case XML_CDATA_SECTION_NODE:
+            case XML_COMMENT_NODE:
+            case XML_PI_NODE:
+                total += estimate_text_memory(node->content);
+                break;
+
+            default:
+                break;
+        }
+
+        if ( node->type == XML_ELEMENT_NODE && node->children )
+        {
+            node = node->children;
+            continue;
+        }
+
+        while ( node && !node->next )
+        {
+            node = node->parent;
+            if ( node == reinterpret_cast<xmlNodePtr>(doc) )
+                node = nullptr;
+        }
+
+        if ( node )
+            node = node->next;
+    }
+
+    return total;
+}
+
+} // anonymous namespace
+
+
+xmlDocPtr document_cache_impl::load(const xmlChar *uri,
+                                    xmlDictPtr dict,
+                                    int options,
+                                    void *ctxt,
+                                    xsltLoadType type)
+{
+    if ( type != XSLT_LOAD_DOCUMENT )
+        return load_default(uri, dict, options, ctxt, type);
+
+    const std::string key(reinterpret_cast<const char*>(uri));
+
+    std::string path;
+    file_stamp stamp;
+    if ( uri_to_path(uri, path) )
+        stamp = get_file_stamp(path);
+
+    std::shared_ptr<xmlDoc> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto i = entries_.find(key);
+        if ( i != entries_.end() )
+        {
+            if ( i->second.stamp == stamp )
+            {
+                cached = i->second.doc;
+                lru_.splice(lru_.begin(), lru_, i->second.lru_pos);
+                stats_.hits++;
+            }
+            else
+            {
+                // the file was modified
+                erase(i);
+            }
+        }
+    }
+
+    // libxslt takes ownership of the document and modifies it, so it must
+    // get a copy of the cached one
+    if ( cached )
+        return xmlCopyDoc(cached.get(), 1);
+
+    // Don't use the transformation dictionary for the cached document, as it
+    // is going to outlive the transformation.
+    xmlDocPtr doc = load_default(uri, nullptr, options, ctxt, type);
+    if ( !doc )
+        return nullptr;
+
+    xmlDocPtr copy = xmlCopyDoc(doc, 1);
+    if ( !copy )
+        return doc;
+
+    entry e;
+    e.doc.reset(doc, xmlFreeDoc);
+    e.stamp = stamp;
+    e.memory = estimate_memory(doc);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stats_.misses++;
+    store(key, std::move(e));
+
+    return copy;
+}
+
+
+void document_cache_impl::store(const std::string& uri, entry&& e)
+{
+    auto i = entries_.find(uri);
+    if ( i != entries_.end() )
+        erase(i);
+
+    // don't evict everything else to store a document which doesn't fit
+    if ( e.memory > max_memory_ )
+        return;
+
+    memory_used_ += e.memory;
+
+    entry& stored = entries_.emplace(uri, std::move(e)).first->second;
+    stored.lru_pos = lru_.insert(lru_.begin(), uri);
+
+    evict_excess();
+}
+
+
+void document_cache_impl::erase(std::unordered_map<std::string, entry>::iterator i)
+{
+    memory_used_ -= i->second.memory;
+    lru_.erase(i->second.lru_pos);
+    entries_.erase(i);
+}
+
+
+void document_cache_impl::evict_excess()
+{
+    while ( memory_used_ > max_memory_ )
+    {
+        erase(entries_.find(lru_.back()));
+        stats_.evictions++;
+    }
+}
+
+} // namespace impl
+
+
+document_cache::document_cache(size_type max_memory)
+{
+    if ( !max_memory )
+        throw xml::exception("document cache size must be positive");
+
+    pimpl_.reset(new impl::document_cache_impl(max_memory));
+}
+
+
+document_cache::~document_cache() = default;
+
+
+bool document_cache::remove(const char *uri)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    auto i = pimpl_->entries_.find(uri);
+    if ( i == pimpl_->entries_.end() )
+        return false;
+
+    pimpl_->erase(i);
+    return true;
+}
+
+
+void document_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    pimpl_->entries_.clear();
+    pimpl_->lru_.clear();
+    pimpl_->memory_used_ = 0;
+}
+
+
+document_cache::size_type document_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->entries_.size();
+}
+
+
+document_cache::size_type document_cache::get_memory_used() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->memory_used_;
+}
+
+
+document_cache::size_type document_cache::get_max_memory() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->max_memory_;
+}
+
+
+void document_cache::set_max_memory(size_type max_memory)
+{
+    if ( !max_memory )
+        throw xml::exception("document cache size must be positive");
+
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    pimpl_->max_memory_ = max_memory;
+    pimpl_->evict_excess();
+}
+
+
+document_cache::statistics document_cache::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->stats_;
+}
+
+} // namespace xslt
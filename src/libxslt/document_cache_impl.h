@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the private part of the xslt::document_cache class.
+ */
+
+#ifndef _xsltwrapp_document_cache_impl_h_
+#define _xsltwrapp_document_cache_impl_h_
+
+#include "xsltwrapp/document_cache.h"
+
+#include "loader.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+// The cache is used as the loader during the transformations using it.
+struct document_cache_impl : public doc_loader
+{
+    using size_type = document_cache::size_type;
+
+    struct entry
+    {
+        // The cached document is never given to libxslt, it gets its copies.
+        // It is reference counted to allow copying it without holding the
+        // lock while it can be removed from the cache by another thread.
+        std::shared_ptr<xmlDoc> doc;
+
+        // Only used for the documents loaded from local files.
+        file_stamp stamp;
+
+        size_type memory;
+
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    static document_cache_impl& get(document_cache& c) { return *c.pimpl_; }
+
+    explicit document_cache_impl(size_type max_memory) : max_memory_(max_memory) {}
+
+    xmlDocPtr load(const xmlChar *uri,
+                   xmlDictPtr dict,
+                   int options,
+                   void *ctxt,
+                   xsltLoadType type) override;
+
+    // These functions must be called with the mutex locked.
+    void store(const std::string& uri, entry&& e);
+    void erase(std::unordered_map<std::string, entry>::iterator i);
+    void evict_excess();
+
+    mutable std::mutex mutex_;
+
+    size_type max_memory_;
+    size_type memory_used_{0};
+
+    std::unordered_map<std::string, entry> entries_;
+
+    // Keys of the entries, from the most to the least recently used one.
+    std::list<std::string> lru_;
+
+    document_cache::statistics stats_;
+};
+
+} // namespace impl
+
+} // namespace xslt
+
+#endif // _xsltwrapp_document_cache_impl_h_
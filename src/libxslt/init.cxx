@@ -44,6 +44,11 @@
 #include <libxslt/xsltutils.h>
 #include <libexslt/exslt.h>
 
+#include "loader.h"
+#include "../libxml/init_impl.h"
+
+#include <mutex>
+
 extern "C"
 {
 
@@ -56,20 +61,52 @@ static void xslt_error(void *, const char*, ...)
 } // extern "C"
 
 
-int xslt::init::ms_counter = 0;
+namespace
+{
+
+// This is never freed for the same reasons as xml::init state.
+struct library_state
+{
+    std::mutex init_mutex;
+    int init_counter{0};
+};
+
+library_state& get_library_state()
+{
+    static library_state* const state = new library_state;
+    return *state;
+}
+
+} // anonymous namespace
 
 
 xslt::init::init()
 {
-    if ( ms_counter++ == 0 )
+    library_state& state = get_library_state();
+
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+    if ( state.init_counter++ == 0 )
+    {
         init_library();
+
+        // libxslt must be restarted too if xml::init::set_allocator() is
+        // called while it is initialized
+        xml::impl::set_restart_hooks(&shutdown_library, &init_library);
+    }
 }
 
 
 xslt::init::~init()
 {
-    if ( --ms_counter == 0 )
+    library_state& state = get_library_state();
+
+    std::lock_guard<std::mutex> lock(state.init_mutex);
+    if ( --state.init_counter == 0 )
+    {
+        xml::impl::wait_for_operations();
+        xml::impl::set_restart_hooks(nullptr, nullptr);
         shutdown_library();
+    }
 }
 
 
@@ -91,11 +128,16 @@ void xslt::init::init_library()
 
     // load EXSLT
     exsltRegisterAll();
+
+    // allow xsltwrapp classes to take over loading of imported stylesheets
+    // and documents
+    impl::doc_loader::install_hook();
 }
 
 
 void xslt::init::shutdown_library()
 {
+    impl::doc_loader::uninstall_hook();
     xsltCleanupGlobals();
 }
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the libxslt loader hook.
+ */
+
+#include "loader.h"
+
+#include <libxml/uri.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace
+{
+
+// The loader function which was installed before ours.
+xsltDocLoaderFunc g_default_loader = nullptr;
+
+// The loader active in the current thread.
+thread_local xslt::impl::doc_loader *g_current_loader = nullptr;
+
+} // anonymous namespace
+
+extern "C"
+{
+
+static xmlDocPtr xslt_forwarding_loader(const xmlChar *uri,
+                                        xmlDictPtr dict,
+                                        int options,
+                                        void *ctxt,
+                                        xsltLoadType type)
+{
+    if ( g_current_loader )
+        return g_current_loader->load(uri, dict, options, ctxt, type);
+
+    return xslt::impl::doc_loader::load_default(uri, dict, options, ctxt, type);
+}
+
+} // extern "C"
+
+
+namespace xslt
+{
+
+namespace impl
+{
+
+xmlDocPtr doc_loader::load_default(const xmlChar *uri,
+                                   xmlDictPtr dict,
+                                   int options,
+                                   void *ctxt,
+                                   xsltLoadType type)
+{
+    return g_default_loader(uri, dict, options, ctxt, type);
+}
+
+
+void doc_loader::install_hook()
+{
+    // don't lose the default loader if we're called more than once
+    if ( xsltDocDefaultLoader != xslt_forwarding_loader )
+        g_default_loader = xsltDocDefaultLoader;
+
+    xsltSetLoaderFunc(xslt_forwarding_loader);
+}
+
+
+void doc_loader::uninstall_hook()
+{
+    if ( xsltDocDefaultLoader == xslt_forwarding_loader )
+        xsltSetLoaderFunc(g_default_loader);
+}
+
+
+doc_loader_scope::doc_loader_scope(doc_loader& loader)
+    : previous_(g_current_loader)
+{
+    g_current_loader = &loader;
+}
+
+
+doc_loader_scope::~doc_loader_scope()
+{
+    g_current_loader = previous_;
+}
+
+
+file_stamp get_file_stamp(const std::string& path)
+{
+    file_stamp stamp;
+
+    struct stat st;
+    if ( stat(path.c_str(), &st) == 0 )
+    {
+        stamp.exists = true;
+        stamp.mtime = st.st_mtime;
+#ifdef __linux__
+        stamp.mtime_ns = st.st_mtim.tv_nsec;
+#endif
+        stamp.size = st.st_size;
+    }
+
+    return stamp;
+}
+
+
+bool uri_to_path(const xmlChar *uri, std::string& path)
+{
+    xmlURIPtr parsed = xmlParseURI(reinterpret_cast<const char*>(uri));
+    if ( !parsed )
+        return false;
+
+    bool ok = true;
+    if ( !parsed->scheme )
+        path = reinterpret_cast<const char*>(uri);
+    else if ( parsed->path && xmlStrEqual(BAD_CAST parsed->scheme, BAD_CAST "file") )
+        path = parsed->path;
+    else
+        ok = false;
+
+    xmlFreeURI(parsed);
+    return ok;
+}
+
+} // namespace impl
+
+} // namespace xslt
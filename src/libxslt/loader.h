@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the interface used for intercepting the documents
+    loaded by libxslt.
+ */
+
+#ifndef _xsltwrapp_loader_h_
+#define _xsltwrapp_loader_h_
+
+#include <libxml/tree.h>
+#include <libxslt/documents.h>
+
+#include <string>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+// Interface of the objects loading the documents needed by libxslt, i.e. the
+// stylesheets imported or included by another one when compiling it and the
+// documents loaded by document() function during the transformation.
+//
+// libxslt only allows to set a single global loader function, so we install
+// one when the library is initialized and it forwards the requests to the
+// loader made active in the current thread by doc_loader_scope, if any, or to
+// the default libxslt loader otherwise.
+class doc_loader
+{
+public:
+    // The parameters have the same meaning as for xsltDocLoaderFunc.
+    virtual xmlDocPtr load(const xmlChar *uri,
+                           xmlDictPtr dict,
+                           int options,
+                           void *ctxt,
+                           xsltLoadType type) = 0;
+
+    // Load the document using the loader which was installed before
+    // xsltwrapp initialization, normally the default libxslt one.
+    static xmlDocPtr load_default(const xmlChar *uri,
+                                  xmlDictPtr dict,
+                                  int options,
+                                  void *ctxt,
+                                  xsltLoadType type);
+
+    // Install and uninstall the global forwarding loader function, these
+    // functions are only used by xslt::init.
+    static void install_hook();
+    static void uninstall_hook();
+
+protected:
+    doc_loader() = default;
+    ~doc_loader() = default;
+};
+
+// Makes the given loader active in the current thread during this object
+// lifetime.
+class doc_loader_scope
+{
+public:
+    explicit doc_loader_scope(doc_loader& loader);
+    ~doc_loader_scope();
+
+private:
+    doc_loader *previous_;
+
+    doc_loader_scope(const doc_loader_scope&) = delete;
+    doc_loader_scope& operator=(const doc_loader_scope&) = delete;
+};
+
+
+// Information used by the loaders caching the documents to detect
+// modifications of the files they were loaded from.
+struct file_stamp
+{
+    bool exists{false};
+    long long mtime{0};
+    long mtime_ns{0};
+    long long size{0};
+
+    bool operator==(const file_stamp& other) const
+    {
+        return exists == other.exists &&
+               mtime == other.mtime &&
+               mtime_ns == other.mtime_ns &&
+               size == other.size;
+    }
+
+    bool operator!=(const file_stamp& other) const { return !(*this == other); }
+};
+
+// Get the stamp of the given file, its "exists" field is false if the file
+// couldn't be accessed.
+file_stamp get_file_stamp(const std::string& path);
+
+// Get the local file name corresponding to the URI of a loaded document,
+// returns false if it's not a local file.
+bool uri_to_path(const xmlChar *uri, std::string& path);
+
+} // namespace impl
+
+} // namespace xslt
+
+#endif // _xsltwrapp_loader_h_
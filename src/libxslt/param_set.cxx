@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::param_set class.
+ */
+
+// xmlwrapp includes
+#include "xsltwrapp/param_set.h"
+#include "xmlwrapp/errors.h"
+
+#include "param_set_impl.h"
+#include "../libxml/errors_impl.h"
+
+// libxml2 and libxslt includes
+#include <libxml/xpath.h>
+#include <libxslt/variables.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <sstream>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+void param_set_impl::set(const char *name, const std::string& value, bool is_expression)
+{
+    for ( auto& p : params_ )
+    {
+        if ( p.name == name )
+        {
+            p.value = value;
+            p.is_expression = is_expression;
+            update_expressions();
+            return;
+        }
+    }
+
+    params_.push_back(param{name, value, is_expression});
+    update_expressions();
+}
+
+
+bool param_set_impl::remove(const char *name)
+{
+    auto i = std::find_if(params_.begin(), params_.end(),
+                          [name](const param& p) { return p.name == name; });
+    if ( i == params_.end() )
+        return false;
+
+    params_.erase(i);
+    update_expressions();
+    return true;
+}
+
+
+bool param_set_impl::quote_strings(xsltTransformContextPtr ctxt) const
+{
+    for ( auto const& p : params_ )
+    {
+        if ( p.is_expression )
+            continue;
+
+        if ( xsltQuoteOneUserParam(ctxt,
+                                   reinterpret_cast<const xmlChar*>(p.name.c_str()),
+                                   reinterpret_cast<const xmlChar*>(p.value.c_str())) != 0 )
+            return false;
+    }
+
+    return true;
+}
+
+
+const char **param_set_impl::get_expressions() const
+{
+    if ( expressions_.size() < 2 )
+        return nullptr;
+
+    return const_cast<const char**>(&expressions_[0]);
+}
+
+
+void param_set_impl::update_expressions()
+{
+    expressions_.clear();
+
+    for ( auto const& p : params_ )
+    {
+        if ( p.is_expression )
+        {
+            expressions_.push_back(p.name.c_str());
+            expressions_.push_back(p.value.c_str());
+        }
+    }
+
+    expressions_.push_back(nullptr);
+}
+
+} // namespace impl
+
+
+param_set::param_set()
+    : pimpl_(new impl::param_set_impl)
+{
+}
+
+
+param_set::param_set(const param_set& other)
+    : pimpl_(new impl::param_set_impl)
+{
+    *this = other;
+}
+
+
+param_set& param_set::operator=(const param_set& other)
+{
+    // the pointers in the expressions array must point to our own strings
+    pimpl_->params_ = other.pimpl_->params_;
+    pimpl_->update_expressions();
+    return *this;
+}
+
+
+param_set::~param_set() = default;
+
+
+param_set& param_set::set_string(const char *name, const std::string& value)
+{
+    pimpl_->set(name, value, false);
+    return *this;
+}
+
+
+param_set& param_set::set_number(const char *name, double value)
+{
+    std::string expr;
+    if ( std::isnan(value) )
+    {
+        expr = "0 div 0";
+    }
+    else if ( std::isinf(value) )
+    {
+        expr = value > 0 ? "1 div 0" : "-1 div 0";
+    }
+    else
+    {
+        // use the representation which can be read back exactly and doesn't
+        // depend on the current locale
+        std::ostringstream ostr;
+        ostr.imbue(std::locale::classic());
+        ostr.precision(17);
+        ostr << value;
+        expr = ostr.str();
+    }
+
+    pimpl_->set(name, expr, true);
+    return *this;
+}
+
+
+param_set& param_set::set_boolean(const char *name, bool value)
+{
+    pimpl_->set(name, value ? "true()" : "false()", true);
+    return *this;
+}
+
+
+param_set& param_set::set_expression(const char *name, const std::string& xpath)
+{
+    // check the expression validity now instead of failing the
+    // transformations using it later
+    {
+        xml::impl::global_errors_collector err;
+
+        xmlXPathCompExprPtr
+            comp = xmlXPathCompile(reinterpret_cast<const xmlChar*>(xpath.c_str()));
+        if ( !comp )
+            throw xml::exception("invalid XPath expression \"" + xpath + "\" for parameter \"" + name + "\"");
+
+        xmlXPathFreeCompExpr(comp);
+    }
+
+    pimpl_->set(name, xpath, true);
+    return *this;
+}
+
+
+bool param_set::remove(const char *name)
+{
+    return pimpl_->remove(name);
+}
+
+
+void param_set::clear()
+{
+    pimpl_->params_.clear();
+    pimpl_->update_expressions();
+}
+
+
+param_set::size_type param_set::size() const
+{
+    return pimpl_->params_.size();
+}
+
+} // namespace xslt
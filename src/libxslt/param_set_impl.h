@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the private part of the xslt::param_set class.
+ */
+
+#ifndef _xsltwrapp_param_set_impl_h_
+#define _xsltwrapp_param_set_impl_h_
+
+#include "xsltwrapp/param_set.h"
+
+#include <libxslt/xsltInternals.h>
+
+#include <string>
+#include <vector>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+struct param_set_impl
+{
+    struct param
+    {
+        std::string name;
+        std::string value;
+
+        // If true, value is an XPath expression, otherwise a literal string.
+        bool is_expression;
+    };
+
+    static const param_set_impl& get(const param_set& p) { return *p.pimpl_; }
+
+    void set(const char *name, const std::string& value, bool is_expression);
+    bool remove(const char *name);
+
+    // Pass the literal string parameters to the given transformation
+    // context, this must be called before starting the transformation.
+    bool quote_strings(xsltTransformContextPtr ctxt) const;
+
+    // Get the array of the expression parameters in the format expected by
+    // xsltApplyStylesheetUser(), may return nullptr if there are none.
+    const char **get_expressions() const;
+
+    // Must be called after any change to params_.
+    void update_expressions();
+
+    std::vector<param> params_;
+
+    // NULL-terminated array of pointers to the names and values of the
+    // expression parameters in params_.
+    std::vector<const char*> expressions_;
+};
+
+} // namespace impl
+
+} // namespace xslt
+
+#endif // _xsltwrapp_param_set_impl_h_
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::pipeline class.
+ */
+
+// xmlwrapp includes
+#include "xsltwrapp/pipeline.h"
+#include "xsltwrapp/param_set.h"
+
+#include "stylesheet_impl.h"
+
+// standard includes
+#include <utility>
+#include <vector>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+struct pipeline_impl
+{
+    struct stage
+    {
+        const stylesheet::pimpl *style;
+
+        // Only used to keep the shared stylesheet alive, may be null.
+        std::shared_ptr<const stylesheet> owner;
+
+        // Only non-null if this stage has parameters.
+        std::shared_ptr<const param_set> params;
+    };
+
+    // Apply all the stages and return the final result, which must be freed
+    // by the caller, or nullptr on error.
+    xmlDocPtr apply(xmlDocPtr input, xml::error_handler& on_error) const;
+
+    xsltStylesheetPtr get_output_stylesheet() const
+    {
+        return stages_.back().style->ss_;
+    }
+
+    std::vector<stage> stages_;
+};
+
+
+xmlDocPtr pipeline_impl::apply(xmlDocPtr input, xml::error_handler& on_error) const
+{
+    if ( stages_.empty() )
+        throw xml::exception("can't apply an empty XSLT pipeline");
+
+    xmlDocPtr doc = input;
+    for ( auto const& s : stages_ )
+    {
+        xmlDocPtr result;
+        try
+        {
+            result = apply_stylesheet(*s.style, on_error, doc, nullptr, nullptr, s.params.get());
+        }
+        catch ( ... )
+        {
+            if ( doc != input )
+                xmlFreeDoc(doc);
+            throw;
+        }
+
+        // the intermediate results are not needed any more
+        if ( doc != input )
+            xmlFreeDoc(doc);
+
+        if ( !result )
+            return nullptr;
+
+        doc = result;
+    }
+
+    return doc;
+}
+
+} // namespace impl
+
+
+pipeline::pipeline()
+    : pimpl_(new impl::pipeline_impl)
+{
+}
+
+
+pipeline::~pipeline() = default;
+
+
+pipeline& pipeline::add(const stylesheet& style)
+{
+    pimpl_->stages_.push_back({style.pimpl_.get(), nullptr, nullptr});
+    return *this;
+}
+
+
+pipeline& pipeline::add(const stylesheet& style, const param_set& params)
+{
+    pimpl_->stages_.push_back({style.pimpl_.get(),
+                               nullptr,
+                               std::make_shared<const param_set>(params)});
+    return *this;
+}
+
+
+pipeline& pipeline::add(std::shared_ptr<const stylesheet> style)
+{
+    const stylesheet::pimpl *p = style->pimpl_.get();
+    pimpl_->stages_.push_back({p, std::move(style), nullptr});
+    return *this;
+}
+
+
+pipeline& pipeline::add(std::shared_ptr<const stylesheet> style, const param_set& params)
+{
+    const stylesheet::pimpl *p = style->pimpl_.get();
+    pimpl_->stages_.push_back({p,
+                               std::move(style),
+                               std::make_shared<const param_set>(params)});
+    return *this;
+}
+
+
+pipeline::size_type pipeline::size() const
+{
+    return pimpl_->stages_.size();
+}
+
+
+bool pipeline::apply(const xml::document& doc,
+                     xml::document& result,
+                     xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = pimpl_->apply(input, on_error);
+    if ( !xmldoc )
+        return false;
+
+    xsltStylesheetPtr ss = pimpl_->get_output_stylesheet();
+    result.set_doc_data_from_xslt(xmldoc, new impl::result_impl(xmldoc, ss));
+    return true;
+}
+
+
+bool pipeline::apply_to_stream(const xml::document& doc,
+                               std::ostream& stream,
+                               xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = pimpl_->apply(input, on_error);
+    if ( !xmldoc )
+        return false;
+
+    return impl::save_result_to_stream(xmldoc, pimpl_->get_output_stylesheet(), stream, on_error);
+}
+
+
+bool pipeline::apply_to_fd(const xml::document& doc,
+                           int fd,
+                           xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = pimpl_->apply(input, on_error);
+    if ( !xmldoc )
+        return false;
+
+    return impl::save_result_to_fd(xmldoc, pimpl_->get_output_stylesheet(), fd, on_error);
+}
+
+} // namespace xslt
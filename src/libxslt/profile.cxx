@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::profile class.
+ */
+
+#include "xsltwrapp/profile.h"
+
+#include <algorithm>
+
+namespace xslt
+{
+
+std::chrono::microseconds profile::total_time() const
+{
+    std::chrono::microseconds total{0};
+    for ( auto const& t : templates_ )
+        total += t.time;
+
+    return total;
+}
+
+
+void profile::merge(const profile& other)
+{
+    for ( auto const& t : other.templates_ )
+        add(t);
+
+    transformations_ += other.transformations_;
+}
+
+
+void profile::clear()
+{
+    templates_.clear();
+    transformations_ = 0;
+}
+
+
+void profile::add(const template_profile& templ)
+{
+    auto i = std::find_if(templates_.begin(), templates_.end(),
+                          [&templ](const template_profile& t)
+                          {
+                              return t.name == templ.name &&
+                                     t.match == templ.match &&
+                                     t.mode == templ.mode;
+                          });
+
+    if ( i == templates_.end() )
+    {
+        templates_.push_back(templ);
+        i = templates_.end() - 1;
+    }
+    else
+    {
+        i->calls += templ.calls;
+        i->time += templ.time;
+    }
+
+    // keep the templates sorted by time, moving the updated one up if needed
+    while ( i != templates_.begin() && (i - 1)->time < i->time )
+    {
+        std::iter_swap(i - 1, i);
+        --i;
+    }
+}
+
+} // namespace xslt
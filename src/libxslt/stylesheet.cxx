@@ -39,131 +39,323 @@
 
 // xmlwrapp includes
 #include "xsltwrapp/stylesheet.h"
+#include "xsltwrapp/profile.h"
+#include "xsltwrapp/param_set.h"
 #include "xmlwrapp/document.h"
 #include "xmlwrapp/tree_parser.h"
 #include "xmlwrapp/errors.h"
 
-#include "result.h"
-#include "../libxml/utility.h"
+#include "stylesheet_impl.h"
+#include "document_cache_impl.h"
+#include "param_set_impl.h"
 #include "../libxml/errors_impl.h"
+#include "../libxml/init_impl.h"
+#include "../libxml/xpath_impl.h"
 
 // libxslt includes
 #include <libxslt/xslt.h>
 #include <libxslt/xsltInternals.h>
 #include <libxslt/transform.h>
 #include <libxslt/xsltutils.h>
+#include <libxslt/imports.h>
+#include <libxslt/extensions.h>
 
 // standard includes
 #include <memory>
+#include <mutex>
+#include <ostream>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
 
-struct xslt::stylesheet::pimpl
+namespace
+{
+
+void make_vector_param(std::vector<const char*> &v,
+                       const xslt::stylesheet::param_type &p)
 {
-    pimpl () = default;
+    v.reserve(p.size());
+
+    for (auto const& param : p)
+    {
+        v.push_back(param.first.c_str());
+        v.push_back(param.second.c_str());
+    }
+
+    v.push_back(nullptr);
+}
 
-    xsltStylesheetPtr ss_{nullptr};
-    xml::document doc_;
-    std::string get_error_message_cache_;
-    bool errors_occured_{false};
+
+class xslt_errors_collector : public xml::impl::errors_collector
+{
+public:
+    xslt_errors_collector(xsltTransformContextPtr c) : ctxt_(c) {}
+
+    void on_message(const xml::error_message& msg) override
+    {
+        xml::impl::errors_collector::on_message(msg);
+
+        // tell the processor to stop when it gets a chance:
+        if ( msg.type() == xml::error_message::type_error &&
+                ctxt_->state == XSLT_STATE_OK )
+            ctxt_->state = XSLT_STATE_STOPPED;
+    }
+
+    xsltTransformContextPtr ctxt_;
 };
 
-namespace
+extern "C"
 {
 
-// implementation of xslt::result using xslt::stylesheet: we pass this object
-// to xml::document for the documents obtained via XSLT so that some operations
-// (currently only saving) could be done differently for them
-class result_impl : public xslt::impl::result
+static void xslt_extension_function(xmlXPathParserContextPtr ctxt, int nargs)
+{
+    xsltTransformContextPtr tctxt = xsltXPathGetTransformContext(ctxt);
+    auto impl = static_cast<const xslt::stylesheet::pimpl*>(tctxt->_private);
+
+    const xmlChar *name = ctxt->context->function;
+    const xmlChar *ns_uri = ctxt->context->functionURI;
+    auto i = impl->functions_.find(std::make_pair(
+                std::string(reinterpret_cast<const char*>(name)),
+                std::string(ns_uri ? reinterpret_cast<const char*>(ns_uri) : "")));
+    if ( i == impl->functions_.end() )
+    {
+        xmlXPathErr(ctxt, XPATH_UNKNOWN_FUNC_ERROR);
+        return;
+    }
+
+    xml::impl::call_xpath_function(ctxt, nargs, i->second);
+}
+
+} // extern "C"
+
+// Helper collecting the profiling information for a single transformation.
+//
+// libxslt accumulates the number of calls and time spent in each template in
+// the template itself, so we remember their values before the transformation
+// and compute the difference after it.
+class profile_collector
 {
 public:
-    // We don't own the pointers given to us, their lifetime must be greater
-    // than the lifetime of this object.
-    result_impl(xmlDocPtr doc, xsltStylesheetPtr ss) : doc_(doc), ss_(ss) {}
+    profile_collector(const xslt::stylesheet::pimpl& impl, xslt::profile& prof)
+        : lock_(impl.profiling_mutex_), style_(impl.ss_), profile_(prof)
+    {
+        for_each_template([this](xsltTemplatePtr templ)
+        {
+            initial_.push_back(initial_values{templ->nbCalls, templ->time});
+        });
+    }
 
-    void save_to_string(std::string &s) const override
+    void enable(xsltTransformContextPtr ctxt)
     {
-        xmlChar *xml_string;
-        int xml_string_length;
+        ctxt->profile = 1;
+    }
 
-        if (xsltSaveResultToString(&xml_string, &xml_string_length, doc_, ss_) >= 0)
+    void collect()
+    {
+        auto initial = initial_.begin();
+        for_each_template([this, &initial](xsltTemplatePtr templ)
         {
-            xml::impl::xmlchar_helper helper(xml_string);
-            if (xml_string_length)
-                s.assign(helper.get(), xml::impl::checked_size_t_cast(xml_string_length));
-        }
+            const initial_values& before = *initial++;
+            if ( templ->nbCalls == before.calls )
+                return;
+
+            xslt::template_profile t;
+            if ( templ->name )
+                t.name = reinterpret_cast<const char*>(templ->name);
+            if ( templ->match )
+                t.match = reinterpret_cast<const char*>(templ->match);
+            if ( templ->mode )
+                t.mode = reinterpret_cast<const char*>(templ->mode);
+            t.calls = static_cast<unsigned long>(templ->nbCalls - before.calls);
+            t.time = std::chrono::microseconds(
+                        (templ->time - before.time) * (1000000l / XSLT_TIMESTAMP_TICS_PER_SEC));
+
+            profile_.add(t);
+        });
+
+        profile_.add_transformation();
     }
 
-    bool
-    save_to_file(const char *filename, int /* compression_level */) const override
+private:
+    template <typename F>
+    void for_each_template(F func)
     {
-        return xsltSaveResultToFilename(filename, doc_, ss_, 0) >= 0;
+        for ( xsltStylesheetPtr st = style_; st; st = xsltNextImport(st) )
+        {
+            for ( xsltTemplatePtr templ = st->templates; templ; templ = templ->next )
+                func(templ);
+        }
     }
 
-private:
-    xmlDocPtr doc_;
-    xsltStylesheetPtr ss_;
+    struct initial_values
+    {
+        int calls;
+        unsigned long time;
+    };
+
+    std::lock_guard<std::mutex> lock_;
+    xsltStylesheetPtr style_;
+    xslt::profile& profile_;
+    std::vector<initial_values> initial_;
 };
 
 
-void make_vector_param(std::vector<const char*> &v,
-                       const xslt::stylesheet::param_type &p)
+// Get the encoder for the output encoding specified by the stylesheet, if
+// any, in the same way as xsltSaveResultToFile() and the other functions do.
+xmlCharEncodingHandlerPtr get_output_encoder(xsltStylesheetPtr style)
 {
-    v.reserve(p.size());
+    const xmlChar *encoding;
+    XSLT_GET_IMPORT_PTR(encoding, style, encoding)
+    if ( !encoding )
+        return nullptr;
 
-    for (auto const& param : p)
+    xmlCharEncodingHandlerPtr
+        encoder = xmlFindCharEncodingHandler(reinterpret_cast<const char*>(encoding));
+    if ( encoder && xmlStrEqual(BAD_CAST encoder->name, BAD_CAST "UTF-8") )
+        encoder = nullptr;
+
+    return encoder;
+}
+
+// Write the result of the transformation to the given output buffer, then
+// close the buffer and free the result.
+bool save_result(xmlOutputBufferPtr buf,
+                 xmlDocPtr result,
+                 xsltStylesheetPtr style,
+                 xml::error_handler& on_error)
+{
+    if ( !buf )
     {
-        v.push_back(param.first.c_str());
-        v.push_back(param.second.c_str());
+        xmlFreeDoc(result);
+        throw std::bad_alloc();
     }
 
-    v.push_back(nullptr);
+    xml::impl::global_errors_collector err;
+
+    const int rc = xsltSaveResultTo(buf, result, style);
+
+    // Notice that closing the buffer flushes it, so it can fail too.
+    const int rc_close = xmlOutputBufferClose(buf);
+
+    xmlFreeDoc(result);
+
+    if ( rc < 0 || rc_close < 0 )
+    {
+        if ( !err.has_errors() )
+            err.on_error("failed to write XSLT transformation result");
+        err.replay(on_error);
+        return false;
+    }
+
+    err.replay(on_error);
+    return true;
 }
 
+extern "C"
+{
 
-class xslt_errors_collector : public xml::impl::errors_collector
+static int xslt_write_to_stream(void *ctx, const char *buffer, int len)
 {
-public:
-    xslt_errors_collector(xsltTransformContextPtr c) : ctxt_(c) {}
+    auto stream = static_cast<std::ostream*>(ctx);
 
-    void on_error(const std::string& msg) override
+    // we can't let exceptions propagate through libxml2 code
+    try
     {
-        xml::impl::errors_collector::on_error(msg);
-
-        // tell the processor to stop when it gets a chance:
-        if ( ctxt_->state == XSLT_STATE_OK )
-            ctxt_->state = XSLT_STATE_STOPPED;
+        stream->write(buffer, len);
+    }
+    catch ( ... )
+    {
+        return -1;
     }
 
-    xsltTransformContextPtr ctxt_;
-};
+    return stream->good() ? len : -1;
+}
+
+} // extern "C"
+
+} // end of anonymous namespace
+
 
-xmlDocPtr apply_stylesheet(std::unique_ptr<xslt::stylesheet::pimpl> const& impl,
+namespace xslt
+{
+
+namespace impl
+{
+
+// Notice that this function must be thread-safe, i.e. all the state needed
+// for the transformation must be kept in the transformation context or in
+// local variables and not in the shared stylesheet object.
+xmlDocPtr apply_stylesheet(const stylesheet::pimpl& impl,
                            xml::error_handler& on_error,
                            xmlDocPtr doc,
-                           const xslt::stylesheet::param_type *p = nullptr)
+                           const stylesheet::param_type *p,
+                           profile *prof,
+                           const param_set *ps)
 {
-    xsltStylesheetPtr style = impl->ss_;
+    xml::impl::in_flight_operation in_flight;
+
+    xsltStylesheetPtr style = impl.ss_;
+
+    std::unique_ptr<profile_collector> profiler;
+    if ( prof )
+        profiler.reset(new profile_collector(impl, *prof));
 
     std::vector<const char*> v;
+    const char **params = nullptr;
     if (p)
+    {
         make_vector_param(v, *p);
+        params = &v[0];
+    }
+    else if (ps)
+    {
+        params = param_set_impl::get(*ps).get_expressions();
+    }
 
     xsltTransformContextPtr ctxt = xsltNewTransformContext(style, doc);
-    ctxt->_private = impl.get();
+    if ( !ctxt )
+        throw std::bad_alloc();
+
+    ctxt->_private = const_cast<stylesheet::pimpl*>(&impl);
+
+    std::unique_ptr<doc_loader_scope> doc_cache_scope;
+    if ( impl.doc_cache_ )
+        doc_cache_scope.reset(new doc_loader_scope(document_cache_impl::get(*impl.doc_cache_)));
+
+    for ( auto const& f : impl.functions_ )
+    {
+        xsltRegisterExtFunction(ctxt,
+                                xml::impl::xml_string(f.first.first),
+                                xml::impl::xml_string(f.first.second),
+                                xslt_extension_function);
+    }
 
+    // Notice that libxml2 global error handlers are per-thread (as long as
+    // libxml2 is built with threads support), so installing our handler here
+    // doesn't affect the transformations running in the other threads.
     xslt_errors_collector err(ctxt);
     xml::impl::global_errors_installer install_as_global(err);
 
     xsltSetTransformErrorFunc(ctxt, &err, xml::impl::cb_messages_error);
 
-    xmlDocPtr result =
-        xsltApplyStylesheetUser(style, doc, p ? &v[0] : nullptr, nullptr, nullptr, ctxt);
+    if ( profiler )
+        profiler->enable(ctxt);
+
+    xmlDocPtr result = nullptr;
+    if ( !ps || param_set_impl::get(*ps).quote_strings(ctxt) )
+        result = xsltApplyStylesheetUser(style, doc, params, nullptr, nullptr, ctxt);
 
     xsltFreeTransformContext(ctxt);
 
+    if ( profiler )
+    {
+        profiler->collect();
+        profiler.reset();
+    }
+
     // it's possible there was an error that didn't prevent creation of some
     // (incorrect) document
     if ( result && err.has_errors() )
@@ -186,6 +378,65 @@ xmlDocPtr apply_stylesheet(std::unique_ptr<xslt::stylesheet::pimpl> const& impl,
     return result;
 }
 
+
+bool save_result_to_stream(xmlDocPtr result,
+                           xsltStylesheetPtr style,
+                           std::ostream& stream,
+                           xml::error_handler& on_error)
+{
+    xmlOutputBufferPtr buf = xmlOutputBufferCreateIO(xslt_write_to_stream,
+                                                     nullptr,
+                                                     &stream,
+                                                     get_output_encoder(style));
+    return save_result(buf, result, style, on_error);
+}
+
+
+bool save_result_to_fd(xmlDocPtr result,
+                       xsltStylesheetPtr style,
+                       int fd,
+                       xml::error_handler& on_error)
+{
+    xmlOutputBufferPtr buf = xmlOutputBufferCreateFd(fd, get_output_encoder(style));
+    return save_result(buf, result, style, on_error);
+}
+
+} // namespace impl
+
+} // namespace xslt
+
+
+namespace
+{
+
+bool apply_to_stream_impl(const xslt::stylesheet::pimpl& impl,
+                          xmlDocPtr input,
+                          std::ostream& stream,
+                          const xslt::stylesheet::param_type *params,
+                          const xslt::param_set *param_set,
+                          xml::error_handler& on_error)
+{
+    xmlDocPtr result = xslt::impl::apply_stylesheet(impl, on_error, input, params, nullptr, param_set);
+    if ( !result )
+        return false;
+
+    return xslt::impl::save_result_to_stream(result, impl.ss_, stream, on_error);
+}
+
+bool apply_to_fd_impl(const xslt::stylesheet::pimpl& impl,
+                      xmlDocPtr input,
+                      int fd,
+                      const xslt::stylesheet::param_type *params,
+                      const xslt::param_set *param_set,
+                      xml::error_handler& on_error)
+{
+    xmlDocPtr result = xslt::impl::apply_stylesheet(impl, on_error, input, params, nullptr, param_set);
+    if ( !result )
+        return false;
+
+    return xslt::impl::save_result_to_fd(result, impl.ss_, fd, on_error);
+}
+
 } // end of anonymous namespace
 
 
@@ -196,16 +447,49 @@ xslt::stylesheet::stylesheet(const char *filename, xml::error_handler& on_error)
 }
 
 
-xslt::stylesheet::stylesheet(xml::document doc, xml::error_handler& on_error)
+xslt::stylesheet::stylesheet(const char *data,
+                             std::size_t size,
+                             const char *base_uri,
+                             xml::error_handler& on_error)
+{
+    xml::document doc(data, size, on_error);
+    init(doc, on_error, base_uri);
+}
+
+
+xslt::stylesheet::stylesheet(const xml::document& doc, xml::error_handler& on_error)
+{
+    xml::document copy(doc);
+    init(copy, on_error);
+}
+
+
+xslt::stylesheet::stylesheet(xml::document&& doc, xml::error_handler& on_error)
 {
+    // The stylesheet takes ownership of the document, which is impossible
+    // for the documents using an arena, so use a normal copy of them.
+    if ( doc.get_memory_mode() == xml::document::arena_allocation )
+    {
+        xml::document copy(doc);
+        init(copy, on_error);
+        return;
+    }
+
     init(doc, on_error);
 }
 
-void xslt::stylesheet::init(xml::document& doc, xml::error_handler& on_error)
+void xslt::stylesheet::init(xml::document& doc, xml::error_handler& on_error, const char *base_uri)
 {
     auto xmldoc = static_cast<xmlDocPtr>(doc.get_doc_data());
     pimpl_.reset(new pimpl());
 
+    if ( base_uri )
+    {
+        if ( xmldoc->URL )
+            xmlFree(const_cast<xmlChar*>(xmldoc->URL));
+        xmldoc->URL = xmlStrdup(reinterpret_cast<const xmlChar*>(base_uri));
+    }
+
     if ( (pimpl_->ss_ = xsltParseStylesheetDoc(xmldoc)) == nullptr)
     {
         // TODO error_ can't get set yet. Need changes from libxslt first
@@ -226,6 +510,20 @@ xslt::stylesheet::~stylesheet()
 }
 
 
+void xslt::stylesheet::register_function(const std::string& name,
+                                         const std::string& ns_uri,
+                                         xml::xpath_function func)
+{
+    pimpl_->functions_[std::make_pair(name, ns_uri)] = std::move(func);
+}
+
+
+void xslt::stylesheet::set_document_cache(std::shared_ptr<document_cache> cache)
+{
+    pimpl_->doc_cache_ = std::move(cache);
+}
+
+
 bool xslt::stylesheet::apply(const xml::document &doc, xml::document &result)
 {
     xml::impl::errors_collector err;
@@ -249,14 +547,14 @@ bool xslt::stylesheet::apply(const xml::document &doc, xml::document &result,
 
 bool xslt::stylesheet::apply(const xml::document &doc,
                              xml::document &result,
-                             xml::error_handler& on_error)
+                             xml::error_handler& on_error) const
 {
     auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
-    xmlDocPtr xmldoc = apply_stylesheet(pimpl_, on_error, input);
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input);
 
     if (xmldoc)
     {
-        result.set_doc_data_from_xslt(xmldoc, new result_impl(xmldoc, pimpl_->ss_));
+        result.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
         return true;
     }
 
@@ -267,14 +565,14 @@ bool xslt::stylesheet::apply(const xml::document &doc,
 bool xslt::stylesheet::apply(const xml::document &doc,
                              xml::document &result,
                              const param_type &with_params,
-                             xml::error_handler& on_error)
+                             xml::error_handler& on_error) const
 {
     auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
-    xmlDocPtr xmldoc = apply_stylesheet(pimpl_, on_error, input, &with_params);
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input, &with_params);
 
     if (xmldoc)
     {
-        result.set_doc_data_from_xslt(xmldoc, new result_impl(xmldoc, pimpl_->ss_));
+        result.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
         return true;
     }
 
@@ -286,7 +584,7 @@ xml::document& xslt::stylesheet::apply(const xml::document &doc,
                                        xml::error_handler& on_error)
 {
     auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
-    xmlDocPtr xmldoc = apply_stylesheet(pimpl_, on_error, input);
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input);
 
     if (!xmldoc)
     {
@@ -294,7 +592,7 @@ xml::document& xslt::stylesheet::apply(const xml::document &doc,
         throw xml::exception("applying style sheet failed");
     }
 
-    pimpl_->doc_.set_doc_data_from_xslt(xmldoc, new result_impl(xmldoc, pimpl_->ss_));
+    pimpl_->doc_.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
     return pimpl_->doc_;
 }
 
@@ -304,7 +602,7 @@ xml::document& xslt::stylesheet::apply(const xml::document &doc,
                                        xml::error_handler& on_error)
 {
     auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
-    xmlDocPtr xmldoc = apply_stylesheet(pimpl_, on_error, input, &with_params);
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input, &with_params);
 
     if (!xmldoc)
     {
@@ -312,12 +610,126 @@ xml::document& xslt::stylesheet::apply(const xml::document &doc,
         throw xml::exception("applying style sheet failed");
     }
 
-    pimpl_->doc_.set_doc_data_from_xslt(xmldoc, new result_impl(xmldoc, pimpl_->ss_));
+    pimpl_->doc_.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
     return pimpl_->doc_;
 }
 
 
+bool xslt::stylesheet::apply(const xml::document &doc,
+                             xml::document &result,
+                             const param_set &with_params,
+                             xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input, nullptr, nullptr, &with_params);
+
+    if (xmldoc)
+    {
+        result.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
+        return true;
+    }
+
+    return false;
+}
+
+
+bool xslt::stylesheet::apply(const xml::document &doc,
+                             xml::document &result,
+                             profile& prof,
+                             xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input, nullptr, &prof);
+
+    if (xmldoc)
+    {
+        result.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
+        return true;
+    }
+
+    return false;
+}
+
+
+bool xslt::stylesheet::apply(const xml::document &doc,
+                             xml::document &result,
+                             const param_type &with_params,
+                             profile& prof,
+                             xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    xmlDocPtr xmldoc = xslt::impl::apply_stylesheet(*pimpl_, on_error, input, &with_params, &prof);
+
+    if (xmldoc)
+    {
+        result.set_doc_data_from_xslt(xmldoc, new xslt::impl::result_impl(xmldoc, pimpl_->ss_));
+        return true;
+    }
+
+    return false;
+}
+
+
+bool xslt::stylesheet::apply_to_stream(const xml::document& doc,
+                                       std::ostream& stream,
+                                       xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_stream_impl(*pimpl_, input, stream, nullptr, nullptr, on_error);
+}
+
+
+bool xslt::stylesheet::apply_to_stream(const xml::document& doc,
+                                       std::ostream& stream,
+                                       const param_type& with_params,
+                                       xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_stream_impl(*pimpl_, input, stream, &with_params, nullptr, on_error);
+}
+
+
+bool xslt::stylesheet::apply_to_stream(const xml::document& doc,
+                                       std::ostream& stream,
+                                       const param_set& with_params,
+                                       xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_stream_impl(*pimpl_, input, stream, nullptr, &with_params, on_error);
+}
+
+
+bool xslt::stylesheet::apply_to_fd(const xml::document& doc,
+                                   int fd,
+                                   xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_fd_impl(*pimpl_, input, fd, nullptr, nullptr, on_error);
+}
+
+
+bool xslt::stylesheet::apply_to_fd(const xml::document& doc,
+                                   int fd,
+                                   const param_type& with_params,
+                                   xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_fd_impl(*pimpl_, input, fd, &with_params, nullptr, on_error);
+}
+
+
+bool xslt::stylesheet::apply_to_fd(const xml::document& doc,
+                                   int fd,
+                                   const param_set& with_params,
+                                   xml::error_handler& on_error) const
+{
+    auto input = static_cast<xmlDocPtr>(doc.get_doc_data_read_only());
+    return apply_to_fd_impl(*pimpl_, input, fd, nullptr, &with_params, on_error);
+}
+
+
 const std::string& xslt::stylesheet::get_error_message() const
 {
     return pimpl_->get_error_message_cache_;
 }
+
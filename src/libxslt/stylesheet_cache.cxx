@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the implementation of the xslt::stylesheet_cache class.
+ */
+
+// xmlwrapp includes
+#include "xsltwrapp/stylesheet_cache.h"
+#include "xmlwrapp/errors.h"
+
+#include "loader.h"
+
+// libxml2 and libxslt includes
+#include <libxslt/security.h>
+
+// standard includes
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace xslt
+{
+
+namespace impl
+{
+
+namespace
+{
+
+// A file used for compiling a stylesheet.
+struct dependency
+{
+    std::string path;
+    file_stamp stamp;
+};
+
+using dependencies = std::vector<dependency>;
+
+bool are_up_to_date(const dependencies& files)
+{
+    for ( auto const& f : files )
+    {
+        if ( get_file_stamp(f.path) != f.stamp )
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+
+struct stylesheet_cache_impl
+{
+    using size_type = stylesheet_cache::size_type;
+
+    struct entry
+    {
+        std::shared_ptr<const stylesheet> style;
+
+        // The stylesheet file itself and all the files it imports.
+        dependencies files;
+
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    struct import_entry
+    {
+        file_stamp stamp;
+
+        // This document is never given to libxslt, it gets its copies.
+        xmlDocPtr doc;
+    };
+
+    explicit stylesheet_cache_impl(size_type max_size) : max_size_(max_size) {}
+
+    ~stylesheet_cache_impl()
+    {
+        for ( auto const& i : imports_ )
+            xmlFreeDoc(i.second.doc);
+    }
+
+    // Load the stylesheet imported or included by the one being compiled and
+    // add it to the list of its dependencies.
+    xmlDocPtr load_import(const xmlChar *uri,
+                          xmlDictPtr dict,
+                          int options,
+                          void *ctxt,
+                          dependencies& files);
+
+    // Add the new entry or replace the existing one, must be called with the
+    // mutex locked.
+    void store(const std::string& filename,
+               const std::shared_ptr<const stylesheet>& style,
+               dependencies&& files);
+
+    // These functions must be called with the mutex locked too.
+    void erase(std::unordered_map<std::string, entry>::iterator i);
+    void evict_excess();
+    void purge_imports();
+
+    mutable std::mutex mutex_;
+
+    size_type max_size_;
+
+    std::unordered_map<std::string, entry> entries_;
+
+    // Keys of the entries, from the most to the least recently used one.
+    std::list<std::string> lru_;
+
+    // Imported stylesheets indexed by their file names.
+    std::unordered_map<std::string, import_entry> imports_;
+
+    stylesheet_cache::statistics stats_;
+
+    std::shared_ptr<document_cache> doc_cache_;
+};
+
+
+namespace
+{
+
+// Loader used while compiling a stylesheet for the cache.
+class compile_loader : public doc_loader
+{
+public:
+    compile_loader(stylesheet_cache_impl& cache, dependencies& files)
+        : cache_(cache), files_(files)
+    {
+    }
+
+    xmlDocPtr load(const xmlChar *uri,
+                   xmlDictPtr dict,
+                   int options,
+                   void *ctxt,
+                   xsltLoadType type) override
+    {
+        // Bypass the cache if the default security preferences are set, as
+        // they must be checked by the default loader for every access.
+        if ( type != XSLT_LOAD_STYLESHEET || xsltGetDefaultSecurityPrefs() )
+            return load_default(uri, dict, options, ctxt, type);
+
+        return cache_.load_import(uri, dict, options, ctxt, files_);
+    }
+
+private:
+    stylesheet_cache_impl& cache_;
+    dependencies& files_;
+};
+
+} // anonymous namespace
+
+
+xmlDocPtr stylesheet_cache_impl::load_import(const xmlChar *uri,
+                                             xmlDictPtr dict,
+                                             int options,
+                                             void *ctxt,
+                                             dependencies& files)
+{
+    std::string path;
+    file_stamp stamp;
+    if ( uri_to_path(uri, path) )
+        stamp = get_file_stamp(path);
+
+    if ( !stamp.exists )
+        return doc_loader::load_default(uri, dict, options, ctxt, XSLT_LOAD_STYLESHEET);
+
+    files.push_back(dependency{path, stamp});
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto i = imports_.find(path);
+        if ( i != imports_.end() && i->second.stamp == stamp )
+        {
+            stats_.import_hits++;
+            return xmlCopyDoc(i->second.doc, 1);
+        }
+    }
+
+    xmlDocPtr doc = doc_loader::load_default(uri, dict, options, ctxt, XSLT_LOAD_STYLESHEET);
+    if ( !doc )
+        return nullptr;
+
+    // libxslt takes ownership of the document and modifies it, so we need
+    // to keep a copy of it
+    xmlDocPtr copy = xmlCopyDoc(doc, 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stats_.import_misses++;
+
+    if ( copy )
+    {
+        import_entry& e = imports_[path];
+        if ( e.doc )
+            xmlFreeDoc(e.doc);
+        e.stamp = stamp;
+        e.doc = copy;
+    }
+
+    return doc;
+}
+
+
+void stylesheet_cache_impl::store(const std::string& filename,
+                                  const std::shared_ptr<const stylesheet>& style,
+                                  dependencies&& files)
+{
+    auto i = entries_.find(filename);
+    if ( i != entries_.end() )
+    {
+        lru_.erase(i->second.lru_pos);
+    }
+    else
+    {
+        i = entries_.emplace(filename, entry()).first;
+    }
+
+    entry& e = i->second;
+    e.style = style;
+    e.files = std::move(files);
+    e.lru_pos = lru_.insert(lru_.begin(), filename);
+
+    evict_excess();
+    purge_imports();
+}
+
+
+void stylesheet_cache_impl::erase(std::unordered_map<std::string, entry>::iterator i)
+{
+    lru_.erase(i->second.lru_pos);
+    entries_.erase(i);
+}
+
+
+void stylesheet_cache_impl::evict_excess()
+{
+    while ( entries_.size() > max_size_ )
+    {
+        erase(entries_.find(lru_.back()));
+        stats_.evictions++;
+    }
+}
+
+
+void stylesheet_cache_impl::purge_imports()
+{
+    std::unordered_set<std::string> used;
+    for ( auto const& e : entries_ )
+    {
+        for ( auto const& f : e.second.files )
+            used.insert(f.path);
+    }
+
+    for ( auto i = imports_.begin(); i != imports_.end(); )
+    {
+        if ( used.count(i->first) )
+        {
+            ++i;
+        }
+        else
+        {
+            xmlFreeDoc(i->second.doc);
+            i = imports_.erase(i);
+        }
+    }
+}
+
+} // namespace impl
+
+
+stylesheet_cache::stylesheet_cache(size_type max_size)
+{
+    if ( !max_size )
+        throw xml::exception("stylesheet cache size must be positive");
+
+    pimpl_.reset(new impl::stylesheet_cache_impl(max_size));
+}
+
+
+stylesheet_cache::~stylesheet_cache() = default;
+
+
+std::shared_ptr<const stylesheet>
+stylesheet_cache::get(const char *filename, xml::error_handler& on_error)
+{
+    const std::string key(filename);
+
+    std::shared_ptr<const stylesheet> cached;
+    impl::dependencies cached_files;
+    {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+        auto i = pimpl_->entries_.find(key);
+        if ( i != pimpl_->entries_.end() )
+        {
+            cached = i->second.style;
+            cached_files = i->second.files;
+        }
+    }
+
+    // don't block the other threads while checking the files
+    if ( cached && impl::are_up_to_date(cached_files) )
+    {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+        auto i = pimpl_->entries_.find(key);
+        if ( i != pimpl_->entries_.end() && i->second.style == cached )
+            pimpl_->lru_.splice(pimpl_->lru_.begin(), pimpl_->lru_, i->second.lru_pos);
+
+        pimpl_->stats_.hits++;
+        return cached;
+    }
+
+    impl::dependencies files;
+    files.push_back(impl::dependency{key, impl::get_file_stamp(key)});
+
+    impl::compile_loader loader(*pimpl_, files);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [start]()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+    };
+
+    std::shared_ptr<document_cache> doc_cache;
+    {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+        doc_cache = pimpl_->doc_cache_;
+    }
+
+    std::shared_ptr<const stylesheet> style;
+    try
+    {
+        impl::doc_loader_scope scope(loader);
+        auto compiled = std::make_shared<stylesheet>(filename, on_error);
+        compiled->set_document_cache(std::move(doc_cache));
+        style = std::move(compiled);
+    }
+    catch ( ... )
+    {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+        pimpl_->stats_.misses++;
+        pimpl_->stats_.compile_time += elapsed();
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    pimpl_->stats_.misses++;
+    pimpl_->stats_.compile_time += elapsed();
+    pimpl_->store(key, style, std::move(files));
+
+    return style;
+}
+
+
+bool stylesheet_cache::remove(const char *filename)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    auto i = pimpl_->entries_.find(filename);
+    if ( i == pimpl_->entries_.end() )
+        return false;
+
+    pimpl_->erase(i);
+    pimpl_->purge_imports();
+    return true;
+}
+
+
+void stylesheet_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    pimpl_->entries_.clear();
+    pimpl_->lru_.clear();
+    pimpl_->purge_imports();
+}
+
+
+stylesheet_cache::size_type stylesheet_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->entries_.size();
+}
+
+
+stylesheet_cache::size_type stylesheet_cache::get_max_size() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->max_size_;
+}
+
+
+void stylesheet_cache::set_max_size(size_type max_size)
+{
+    if ( !max_size )
+        throw xml::exception("stylesheet cache size must be positive");
+
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+
+    pimpl_->max_size_ = max_size;
+    pimpl_->evict_excess();
+    pimpl_->purge_imports();
+}
+
+
+stylesheet_cache::statistics stylesheet_cache::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->stats_;
+}
+
+
+void stylesheet_cache::set_document_cache(std::shared_ptr<document_cache> cache)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    pimpl_->doc_cache_ = std::move(cache);
+}
+
+} // namespace xslt
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+    @file
+
+    This file contains the private part of the xslt::stylesheet class used by
+    the other xsltwrapp classes.
+ */
+
+#ifndef _xsltwrapp_stylesheet_impl_h_
+#define _xsltwrapp_stylesheet_impl_h_
+
+// xmlwrapp includes
+#include "xsltwrapp/stylesheet.h"
+#include "xmlwrapp/document.h"
+#include "xmlwrapp/xpath.h"
+
+#include "result.h"
+#include "../libxml/utility.h"
+
+// libxslt includes
+#include <libxslt/xsltInternals.h>
+#include <libxslt/xsltutils.h>
+
+// standard includes
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+struct xslt::stylesheet::pimpl
+{
+    pimpl () = default;
+
+    // The compiled stylesheet is only read during transformations, so it can
+    // be used by several threads concurrently.
+    xsltStylesheetPtr ss_{nullptr};
+
+    // Extension functions indexed by their names and namespace URIs.
+    std::map<std::pair<std::string, std::string>, xml::xpath_function> functions_;
+
+    // Cache used for the documents loaded by document() function, if any.
+    std::shared_ptr<xslt::document_cache> doc_cache_;
+
+    // libxslt stores the profiling information in the compiled templates, so
+    // only one profiled transformation can run at any time.
+    mutable std::mutex profiling_mutex_;
+
+    // These fields are only used by the non-thread-safe apply() overloads.
+    xml::document doc_;
+    std::string get_error_message_cache_;
+};
+
+namespace xslt
+{
+
+class param_set;
+class profile;
+
+namespace impl
+{
+
+// implementation of xslt::result using xslt::stylesheet: we pass this object
+// to xml::document for the documents obtained via XSLT so that some operations
+// (currently only saving) could be done differently for them
+class result_impl : public xslt::impl::result
+{
+public:
+    // We don't own the pointers given to us, their lifetime must be greater
+    // than the lifetime of this object.
+    result_impl(xmlDocPtr doc, xsltStylesheetPtr ss) : doc_(doc), ss_(ss) {}
+
+    void save_to_string(std::string &s) const override
+    {
+        xmlChar *xml_string;
+        int xml_string_length;
+
+        if (xsltSaveResultToString(&xml_string, &xml_string_length, doc_, ss_) >= 0)
+        {
+            xml::impl::xmlchar_helper helper(xml_string);
+            if (xml_string_length)
+                s.assign(helper.get(), xml::impl::checked_size_t_cast(xml_string_length));
+        }
+    }
+
+    bool
+    save_to_file(const char *filename, int /* compression_level */) const override
+    {
+        return xsltSaveResultToFilename(filename, doc_, ss_, 0) >= 0;
+    }
+
+private:
+    xmlDocPtr doc_;
+    xsltStylesheetPtr ss_;
+};
+
+
+// Apply the stylesheet to the given document, taking the parameters from
+// either the map or the param_set, if any, and return the result document,
+// which must be freed by the caller, or nullptr if an error occurred. The
+// errors are reported to on_error.
+xmlDocPtr apply_stylesheet(const stylesheet::pimpl& impl,
+                           xml::error_handler& on_error,
+                           xmlDocPtr doc,
+                           const stylesheet::param_type *p = nullptr,
+                           profile *prof = nullptr,
+                           const param_set *ps = nullptr);
+
+// Write the result document to the given output using the output settings
+// of the given stylesheet, and free it.
+bool save_result_to_stream(xmlDocPtr result,
+                           xsltStylesheetPtr style,
+                           std::ostream& stream,
+                           xml::error_handler& on_error);
+bool save_result_to_fd(xmlDocPtr result,
+                       xsltStylesheetPtr style,
+                       int fd,
+                       xml::error_handler& on_error);
+
+} // namespace impl
+
+} // namespace xslt
+
+#endif // _xsltwrapp_stylesheet_impl_h_
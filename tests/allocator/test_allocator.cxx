@@ -0,0 +1,469 @@
+/*
+ * Copyright (C) 2011 Jonas Weber <mail@jonasw.de>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../test.h"
+
+#ifdef XMLWRAPP_TEST_XSLT
+    #include <xsltwrapp/xsltwrapp.h>
+#endif
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Document with many small nodes.
+std::string make_big_document()
+{
+    std::string xml("<root>");
+    for ( int n = 0; n < 1000; ++n )
+        xml += "<item id=\"" + std::to_string(n) + "\">text</item>";
+    xml += "</root>";
+    return xml;
+}
+
+std::string parse_and_save(const std::string& xml)
+{
+    xml::tree_parser parser(xml.data(), xml.size());
+
+    std::string output;
+    parser.get_document().save_to_string(output);
+    return output;
+}
+
+// Install the allocator for the lifetime of this object.
+class use_allocator
+{
+public:
+    explicit use_allocator(xml::allocator& alloc)
+        : old_(xml::init::set_allocator(&alloc))
+    {
+    }
+
+    ~use_allocator()
+    {
+        xml::init::set_allocator(old_);
+    }
+
+private:
+    xml::allocator * const old_;
+};
+
+} // anonymous namespace
+
+
+/*
+ * Test using the allocators directly.
+ */
+
+TEST_CASE( "allocator/pool_blocks", "[allocator]" )
+{
+    xml::pool_allocator pool;
+
+    std::vector<char*> blocks;
+    for ( xml::allocator::size_type size = 0; size < 2*xml::pool_allocator::max_pooled_size; size += 7 )
+    {
+        auto p = static_cast<char*>(pool.allocate(size));
+        REQUIRE( p );
+        CHECK( reinterpret_cast<std::uintptr_t>(p) % alignof(std::max_align_t) == 0 );
+        std::memset(p, static_cast<int>(size % 256), size);
+        blocks.push_back(p);
+    }
+
+    CHECK( pool.get_pool_memory() > 0 );
+
+    // growing the blocks preserves their contents
+    xml::allocator::size_type size = 0;
+    for ( auto& p : blocks )
+    {
+        p = static_cast<char*>(pool.reallocate(p, size + 100));
+        REQUIRE( p );
+
+        bool same = true;
+        for ( xml::allocator::size_type n = 0; n < size; ++n )
+        {
+            if ( p[n] != static_cast<char>(size % 256) )
+                same = false;
+        }
+        CHECK( same );
+
+        size += 7;
+    }
+
+    for ( auto p : blocks )
+        pool.deallocate(p);
+
+    pool.deallocate(nullptr);
+}
+
+TEST_CASE( "allocator/counting_blocks", "[allocator]" )
+{
+    xml::pool_allocator pool;
+    xml::counting_allocator counting(&pool);
+
+    void *p1 = counting.allocate(10);
+    void *p2 = counting.allocate(1000);
+    REQUIRE( p1 );
+    REQUIRE( p2 );
+
+    xml::counting_allocator::statistics stats = counting.get_statistics();
+    CHECK( stats.allocations == 2 );
+    CHECK( stats.bytes_in_use == 1010 );
+
+    p1 = counting.reallocate(p1, 100);
+    REQUIRE( p1 );
+    counting.deallocate(p2);
+
+    stats = counting.get_statistics();
+    CHECK( stats.deallocations == 1 );
+    CHECK( stats.bytes_in_use == 100 );
+    CHECK( stats.peak_bytes_in_use == 1100 );
+    CHECK( stats.total_bytes == 1100 );
+
+    counting.deallocate(p1);
+    CHECK( counting.get_statistics().bytes_in_use == 0 );
+}
+
+
+/*
+ * Test using the allocators with libxml2.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "allocator/counting", "[allocator]" )
+{
+    const std::string xml = make_big_document();
+    const std::string expected = parse_and_save(xml);
+
+    xml::counting_allocator counting;
+    {
+        use_allocator use(counting);
+        CHECK( xml::init::get_allocator() == &counting );
+
+        const auto before = counting.get_statistics();
+        {
+            xml::tree_parser parser(xml.data(), xml.size());
+
+            const auto during = counting.get_statistics();
+            CHECK( during.allocations > before.allocations + 1000 );
+            CHECK( during.bytes_in_use > before.bytes_in_use + 1000*sizeof(void*) );
+        }
+
+        // all the memory used by the document is freed together with it
+        CHECK( parse_and_save(xml) == expected );
+        const auto after = counting.get_statistics();
+        CHECK( parse_and_save(xml) == expected );
+        CHECK( counting.get_statistics().bytes_in_use == after.bytes_in_use );
+
+#ifdef XMLWRAPP_TEST_XSLT
+        xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+        xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+        xml::document result;
+        xml::error_messages errors;
+        CHECK( style.apply(parser.get_document(), result, errors) );
+#endif
+    }
+
+    CHECK( xml::init::get_allocator() == nullptr );
+
+    // libxml2 freed everything it allocated when it was restarted
+    CHECK( counting.get_statistics().bytes_in_use == 0 );
+
+    CHECK( parse_and_save(xml) == expected );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "allocator/pool", "[allocator][threads]" )
+{
+    const std::string xml = make_big_document();
+    const std::string expected = parse_and_save(xml);
+
+    xml::pool_allocator pool;
+    use_allocator use(pool);
+
+    const int num_threads = 4;
+    const int num_iterations = 20;
+
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::tree_parser parser(xml.data(), xml.size());
+                xml::document& doc = parser.get_document();
+
+                // modify the document to free some nodes in this thread
+                xml::node& root = doc.get_root_node();
+                root.erase(root.begin());
+                root.push_back(xml::node("item", "text"));
+                if ( root.size() != 1000 )
+                    ++failures[t];
+
+                xml::document copy(doc);
+                if ( copy.get_root_node().size() != 1000 )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        INFO( "thread " << t );
+        CHECK( failures[t] == 0 );
+    }
+
+    CHECK( pool.get_pool_memory() > 0 );
+    CHECK( parse_and_save(xml) == expected );
+}
+
+
+/*
+ * Test documents using arena allocation.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "allocator/arena_requires_allocator", "[allocator][arena]" )
+{
+    REQUIRE( xml::init::get_allocator() == nullptr );
+
+    CHECK_THROWS_AS( xml::document(xml::document::arena_allocation), xml::exception );
+
+    const std::string xml = make_big_document();
+    CHECK_THROWS_AS( xml::document(xml.data(), xml.size(), xml::document::arena_allocation),
+                     xml::exception );
+
+    CHECK( xml::document().get_memory_mode() == xml::document::individual_allocation );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "allocator/arena", "[allocator][arena]" )
+{
+    const std::string xml = make_big_document();
+    const std::string expected = parse_and_save(xml);
+
+    xml::counting_allocator counting;
+    use_allocator use(counting);
+
+    // make sure everything initialized on first use is already allocated
+    CHECK( parse_and_save(xml) == expected );
+    xml::document(xml::document::arena_allocation);
+
+    const auto before = counting.get_statistics();
+
+    SECTION( "parse" )
+    {
+        xml::counting_allocator::size_type individual_frees;
+        {
+            xml::document doc(xml.data(), xml.size());
+            const auto parsed = counting.get_statistics();
+            doc = xml::document();
+            individual_frees = counting.get_statistics().deallocations - parsed.deallocations;
+        }
+
+        xml::counting_allocator::size_type arena_frees;
+        {
+            xml::document doc(xml.data(), xml.size(), xml::document::arena_allocation);
+            CHECK( doc.get_memory_mode() == xml::document::arena_allocation );
+            CHECK( doc.get_root_node().size() == 1000 );
+
+            std::string output;
+            doc.save_to_string(output);
+            CHECK( output == expected );
+
+            const auto parsed = counting.get_statistics();
+            doc = xml::document();
+            arena_frees = counting.get_statistics().deallocations - parsed.deallocations;
+        }
+
+        // the entire document is freed at once
+        CHECK( individual_frees > 2000 );
+        CHECK( arena_frees < 20 );
+
+        // errors are reported as usual and nothing is leaked
+        xml::error_messages errors;
+        xml::tree_parser parser("<root><item></root>", 19, xml::document::arena_allocation, errors);
+        CHECK( !parser );
+        CHECK( errors.has_errors() );
+    }
+
+    SECTION( "modify" )
+    {
+        xml::tree_parser parser(test_file_path("document/data/22a.xml").c_str(),
+                                xml::document::arena_allocation);
+        xml::document& doc = parser.get_document();
+        xml::node& root = doc.get_root_node();
+
+        // the DTD is not allocated from the arena but is still freed
+        CHECK( doc.validate(test_file_path("document/data/22.dtd").c_str()) );
+
+        root.set_name("changed");
+        root.erase(root.begin());
+        root.push_back(xml::node("item", "three"));
+        root.begin()->get_attributes().insert("kind", "other");
+        root.begin()->set_content("new content");
+        root.set_namespace("http://example.com/ns");
+        doc.set_version("1.1");
+        doc.set_encoding("ISO-8859-1");
+
+        std::string output;
+        doc.save_to_string(output);
+        CHECK( output.find("<changed") != std::string::npos );
+        CHECK( output.find("new content") != std::string::npos );
+        CHECK( output.find("three") != std::string::npos );
+    }
+
+    SECTION( "insert" )
+    {
+        xml::document normal(xml::node("normal"));
+        {
+            xml::document arena(xml.data(), xml.size(), xml::document::arena_allocation);
+            xml::node& root = arena.get_root_node();
+
+            // copying nodes into and out of the arena document
+            root.push_back(normal.get_root_node());
+            root.insert(root.begin(), xml::node("first"));
+            root.replace(++root.begin(), xml::node("second", "text"));
+            normal.get_root_node().push_back(*root.begin());
+            normal.get_root_node().push_back(*++root.begin());
+            normal.push_back(xml::node(xml::node::comment("comment")));
+            normal.get_root_node().push_back(*root.find("normal"));
+
+            CHECK( root.size() == 1002 );
+
+            xml::document copy(arena);
+            CHECK( copy.get_memory_mode() == xml::document::individual_allocation );
+
+            std::string output;
+            arena.save_to_string(output);
+
+            arena = xml::document();
+            CHECK( arena.get_memory_mode() == xml::document::individual_allocation );
+
+            std::string copy_output;
+            copy.save_to_string(copy_output);
+            CHECK( copy_output == output );
+        }
+
+        // the nodes copied from the arena document don't depend on it
+        std::string output;
+        normal.save_to_string(output);
+        CHECK( output ==
+                "<?xml version=\"1.0\"?>\n"
+                "<normal>\n"
+                "  <first/>\n"
+                "  <second>text</second>\n"
+                "  <normal/>\n"
+                "</normal>\n"
+                "<!--comment-->\n" );
+    }
+
+    SECTION( "create" )
+    {
+        xml::document doc(xml::document::arena_allocation);
+        CHECK( doc.get_memory_mode() == xml::document::arena_allocation );
+
+        doc.set_root_node(xml::node("root"));
+        for ( int n = 0; n < 1000; ++n )
+        {
+            xml::node::iterator i = doc.get_root_node().insert(xml::node("item", "text"));
+            i->get_attributes().insert("id", std::to_string(n).c_str());
+        }
+
+        std::string output;
+        doc.save_to_string(output);
+        CHECK( output == expected );
+
+#ifdef XMLWRAPP_TEST_XSLT
+        // the stylesheet gets a copy of the arena document
+        xml::tree_parser style_parser(test_file_path("xslt/data/03a.xsl").c_str(),
+                                      xml::document::arena_allocation);
+        xslt::stylesheet style(std::move(style_parser.get_document()));
+
+        xml::document result;
+        xml::error_messages errors;
+        CHECK( style.apply(doc, result, errors) );
+#endif
+    }
+
+    CHECK( counting.get_statistics().bytes_in_use == before.bytes_in_use );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "allocator/arena_threads", "[allocator][arena][threads]" )
+{
+    const std::string xml = make_big_document();
+    const std::string expected = parse_and_save(xml);
+
+    xml::pool_allocator pool;
+    use_allocator use(pool);
+
+    const int num_threads = 4;
+    const int num_iterations = 20;
+
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::document doc(xml.data(), xml.size(), xml::document::arena_allocation);
+                xml::node& root = doc.get_root_node();
+                root.erase(root.begin());
+                root.push_back(xml::node("item", "text"));
+
+                xml::document normal(xml::node("normal"));
+                normal.get_root_node().push_back(*root.begin());
+
+                doc = xml::document();
+
+                if ( normal.get_root_node().begin()->get_attributes().size() != 1 )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        INFO( "thread " << t );
+        CHECK( failures[t] == 0 );
+    }
+
+    CHECK( parse_and_save(xml) == expected );
+}
@@ -218,6 +218,71 @@ TEST_CASE_METHOD( SrcdirConfig, "attributes/dtd_implied", "[attributes]" )
 }
 
 
+/*
+ * Test xml::attributes::find() overload taking namespace URI.
+ */
+
+TEST_CASE( "attributes/find_ns", "[attributes][ns]" )
+{
+    const char xml[] =
+        "<!DOCTYPE root [\n"
+        "<!ATTLIST root a:z CDATA 'default'>\n"
+        "]>\n"
+        "<root xmlns:a='http://example.com/a' x='1' a:x='2' a:y='3'/>";
+    xml::document doc(xml, sizeof(xml) - 1);
+    xml::attributes& attrs = doc.get_root_node().get_attributes();
+
+    xml::attributes::iterator i = attrs.find("x", "http://example.com/a");
+    REQUIRE( i != attrs.end() );
+    CHECK_THAT( i->get_value(), Catch::Matchers::Equals("2") );
+
+    i = attrs.find("x", nullptr);
+    REQUIRE( i != attrs.end() );
+    CHECK_THAT( i->get_value(), Catch::Matchers::Equals("1") );
+
+    const xml::attributes& cattrs = attrs;
+    CHECK( cattrs.find("y", "") == cattrs.end() );
+    CHECK( cattrs.find("y", "http://example.com/b") == cattrs.end() );
+
+    xml::attributes::const_iterator ci = cattrs.find("z", "http://example.com/a");
+    REQUIRE( ci != cattrs.end() );
+    CHECK_THAT( ci->get_value(), Catch::Matchers::Equals("default") );
+}
+
+
+/*
+ * Test xml::attributes::find() overload taking xml::qname.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "attributes/find_qname", "[attributes][qname]" )
+{
+    const char xml[] =
+        "<root xmlns:a='http://example.com/a' x='1' a:x='2' a:y='3'/>";
+    xml::document doc(xml, sizeof(xml) - 1);
+    const xml::attributes& attrs = doc.get_root_node().get_attributes();
+
+    xml::attributes::const_iterator i = attrs.find(xml::qname(doc, "x"));
+    REQUIRE( i != attrs.end() );
+    CHECK_THAT( i->get_value(), Catch::Matchers::Equals("1") );
+
+    i = attrs.find(xml::qname(doc, "x", "http://example.com/a"));
+    REQUIRE( i != attrs.end() );
+    CHECK_THAT( i->get_value(), Catch::Matchers::Equals("2") );
+
+    CHECK( attrs.find(xml::qname(doc, "y")) != attrs.end() );
+    CHECK( attrs.find(xml::qname(doc, "y", nullptr)) == attrs.end() );
+    CHECK( attrs.find(xml::qname(doc, "z")) == attrs.end() );
+
+    xml::tree_parser parser(test_file_path("attributes/data/09.xml").c_str());
+    xml::document& doc_dtd = parser.get_document();
+    xml::attributes& attrs_dtd = doc_dtd.get_root_node().get_attributes();
+
+    xml::attributes::iterator j = attrs_dtd.find(xml::qname(doc_dtd, "two"));
+    REQUIRE( j != attrs_dtd.end() );
+    CHECK_THAT( j->get_value(), Catch::Matchers::Equals("two") );
+}
+
+
 /*
  * Test to see if the xml::attributes copy constructor works.
  */
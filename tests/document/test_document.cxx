@@ -504,3 +504,91 @@ TEST_CASE_METHOD( SrcdirConfig, "document/save_to_file_gzip", "[document]" )
     std::ifstream stream(test_file.get_name());
     CHECK( is_same_as_file(read_file_into_string(stream), "document/data/15.out") );
 }
+
+
+/*
+ * This test checks validating documents against a DTD parsed once.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "document/dtd_validate", "[document][dtd]" )
+{
+    xml::dtd dtd(test_file_path("document/data/22.dtd").c_str());
+
+    xml::tree_parser valid(test_file_path("document/data/22a.xml").c_str());
+    xml::tree_parser invalid(test_file_path("document/data/22b.xml").c_str());
+
+    // the same DTD can be used many times
+    for ( int n = 0; n < 3; ++n )
+    {
+        CHECK( dtd.validate(valid.get_document()) );
+        CHECK_THROWS_AS( dtd.validate(invalid.get_document()), xml::exception );
+    }
+
+    xml::error_messages log;
+    CHECK( !dtd.validate(invalid.get_document(), log) );
+    CHECK( log.print().find("other") != std::string::npos );
+
+    // validating doesn't attach the DTD to the document
+    CHECK( !valid.get_document().has_external_subset() );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "document/dtd_from_memory", "[document][dtd]" )
+{
+    const std::string dtd_text = read_file_into_string("document/data/22.dtd");
+
+    xml::dtd dtd(dtd_text.c_str(), dtd_text.size());
+
+    xml::tree_parser parser(test_file_path("document/data/22a.xml").c_str());
+    CHECK( dtd.validate(parser.get_document()) );
+
+    const std::string bad("<!ELEMENT root (");
+    CHECK_THROWS_AS( xml::dtd(bad.c_str(), bad.size()), xml::exception );
+
+    CHECK_THROWS_AS( xml::dtd(test_file_path("document/data/nonexistent.dtd").c_str()),
+                     xml::exception );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "document/set_external_subset", "[document][dtd]" )
+{
+    auto dtd = std::make_shared<xml::dtd>(test_file_path("document/data/22.dtd").c_str());
+
+    xml::tree_parser parser1(test_file_path("document/data/22a.xml").c_str());
+    xml::tree_parser parser2(test_file_path("document/data/22b.xml").c_str());
+
+    {
+        xml::document doc1(parser1.get_document());
+        xml::document doc2(parser2.get_document());
+
+        doc1.set_external_subset(dtd);
+        doc2.set_external_subset(dtd);
+
+        CHECK( doc1.has_external_subset() );
+        CHECK( doc1.validate() );
+        CHECK( !doc2.validate() );
+
+        // default attribute values come from the DTD
+        xml::node::iterator item = doc1.get_root_node().find("item");
+        REQUIRE( item != doc1.get_root_node().end() );
+        xml::attributes& attrs = item->get_attributes();
+        xml::attributes::const_iterator i = attrs.find("kind");
+        REQUIRE( i != attrs.end() );
+        CHECK( std::string(i->get_value()) == "default" );
+
+        // replacing the subset with the one parsed by validate() works too
+        CHECK( doc2.validate(test_file_path("document/data/22.dtd").c_str()) == false );
+        CHECK( doc1.validate(test_file_path("document/data/22.dtd").c_str()) );
+
+        doc2.set_external_subset(nullptr);
+        CHECK( !doc2.has_external_subset() );
+
+        doc1.set_external_subset(dtd);
+
+        // the copy doesn't use the DTD
+        xml::document doc3(doc1);
+        CHECK( !doc3.has_external_subset() );
+    }
+
+    // the DTD is still usable after the documents using it were destroyed
+    CHECK( dtd.use_count() == 1 );
+    CHECK( dtd->validate(parser1.get_document()) );
+}
@@ -230,3 +230,251 @@ TEST_CASE_METHOD( SrcdirConfig, "event/stop_on_error_in_cdata", "[event]" )
     do_test_parser("cdata", true);
     do_test_parser("cdata", false);
 }
+
+
+/*
+ * test using a shared names dictionary with the event parser.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "event/shared_dictionary", "[event]" )
+{
+    struct test_parser : public xml::event_parser
+    {
+        explicit test_parser(xml::name_dictionary& dict) : xml::event_parser(dict) {}
+
+        bool start_element(const std::string& name, const xml::event_parser::attrs_type&) override
+        {
+            elements_ += name + " ";
+            return true;
+        }
+
+        bool end_element(const std::string&) override
+        {
+            return true;
+        }
+
+        bool text(const std::string&) override
+        {
+            return true;
+        }
+
+        std::string elements_;
+    };
+
+    xml::name_dictionary dict;
+
+    test_parser parser(dict);
+    CHECK( parser.parse_file(test_file_path("event/data/01.xml").c_str()) );
+    CHECK( !parser.elements_.empty() );
+
+    CHECK( dict.find("root") != nullptr );
+}
+
+
+/*
+ * test that qualified names and namespace declarations are reported as is
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "event/namespaces", "[event]" )
+{
+    struct test_parser : public xml::event_parser
+    {
+        bool start_element(const std::string& name, const xml::event_parser::attrs_type& attrs) override
+        {
+            elements_ += name + " ";
+            for ( const auto& a : attrs )
+                elements_ += a.first + "=" + a.second + " ";
+            return true;
+        }
+
+        bool end_element(const std::string& name) override
+        {
+            elements_ += "/" + name + " ";
+            return true;
+        }
+
+        bool text(const std::string&) override
+        {
+            return true;
+        }
+
+        std::string elements_;
+    };
+
+    test_parser parser;
+    const std::string xml(
+        "<p:root xmlns:p='urn:p' xmlns='urn:d' p:a='1' b='2'><p:child/><q:undeclared/></p:root>");
+    CHECK( parser.parse_chunk(xml.c_str(), xml.size()) );
+    CHECK( parser.parse_finish() );
+
+    CHECK( parser.elements_ ==
+           "p:root b=2 p:a=1 xmlns=urn:d xmlns:p=urn:p "
+           "p:child /p:child q:undeclared /q:undeclared /p:root " );
+}
+
+
+/*
+ * test validating the document against a schema while parsing it
+ */
+
+namespace
+{
+
+struct counting_parser : public xml::event_parser
+{
+    bool start_element(const std::string&, const xml::event_parser::attrs_type&) override
+    {
+        ++elements_;
+        return true;
+    }
+
+    bool end_element(const std::string&) override
+    {
+        return true;
+    }
+
+    bool text(const std::string&) override
+    {
+        return true;
+    }
+
+    int elements_{0};
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD( SrcdirConfig, "event/schema_valid", "[event][schema]" )
+{
+    xml::tree_parser schema_parser(test_file_path("schema/data/schema.xsd").c_str());
+    xml::schema schema(schema_parser.get_document());
+
+    counting_parser parser;
+    parser.set_schema(schema);
+
+    CHECK( parser.parse_file(test_file_path("schema/data/valid.xml").c_str()) );
+    CHECK( parser.elements_ == 3 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "event/schema_invalid", "[event][schema]" )
+{
+    xml::tree_parser schema_parser(test_file_path("schema/data/schema.xsd").c_str());
+    xml::schema schema(schema_parser.get_document());
+
+    xml::error_messages log;
+
+    counting_parser parser;
+    parser.set_schema(schema, log);
+
+    CHECK( !parser.parse_file(test_file_path("schema/data/invalid.xml").c_str()) );
+    CHECK( parser.elements_ == 3 );
+
+    CHECK( log.has_errors() );
+    CHECK( parser.get_error_message().find("CCC") != std::string::npos );
+    CHECK( log.print().find("line 2") != std::string::npos );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "event/schema_invalid_throws", "[event][schema]" )
+{
+    xml::tree_parser schema_parser(test_file_path("schema/data/schema.xsd").c_str());
+    xml::schema schema(schema_parser.get_document());
+
+    counting_parser parser;
+    parser.set_schema(schema);
+
+    CHECK_THROWS_AS( parser.parse_file(test_file_path("schema/data/invalid.xml").c_str()),
+                     xml::exception );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "event/schema_stop_on_first_error", "[event][schema]" )
+{
+    xml::tree_parser schema_parser(test_file_path("schema/data/numbers.xsd").c_str());
+    xml::schema schema(schema_parser.get_document());
+
+    xml::error_messages log;
+    log.stop_on_first_error();
+
+    counting_parser parser;
+    parser.set_schema(schema, log);
+
+    CHECK( !parser.parse_file(test_file_path("schema/data/numbers-invalid.xml").c_str()) );
+
+    // parsing stops after the first invalid element
+    CHECK( parser.elements_ < 7 );
+
+    CHECK( log.messages().size() == 1 );
+    CHECK( log.limit_reached() );
+    CHECK( parser.get_error_message().find("one") != std::string::npos );
+
+    // the errors are reported only once
+    CHECK( !parser.parse_finish() );
+    CHECK( log.messages().size() == 1 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "event/schema_after_start", "[event][schema]" )
+{
+    xml::tree_parser schema_parser(test_file_path("schema/data/schema.xsd").c_str());
+    xml::schema schema(schema_parser.get_document());
+
+    counting_parser parser;
+    const std::string chunk("<AAA>");
+    CHECK( parser.parse_chunk(chunk.c_str(), chunk.size()) );
+
+    CHECK_THROWS_AS( parser.set_schema(schema), xml::exception );
+}
+
+
+/*
+ * test validating the document against a RelaxNG schema while parsing it
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "event/relaxng_valid", "[event][relaxng]" )
+{
+    xml::tree_parser schema_parser(test_file_path("relaxng/data/stream.rng").c_str());
+    xml::relaxng schema(schema_parser.get_document());
+
+    counting_parser parser;
+    parser.set_relaxng(schema);
+
+    CHECK( parser.parse_file(test_file_path("relaxng/data/stream-valid.xml").c_str()) );
+    CHECK( parser.elements_ == 5 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "event/relaxng_invalid", "[event][relaxng]" )
+{
+    xml::tree_parser schema_parser(test_file_path("relaxng/data/stream.rng").c_str());
+    xml::relaxng schema(schema_parser.get_document());
+
+    counting_parser parser;
+    parser.set_relaxng(schema);
+
+    CHECK_THROWS_AS( parser.parse_file(test_file_path("relaxng/data/stream-invalid.xml").c_str()),
+                     xml::exception );
+
+    xml::error_messages log;
+
+    counting_parser parser2;
+    parser2.set_relaxng(schema, log);
+
+    CHECK( !parser2.parse_file(test_file_path("relaxng/data/stream-invalid.xml").c_str()) );
+    CHECK( parser2.elements_ == 4 );
+    CHECK( log.has_errors() );
+}
+
+// This schema uses data types, which can't be validated in streaming mode and
+// require building the element subtree.
+TEST_CASE_METHOD( SrcdirConfig, "event/relaxng_subtree", "[event][relaxng]" )
+{
+    xml::tree_parser schema_parser(test_file_path("relaxng/data/schema.rng").c_str());
+    xml::relaxng schema(schema_parser.get_document());
+
+    counting_parser parser;
+    parser.set_relaxng(schema);
+    CHECK( parser.parse_file(test_file_path("relaxng/data/valid.xml").c_str()) );
+
+    xml::error_messages log;
+
+    counting_parser parser2;
+    parser2.set_relaxng(schema, log);
+    CHECK( !parser2.parse_file(test_file_path("relaxng/data/nonvalid.xml").c_str()) );
+    CHECK( log.print().find("CCC") != std::string::npos );
+}
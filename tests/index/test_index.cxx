@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) 2026 Vaclav Slavik <vslavik@gmail.com>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../test.h"
+
+namespace
+{
+
+const char XML_ITEMS[] =
+    "<catalog>"
+    "<item sku='a1'><name>First</name></item>"
+    "<group><item sku='b2'/><item sku='a1'/></group>"
+    "<other sku='c3'/>"
+    "</catalog>";
+
+xml::document parse_items()
+{
+    return xml::document(XML_ITEMS, sizeof(XML_ITEMS) - 1);
+}
+
+} // anonymous namespace
+
+/*
+ * Test finding elements using an attribute index.
+ */
+
+TEST_CASE( "index/attribute", "[index]" )
+{
+    xml::document doc(parse_items());
+    const xml::attribute_index by_sku(doc, "item", "sku");
+
+    CHECK( by_sku.size() == 2 );
+    CHECK( by_sku.count("a1") == 2 );
+    CHECK( by_sku.count("b2") == 1 );
+    CHECK( by_sku.count("c3") == 0 );
+
+    xml::node::iterator i = by_sku.find("a1");
+    REQUIRE( i != by_sku.end() );
+    CHECK( i->find("name") != i->end() );
+
+    CHECK( by_sku.find("c3") == by_sku.end() );
+
+    const xml::attribute_index any_sku(doc, nullptr, "sku");
+    CHECK( any_sku.size() == 3 );
+    i = any_sku.find("c3");
+    REQUIRE( i != any_sku.end() );
+    CHECK_THAT( i->get_name(), Catch::Matchers::Equals("other") );
+}
+
+/*
+ * Test that the index is updated when the document is modified.
+ */
+
+TEST_CASE( "index/attribute_update", "[index]" )
+{
+    xml::document doc(parse_items());
+    xml::attribute_index by_sku(doc, "item", "sku");
+    xml::attribute_index snapshot(doc, "item", "sku", xml::attribute_index::snapshot);
+
+    xml::node& root = doc.get_root_node();
+
+    xml::node new_item("item");
+    new_item.get_attributes().insert("sku", "d4");
+    xml::node::iterator added = root.insert(new_item);
+    CHECK( by_sku.find("d4") == added );
+    CHECK( snapshot.find("d4") == snapshot.end() );
+
+    added->get_attributes().insert("sku", "e5");
+    CHECK( by_sku.count("d4") == 0 );
+    CHECK( by_sku.find("e5") == added );
+
+    added->set_name("renamed");
+    CHECK( by_sku.count("e5") == 0 );
+
+    // Erasing the parent removes its children from the index too.
+    xml::node::iterator group = root.find("group");
+    REQUIRE( group != root.end() );
+    root.erase(group);
+    CHECK( by_sku.count("a1") == 1 );
+    CHECK( by_sku.count("b2") == 0 );
+
+    xml::node::iterator first = root.find("item");
+    REQUIRE( first != root.end() );
+    xml::node::iterator replaced = root.replace(first, new_item);
+    CHECK( by_sku.count("a1") == 0 );
+    CHECK( by_sku.find("d4") == replaced );
+
+    replaced->get_attributes().erase("sku");
+    CHECK( by_sku.empty() );
+
+    replaced->set_content("<item sku='f6'/>");
+    CHECK( by_sku.empty() );
+    root.clear();
+    CHECK( by_sku.empty() );
+}
+
+/*
+ * Test that an index survives the destruction of its document.
+ */
+
+TEST_CASE( "index/attribute_document_destroyed", "[index]" )
+{
+    std::unique_ptr<xml::document> doc(new xml::document(parse_items()));
+    xml::attribute_index by_sku(*doc, "item", "sku");
+    CHECK( by_sku.count("a1") == 2 );
+
+    doc.reset();
+    CHECK( by_sku.empty() );
+    CHECK( by_sku.find("a1") == by_sku.end() );
+}
+
+/*
+ * Test using the IDs defined by the DTD and xml:id attributes.
+ */
+
+TEST_CASE( "index/ids", "[index]" )
+{
+    const char xml[] =
+        "<!DOCTYPE root [\n"
+        "<!ATTLIST elem key ID #IMPLIED>\n"
+        "]>\n"
+        "<root><elem key='k1'/><elem key='k2'/><other xml:id='x1'/></root>";
+    xml::document doc(xml, sizeof(xml) - 1);
+    xml::attribute_index ids(doc, xml::attribute_index::use_ids);
+
+    CHECK( ids.size() == 3 );
+    CHECK( ids.count("k1") == 1 );
+
+    xml::node::iterator i = ids.find("x1");
+    REQUIRE( i != ids.end() );
+    CHECK_THAT( i->get_name(), Catch::Matchers::Equals("other") );
+
+    xml::node& root = doc.get_root_node();
+    xml::node elem("elem");
+    elem.get_attributes().insert("key", "k3");
+    xml::node::iterator added = root.insert(elem);
+    CHECK( ids.find("k3") == added );
+
+    root.erase(added);
+    CHECK( ids.count("k3") == 0 );
+    CHECK( ids.size() == 3 );
+}
+
+/*
+ * Test using xml:id attributes of a document created programmatically.
+ */
+
+TEST_CASE( "index/ids_created", "[index]" )
+{
+    xml::node root("root");
+    xml::node child("child");
+    child.get_attributes().insert("xml:id", "c1");
+    root.push_back(child);
+    xml::document doc(root);
+
+    xml::attribute_index ids(doc, xml::attribute_index::use_ids);
+    xml::node::iterator i = ids.find("c1");
+    REQUIRE( i != ids.end() );
+    CHECK_THAT( i->get_name(), Catch::Matchers::Equals("child") );
+}
+
+/*
+ * Tests for the child elements index.
+ */
+
+namespace
+{
+
+// Return the string containing the values of "n" attribute of all children
+// with the given name, found without using find() or elements().
+std::string scan_children(const xml::node& parent, const char *name)
+{
+    std::string s;
+    for ( xml::node::const_iterator i = parent.begin(); i != parent.end(); ++i )
+    {
+        if ( i->get_type() == xml::node::type_element && std::strcmp(i->get_name(), name) == 0 )
+            s += i->get_attributes().find("n")->get_value();
+    }
+    return s;
+}
+
+// Same as scan_children() but using elements().
+std::string get_elements(const xml::node& parent, const char *name)
+{
+    std::string s;
+    for ( auto const& n : parent.elements(name) )
+        s += n.get_attributes().find("n")->get_value();
+    return s;
+}
+
+void check_children(const xml::node& parent, const char *name)
+{
+    INFO( "name=" << name );
+
+    const std::string expected = scan_children(parent, name);
+    CHECK( get_elements(parent, name) == expected );
+
+    xml::node::const_iterator i = parent.find(name);
+    if ( expected.empty() )
+    {
+        CHECK( i == parent.end() );
+    }
+    else
+    {
+        REQUIRE( i != parent.end() );
+        CHECK( i->get_attributes().find("n")->get_value()[0] == expected[0] );
+    }
+}
+
+void check_all_children(const xml::node& parent)
+{
+    check_children(parent, "a");
+    check_children(parent, "b");
+    check_children(parent, "c");
+}
+
+xml::node make_child(const char *name, const char *n)
+{
+    xml::node child(name);
+    child.get_attributes().insert("n", n);
+    return child;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "index/children", "[index]" )
+{
+    const char xml[] =
+        "<root>"
+        "<a n='1'/><b n='2'/><a n='3'/>text<a n='4'/><b n='5'/>"
+        "</root>";
+    xml::document doc(xml, sizeof(xml) - 1);
+    CHECK( !doc.has_child_index() );
+
+    doc.enable_child_index();
+    CHECK( doc.has_child_index() );
+
+    xml::node& root = doc.get_root_node();
+    check_all_children(root);
+
+    // Append at the end.
+    root.push_back(make_child("a", "6"));
+    root.push_back(make_child("c", "7"));
+    check_all_children(root);
+
+    // Insert in the middle.
+    root.insert(root.find("b"), make_child("a", "0"));
+    check_all_children(root);
+
+    // Erase the first, last and middle elements with the same name.
+    xml::nodes_view as(root.elements("a"));
+    xml::nodes_view::iterator i = as.erase(as.begin());
+    ++i;
+    i = as.erase(i);
+    CHECK( get_elements(root, "a") == "046" );
+    check_all_children(root);
+
+    xml::node::iterator last_a = root.find("a");
+    for ( xml::node::iterator j = last_a; j != root.end(); ++j )
+    {
+        if ( j->get_type() == xml::node::type_element && std::strcmp(j->get_name(), "a") == 0 )
+            last_a = j;
+    }
+    root.erase(last_a);
+    check_all_children(root);
+
+    // Rename.
+    root.find("b")->set_name("c");
+    check_all_children(root);
+
+    // Replace.
+    root.replace(root.find("c"), make_child("b", "8"));
+    check_all_children(root);
+
+    // Modifying attributes doesn't affect the index.
+    root.find("b")->get_attributes().insert("n", "9");
+    check_all_children(root);
+
+    // Reorder.
+    root.sort("a", "n");
+    check_all_children(root);
+
+    // Move under another element.
+    xml::node::iterator b = root.find("b");
+    b->push_back(make_child("a", "x"));
+    check_all_children(*b);
+    b->find("a")->move_under(root);
+    check_all_children(*b);
+    check_all_children(root);
+
+    // Change all children at once.
+    root.set_content("new content");
+    check_all_children(root);
+
+    doc.enable_child_index(false);
+    CHECK( !doc.has_child_index() );
+}
+
+TEST_CASE( "index/children_nested", "[index]" )
+{
+    const char xml[] =
+        "<root xmlns:x='http://example.com/x'>"
+        "<a n='1'><b n='2'/><b n='3'/></a>"
+        "<x:a n='4'><b n='5'/></x:a>"
+        "</root>";
+    xml::document doc(xml, sizeof(xml) - 1);
+    doc.enable_child_index();
+
+    xml::node& root = doc.get_root_node();
+    CHECK( root.elements("a").size() == 2 );
+    CHECK( root.elements("a", nullptr).size() == 1 );
+    CHECK( root.elements(xml::qname(doc, "a", "http://example.com/x")).size() == 1 );
+
+    xml::node::iterator a = root.find("a", "http://example.com/x");
+    REQUIRE( a != root.end() );
+    CHECK( get_elements(*a, "b") == "5" );
+
+    // Removing a subtree must remove the index of its children too, as their
+    // memory may be reused for other nodes.
+    a = root.find("a");
+    check_all_children(*a);
+    check_children(*a, "b");
+    root.erase(a);
+    CHECK( root.elements("a").size() == 1 );
+
+    for ( int n = 0; n < 10; ++n )
+    {
+        xml::node::iterator added = root.insert(root.begin(), make_child("a", "a"));
+        added->push_back(make_child("b", "b"));
+        check_children(*added, "b");
+        check_children(root, "a");
+    }
+}
+
+/*
+ * Test that the child index works with big documents.
+ */
+
+TEST_CASE( "index/children_wide", "[index]" )
+{
+    xml::document doc(xml::node("root"));
+    doc.enable_child_index();
+
+    xml::node& root = doc.get_root_node();
+
+    const int count = 10000;
+    for ( int n = 0; n < count; ++n )
+        root.push_back(xml::node(n % 2 ? "odd" : "even"));
+
+    // This would take quadratic time without index.
+    int found = 0;
+    for ( int n = 0; n < count; ++n )
+    {
+        if ( root.find("odd") != root.end() )
+            ++found;
+    }
+    CHECK( found == count );
+
+    CHECK( root.elements("odd").size() == count / 2 );
+
+    // And erasing all elements one by one should be fast too.
+    xml::nodes_view evens(root.elements("even"));
+    for ( xml::nodes_view::iterator i = evens.begin(); i != evens.end(); )
+        i = evens.erase(i);
+
+    CHECK( root.size() == count / 2 );
+    CHECK( root.find("even") == root.end() );
+}
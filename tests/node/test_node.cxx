@@ -159,6 +159,135 @@ TEST_CASE_METHOD( SrcdirConfig, "node/elements", "[node]" )
 }
 
 
+/*
+ * Test finding elements using xml::qname, which takes namespaces into account.
+ */
+
+static const char XML_WITH_NAMESPACES[] =
+    "<root xmlns:a='http://example.com/a' xmlns:b='http://example.com/b'>"
+    "<item id='1'/><a:item id='2'/><b:item id='3'/><other/><a:item id='4'/>"
+    "</root>";
+
+TEST_CASE( "node/find_qname", "[node][qname]" )
+{
+    xml::document doc(XML_WITH_NAMESPACES, sizeof(XML_WITH_NAMESPACES) - 1);
+    xml::node& root = doc.get_root_node();
+
+    const xml::qname any_item(doc, "item");
+    CHECK( any_item.matches_any_namespace() );
+    CHECK( any_item.get_namespace() == nullptr );
+
+    xml::node::iterator i = root.find(any_item);
+    REQUIRE( i != root.end() );
+    CHECK_THAT( i->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("1") );
+
+    const xml::qname a_item(doc, "item", "http://example.com/a");
+    CHECK_THAT( a_item.get_namespace(), Catch::Matchers::Equals("http://example.com/a") );
+
+    i = root.find(a_item);
+    REQUIRE( i != root.end() );
+    CHECK_THAT( i->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("2") );
+
+    i = root.find(a_item, ++i);
+    REQUIRE( i != root.end() );
+    CHECK_THAT( i->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("4") );
+
+    const xml::qname no_ns_item(doc, "item", nullptr);
+    CHECK( !no_ns_item.matches_any_namespace() );
+
+    const xml::node& croot = root;
+    xml::node::const_iterator ci = croot.find(no_ns_item);
+    REQUIRE( ci != croot.end() );
+    CHECK_THAT( ci->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("1") );
+    CHECK( croot.find(no_ns_item, ++ci) == croot.end() );
+
+    CHECK( root.find(xml::qname(doc, "item", "http://example.com/c")) == root.end() );
+    CHECK( root.find(xml::qname(doc, "unknown")) == root.end() );
+}
+
+TEST_CASE( "node/elements_qname", "[node][qname]" )
+{
+    xml::document doc(XML_WITH_NAMESPACES, sizeof(XML_WITH_NAMESPACES) - 1);
+    xml::node& root = doc.get_root_node();
+
+    CHECK( root.elements(xml::qname(doc, "item")).size() == 4u );
+    CHECK( root.elements(xml::qname(doc, "item", "")).size() == 1u );
+
+    std::string ids;
+    const xml::node& croot = root;
+    for (auto const& n : croot.elements(xml::qname(doc, "item", "http://example.com/a")))
+        ids += n.get_attributes().find("id")->get_value();
+    CHECK( ids == "24" );
+
+    // The name is resolved when it's created, but must keep working for the
+    // nodes added later.
+    const xml::qname b_item(doc, "item", "http://example.com/b");
+    xml::node new_item("item");
+    new_item.set_namespace("http://example.com/b");
+    root.push_back(new_item);
+    CHECK( root.elements(b_item).size() == 2u );
+}
+
+TEST_CASE( "node/find_ns", "[node][ns]" )
+{
+    xml::document doc(XML_WITH_NAMESPACES, sizeof(XML_WITH_NAMESPACES) - 1);
+    xml::node& root = doc.get_root_node();
+
+    xml::node::iterator i = root.find("item", "http://example.com/b");
+    REQUIRE( i != root.end() );
+    CHECK_THAT( i->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("3") );
+
+    const xml::node& croot = root;
+    xml::node::const_iterator ci = croot.find("item", nullptr);
+    REQUIRE( ci != croot.end() );
+    CHECK_THAT( ci->get_attributes().find("id")->get_value(), Catch::Matchers::Equals("1") );
+
+    CHECK( root.find("other", "http://example.com/a") == root.end() );
+    CHECK( root.find("other", "") != root.end() );
+}
+
+TEST_CASE( "node/elements_ns", "[node][ns]" )
+{
+    xml::document doc(XML_WITH_NAMESPACES, sizeof(XML_WITH_NAMESPACES) - 1);
+    xml::node& root = doc.get_root_node();
+
+    std::string ids;
+    for (auto const& n : root.elements("item", "http://example.com/a"))
+        ids += n.get_attributes().find("id")->get_value();
+    CHECK( ids == "24" );
+
+    const xml::node& croot = root;
+    CHECK( croot.elements("item", nullptr).size() == 1u );
+    CHECK( croot.elements("item", "http://example.com/c").empty() );
+}
+
+TEST_CASE( "node/qname_other_document", "[node][qname]" )
+{
+    xml::document doc(XML_WITH_NAMESPACES, sizeof(XML_WITH_NAMESPACES) - 1);
+
+    // Names created for one document can be used with another one, including
+    // the one which doesn't use a dictionary at all.
+    const xml::qname item(doc, "item");
+
+    xml::document doc2(xml::node("root"));
+    doc2.get_root_node().push_back(xml::node("other"));
+    doc2.get_root_node().push_back(xml::node("item"));
+    CHECK( doc2.get_root_node().find(item) != doc2.get_root_node().end() );
+
+    // And names created for a document without a dictionary work too.
+    const xml::qname other(doc2, "other");
+    CHECK( doc.get_root_node().find(other) != doc.get_root_node().end() );
+
+    // Check that copies remain valid after the original object is destroyed.
+    xml::qname copy(other);
+    {
+        xml::qname tmp(doc, "item", "http://example.com/b");
+        copy = tmp;
+    }
+    CHECK( doc.get_root_node().elements(copy).size() == 1u );
+}
+
+
 /*
  * This test checks xml::node::elements (const char *name) const;
  */
@@ -32,6 +32,9 @@
 
 #include "../test.h"
 
+#include <thread>
+#include <vector>
+
 TEST_CASE_METHOD( SrcdirConfig, "relaxng/load_non_relaxng_file", "[relaxng]" )
 {
     xml::document sch_doc =
@@ -119,3 +122,103 @@ TEST_CASE_METHOD( SrcdirConfig, "relaxng/validate_nonvalid", "[relaxng]" )
     // supposed to occur before "BBB".
     CHECK( log.print().find("CCC") != std::string::npos );
 }
+
+
+TEST_CASE_METHOD( SrcdirConfig, "relaxng/validate_repeatedly", "[relaxng]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("relaxng/data/schema.rng").c_str()).get_document();
+    xml::relaxng sch(sch_doc);
+
+    xml::document valid =
+            xml::tree_parser(test_file_path("relaxng/data/valid.xml").c_str()).get_document();
+    xml::document invalid =
+            xml::tree_parser(test_file_path("relaxng/data/nonvalid.xml").c_str()).get_document();
+
+    // validation contexts are reused, check that this doesn't affect the
+    // results of the subsequent validations
+    for ( int n = 0; n < 3; ++n )
+    {
+        xml::error_messages log;
+        CHECK( !sch.validate(invalid, log) );
+        CHECK( log.has_errors() );
+
+        xml::error_messages log2;
+        CHECK( sch.validate(valid, log2) );
+        CHECK( !log2.has_errors() );
+    }
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "relaxng/validate_batch", "[relaxng][threads]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("relaxng/data/schema.rng").c_str()).get_document();
+    xml::relaxng sch(sch_doc);
+
+    const int num_docs = 50;
+
+    std::vector<xml::document> docs;
+    for ( int n = 0; n < num_docs; ++n )
+    {
+        const char *name = n % 5 == 3 ? "relaxng/data/nonvalid.xml" : "relaxng/data/valid.xml";
+        docs.push_back(xml::tree_parser(test_file_path(name).c_str()).get_document());
+    }
+
+    const std::vector<xml::error_messages> results = sch.validate_batch(docs.begin(), docs.end(), 4);
+    REQUIRE( results.size() == num_docs );
+
+    for ( int n = 0; n < num_docs; ++n )
+    {
+        INFO( "document " << n );
+        CHECK( results[n].has_errors() == (n % 5 == 3) );
+    }
+
+    // using a single thread works too
+    CHECK( sch.validate_batch(docs.begin(), docs.begin() + 4, 1)[3].has_errors() );
+    CHECK( sch.validate_batch(std::vector<const xml::document*>()).empty() );
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "relaxng/validate_concurrently", "[relaxng][threads]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("relaxng/data/schema.rng").c_str()).get_document();
+    const xml::relaxng sch(sch_doc);
+
+    const int num_threads = 4;
+    const int num_iterations = 50;
+
+    // Catch assertions can't be used from multiple threads, so just count
+    // the failures in each thread and check them in the main one.
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            // Each thread must use its own documents.
+            xml::document valid =
+                    xml::tree_parser(test_file_path("relaxng/data/valid.xml").c_str()).get_document();
+            xml::document invalid =
+                    xml::tree_parser(test_file_path("relaxng/data/nonvalid.xml").c_str()).get_document();
+
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::error_messages errors;
+                if ( !sch.validate(valid, errors) || errors.has_errors() )
+                    ++failures[t];
+
+                xml::error_messages errors2;
+                if ( sch.validate(invalid, errors2) || !errors2.has_errors() )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+        CHECK( failures[t] == 0 );
+}
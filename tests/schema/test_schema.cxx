@@ -32,6 +32,9 @@
 
 #include "../test.h"
 
+#include <thread>
+#include <vector>
+
 TEST_CASE_METHOD( SrcdirConfig, "schema/load_non_schema_file", "[schema]" )
 {
     xml::document sch_doc =
@@ -93,3 +96,135 @@ TEST_CASE_METHOD( SrcdirConfig, "schema/validate_fail", "[schema]" )
     CHECK( !sch.validate(doc, log) );
     CHECK( log.has_errors() );
 }
+
+
+TEST_CASE_METHOD( SrcdirConfig, "schema/validate_repeatedly", "[schema]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("schema/data/schema.xsd").c_str()).get_document();
+    xml::schema sch(sch_doc);
+
+    xml::document valid =
+            xml::tree_parser(test_file_path("schema/data/valid.xml").c_str()).get_document();
+    xml::document invalid =
+            xml::tree_parser(test_file_path("schema/data/invalid.xml").c_str()).get_document();
+
+    // validation contexts are reused, check that this doesn't affect the
+    // results of the subsequent validations
+    for ( int n = 0; n < 3; ++n )
+    {
+        xml::error_messages log;
+        CHECK( !sch.validate(invalid, log) );
+        CHECK( log.has_errors() );
+
+        xml::error_messages log2;
+        CHECK( sch.validate(valid, log2) );
+        CHECK( !log2.has_errors() );
+    }
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "schema/validate_batch", "[schema][threads]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("schema/data/schema.xsd").c_str()).get_document();
+    xml::schema sch(sch_doc);
+
+    const int num_docs = 50;
+
+    std::vector<xml::document> docs;
+    for ( int n = 0; n < num_docs; ++n )
+    {
+        const char *name = n % 5 == 3 ? "schema/data/invalid.xml" : "schema/data/valid.xml";
+        docs.push_back(xml::tree_parser(test_file_path(name).c_str()).get_document());
+    }
+
+    const std::vector<xml::error_messages> results = sch.validate_batch(docs.begin(), docs.end(), 4);
+    REQUIRE( results.size() == num_docs );
+
+    for ( int n = 0; n < num_docs; ++n )
+    {
+        INFO( "document " << n );
+        CHECK( results[n].has_errors() == (n % 5 == 3) );
+    }
+
+    // using a single thread works too
+    CHECK( sch.validate_batch(docs.begin(), docs.begin() + 4, 1)[3].has_errors() );
+    CHECK( sch.validate_batch(std::vector<const xml::document*>()).empty() );
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "schema/validate_concurrently", "[schema][threads]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("schema/data/schema.xsd").c_str()).get_document();
+    const xml::schema sch(sch_doc);
+
+    const int num_threads = 4;
+    const int num_iterations = 50;
+
+    // Catch assertions can't be used from multiple threads, so just count
+    // the failures in each thread and check them in the main one.
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            // Each thread must use its own documents.
+            xml::document valid =
+                    xml::tree_parser(test_file_path("schema/data/valid.xml").c_str()).get_document();
+            xml::document invalid =
+                    xml::tree_parser(test_file_path("schema/data/invalid.xml").c_str()).get_document();
+
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::error_messages errors;
+                if ( !sch.validate(valid, errors) || errors.has_errors() )
+                    ++failures[t];
+
+                xml::error_messages errors2;
+                if ( sch.validate(invalid, errors2) || !errors2.has_errors() )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+        CHECK( failures[t] == 0 );
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "schema/max_errors", "[schema]" )
+{
+    xml::document sch_doc =
+            xml::tree_parser(test_file_path("schema/data/numbers.xsd").c_str()).get_document();
+    xml::schema sch(sch_doc);
+
+    xml::document doc =
+            xml::tree_parser(test_file_path("schema/data/numbers-invalid.xml").c_str()).get_document();
+
+    xml::error_messages all;
+    CHECK( !sch.validate(doc, all) );
+    CHECK( all.messages().size() == 6 );
+    CHECK( !all.limit_reached() );
+    CHECK( all.get_suppressed_count() == 0 );
+
+    xml::error_messages log;
+    log.set_max_errors(2);
+    CHECK( !sch.validate(doc, log) );
+    CHECK( log.messages().size() == 2 );
+    CHECK( log.limit_reached() );
+    CHECK( log.get_suppressed_count() == 4 );
+    CHECK( log.print().find("(4 more messages suppressed)") != std::string::npos );
+
+    xml::error_messages first;
+    first.stop_on_first_error();
+    CHECK( !sch.validate(doc, first) );
+    CHECK( first.messages().size() == 1 );
+    CHECK( first.messages().front().message() == all.messages().front().message() );
+    CHECK( first.get_suppressed_count() == 5 );
+}
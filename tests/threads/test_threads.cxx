@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2011 Jonas Weber <mail@jonasw.de>
+ * All Rights Reserved
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Author nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../test.h"
+
+#ifdef XMLWRAPP_TEST_XSLT
+    #include <xsltwrapp/xsltwrapp.h>
+#endif
+
+#include <thread>
+#include <vector>
+
+/*
+ * These tests exercise the concurrency contract documented in the manual and
+ * are meant to be run under ThreadSanitizer, e.g. using "test_threads" CTest
+ * test which only runs the tests tagged with [threads].
+ */
+
+namespace
+{
+
+const int num_threads = 8;
+const int num_iterations = 20;
+
+// Run the given function in num_threads threads and return the total number
+// of failures it reported.
+//
+// Catch assertions can't be used from multiple threads, so the function must
+// just count its failures and they are checked in the main thread.
+template <typename F>
+int run_concurrently(F func)
+{
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+        threads.emplace_back([&func, &failures, t]() { func(failures[t]); });
+
+    for ( auto& t : threads )
+        t.join();
+
+    int total = 0;
+    for ( int f : failures )
+        total += f;
+    return total;
+}
+
+// Event parser just counting the elements.
+struct counting_parser : public xml::event_parser
+{
+    bool start_element(const std::string&, const attrs_type&) override
+    {
+        ++elements;
+        return true;
+    }
+
+    bool end_element(const std::string&) override { return true; }
+    bool text(const std::string&) override { return true; }
+
+    int elements{0};
+};
+
+} // anonymous namespace
+
+
+/*
+ * Test creating and destroying init objects while the other threads use the
+ * library.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "threads/init", "[threads]" )
+{
+    const std::string xml("<root><child/></root>");
+
+    const int failures = run_concurrently([&](int& failures)
+    {
+        for ( int n = 0; n < num_iterations; ++n )
+        {
+            xml::init init;
+#ifdef XMLWRAPP_TEST_XSLT
+            xslt::init xslt_init;
+#endif
+
+            xml::error_messages errors;
+            xml::tree_parser parser(xml.data(), xml.size(), errors);
+            if ( !parser || parser.get_document().get_root_node().get_name() != std::string("root") )
+                ++failures;
+        }
+    });
+
+    CHECK( failures == 0 );
+}
+
+
+/*
+ * Test using all the main parts of the library from several threads at once:
+ * each thread uses its own parsers and documents, but shares the compiled
+ * schemas and the stylesheet with all the others.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "threads/everything", "[threads]" )
+{
+    const xml::schema xsd(xml::tree_parser(test_file_path("schema/data/schema.xsd").c_str()).get_document());
+    const xml::relaxng rng(xml::tree_parser(test_file_path("relaxng/data/schema.rng").c_str()).get_document());
+    const xml::dtd dtd(test_file_path("document/data/22.dtd").c_str());
+
+#ifdef XMLWRAPP_TEST_XSLT
+    const xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+
+    std::string expected;
+    {
+        xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+        xml::document result;
+        xml::error_messages errors;
+        REQUIRE( style.apply(parser.get_document(), result, errors) );
+        result.save_to_string(expected);
+    }
+#endif
+
+    const int failures = run_concurrently([&](int& failures)
+    {
+        for ( int n = 0; n < num_iterations; ++n )
+        {
+            xml::error_messages errors;
+
+            // tree parsing and XPath
+            xml::tree_parser input(test_file_path("xslt/data/input.xml").c_str(), errors);
+            if ( !input )
+            {
+                ++failures;
+                continue;
+            }
+
+            xml::xpath_context ctxt(input.get_document());
+            if ( ctxt.evaluate("//child").size() != 2 )
+                ++failures;
+
+            // validation using the shared schemas
+            xml::tree_parser valid(test_file_path("schema/data/valid.xml").c_str(), errors);
+            xml::tree_parser invalid(test_file_path("schema/data/invalid.xml").c_str(), errors);
+            if ( !valid || !invalid )
+            {
+                ++failures;
+                continue;
+            }
+
+            if ( !xsd.validate(valid.get_document(), errors) )
+                ++failures;
+            if ( !rng.validate(valid.get_document(), errors) )
+                ++failures;
+
+            xml::error_messages invalid_errors;
+            if ( xsd.validate(invalid.get_document(), invalid_errors) )
+                ++failures;
+            if ( rng.validate(invalid.get_document(), invalid_errors) )
+                ++failures;
+            if ( !invalid_errors.has_errors() )
+                ++failures;
+
+            xml::tree_parser with_dtd(test_file_path("document/data/22a.xml").c_str(), errors);
+            if ( !with_dtd || !dtd.validate(with_dtd.get_document(), errors) )
+                ++failures;
+
+            // validation while parsing
+            counting_parser events;
+            events.set_schema(xsd, errors);
+            if ( !events.parse_file(test_file_path("schema/data/valid.xml").c_str()) ||
+                    events.elements != 3 )
+                ++failures;
+
+#ifdef XMLWRAPP_TEST_XSLT
+            // transformation using the shared stylesheet
+            xml::document result;
+            if ( !style.apply(input.get_document(), result, errors) )
+            {
+                ++failures;
+            }
+            else
+            {
+                std::string output;
+                result.save_to_string(output);
+                if ( output != expected )
+                    ++failures;
+            }
+#endif
+
+            if ( errors.has_errors() )
+                ++failures;
+        }
+    });
+
+    CHECK( failures == 0 );
+}
@@ -33,6 +33,9 @@
 
 #include "../test.h"
 
+#include <thread>
+#include <vector>
+
 namespace
 {
 
@@ -232,3 +235,216 @@ TEST_CASE_METHOD( SrcdirConfig, "tree/bad_ns_xml_data_no_throw", "[tree]" )
     xml::tree_parser parser(XMLDATA_BAD_NS.c_str(), XMLDATA_BAD_NS.size(), false);
     CHECK( !parser ); // failed
 }
+
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/max_errors", "[tree]" )
+{
+    // each of the undefined prefixes results in a separate error
+    const std::string data = "<root><a:x/><b:x/><c:x/><d:x/></root>";
+
+    xml::error_messages all;
+    xml::tree_parser parser_all(data.c_str(), data.size(), all);
+    CHECK( !parser_all );
+    CHECK( all.messages().size() == 4 );
+    CHECK( !all.limit_reached() );
+
+    xml::error_messages log;
+    log.set_max_errors(2);
+    xml::tree_parser parser(data.c_str(), data.size(), log);
+    CHECK( !parser );
+    CHECK( log.messages().size() == 2 );
+    CHECK( log.limit_reached() );
+
+    // parsing was stopped, so there are no more errors to suppress
+    CHECK( log.get_suppressed_count() == 0 );
+
+    xml::error_messages first;
+    first.stop_on_first_error();
+    xml::tree_parser parser_first(data.c_str(), data.size(), first);
+    CHECK( !parser_first );
+    CHECK( first.messages().size() == 1 );
+}
+
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/error_details", "[tree]" )
+{
+    const std::string data = "<root>\n  <a></b>\n</root>";
+
+    xml::error_messages log;
+    xml::tree_parser parser(data.c_str(), data.size(), log);
+    CHECK( !parser );
+
+    REQUIRE( !log.messages().empty() );
+
+    const xml::error_message& msg = log.messages().front();
+    CHECK( msg.type() == xml::error_message::type_error );
+    CHECK( msg.domain() == 1 );     // XML_FROM_PARSER
+    CHECK( msg.code() == 76 );      // XML_ERR_TAG_NAME_MISMATCH
+    CHECK( msg.level() == 3 );      // XML_ERR_FATAL
+    CHECK( msg.file().empty() );
+    CHECK( msg.line() == 2 );
+    CHECK( msg.column() > 0 );
+    CHECK( msg.str1() == "a" );
+
+    CHECK( msg.text().find("tag mismatch") != std::string::npos );
+    CHECK( msg.text().find("line 2, column") == std::string::npos );
+
+    CHECK( msg.message().find("XML fatal error 1.76: " + msg.text()) == 0 );
+    CHECK( msg.message().find("at line 2, column") != std::string::npos );
+
+    // messages not coming from libxml2 don't have any details
+    const xml::error_message plain("something failed", xml::error_message::type_warning);
+    CHECK( plain.message() == "something failed" );
+    CHECK( plain.text() == "something failed" );
+    CHECK( plain.domain() == 0 );
+    CHECK( plain.line() == 0 );
+}
+
+
+/*
+ * test sharing the names dictionary between several documents
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/shared_dictionary", "[tree]" )
+{
+    xml::name_dictionary dict;
+    CHECK( dict.get_threading_mode() == xml::name_dictionary::single_threaded );
+    CHECK( dict.find("root") == nullptr );
+
+    xml::tree_parser parser1(XMLDATA_GOOD.c_str(), XMLDATA_GOOD.size(), dict);
+    REQUIRE( is_parser_valid(parser1) );
+
+    const char* const root = dict.find("root");
+    REQUIRE( root != nullptr );
+    CHECK( dict.size() >= 8 );
+
+    xml::document doc2(XMLDATA_GOOD.c_str(), XMLDATA_GOOD.size(), dict);
+    xml::tree_parser parser3(test_file_path("tree/data/good.xml").c_str(), dict);
+    REQUIRE( is_parser_valid(parser3) );
+
+    // Names of all documents are shared and so can be compared as pointers.
+    CHECK( parser1.get_document().get_root_node().get_name() == root );
+    CHECK( doc2.get_root_node().get_name() == root );
+    CHECK( dict.intern("root") == root );
+
+    // The nodes added to the document also use the same dictionary.
+    xml::node& r = doc2.get_root_node();
+    r.push_back(xml::node("new"));
+    const char* last_name = nullptr;
+    for ( xml::node::const_iterator i = r.begin(); i != r.end(); ++i )
+        last_name = i->get_name();
+    CHECK( last_name == dict.find("new") );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/shared_dictionary_outlives", "[tree]" )
+{
+    std::unique_ptr<xml::document> doc;
+    {
+        xml::name_dictionary dict;
+        doc.reset(new xml::document(XMLDATA_GOOD.c_str(), XMLDATA_GOOD.size(), dict));
+    }
+
+    // The document keeps the dictionary alive.
+    CHECK( std::string(doc->get_root_node().get_name()) == "root" );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/shared_dictionary_thread_safe", "[tree]" )
+{
+    xml::name_dictionary dict(xml::name_dictionary::thread_safe);
+    const char* const a = dict.intern("a");
+    CHECK( dict.find("a") == a );
+
+    xml::document doc(XMLDATA_GOOD.c_str(), XMLDATA_GOOD.size(), dict);
+
+    // Names already present in the shared dictionary are reused...
+    CHECK( doc.get_root_node().begin()->get_name() == a );
+
+    // ... while the others are stored in a per-document dictionary.
+    CHECK( dict.find("root") == nullptr );
+
+    CHECK_THROWS_AS( dict.intern("b"), xml::exception );
+}
+
+
+/*
+ * test that the errors happening in different threads at the same time are
+ * reported to the correct handlers
+ */
+
+namespace
+{
+
+// Check that the messages mention the given marker followed by the given
+// thread number and never by any other one.
+bool mentions_only(const xml::error_messages& log, const std::string& marker, int t)
+{
+    const std::string id = std::to_string(t) + "_";
+
+    bool found = false;
+    for ( const auto& msg : log.messages() )
+    {
+        const std::string text = msg.message();
+
+        for ( auto pos = text.find(marker); pos != std::string::npos; pos = text.find(marker, pos + 1) )
+        {
+            if ( text.compare(pos + marker.size(), id.size(), id) != 0 )
+                return false;
+
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+} // anonymous namespace
+
+TEST_CASE_METHOD( SrcdirConfig, "tree/errors_concurrently", "[tree][threads]" )
+{
+    const int num_threads = 4;
+    const int num_iterations = 50;
+
+    // Catch assertions can't be used from multiple threads, so just count
+    // the failures in each thread and check them in the main one.
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            const std::string id = std::to_string(t) + "_";
+            const std::string data = "<root><elem_" + id + "></root>";
+            const std::string filename = "nonexistent_" + id + ".xml";
+            const std::string xpath = "//bad_" + id + "[";
+
+            xml::tree_parser good(XMLDATA_GOOD.c_str(), XMLDATA_GOOD.size());
+            xml::xpath_context ctxt(good.get_document());
+
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                // errors reported by the parser context
+                xml::error_messages log1;
+                xml::tree_parser parser1(data.c_str(), data.size(), log1);
+                if ( !!parser1 || !mentions_only(log1, "elem_", t) )
+                    ++failures[t];
+
+                // errors reported using the global handler
+                xml::error_messages log2;
+                xml::tree_parser parser2(filename.c_str(), log2);
+                if ( !!parser2 || !mentions_only(log2, "nonexistent_", t) )
+                    ++failures[t];
+
+                xml::error_messages log3;
+                ctxt.evaluate(xpath, log3);
+                if ( !mentions_only(log3, "bad_", t) )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+        CHECK( failures[t] == 0 );
+}
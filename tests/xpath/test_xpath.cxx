@@ -33,6 +33,8 @@
 #include "../test.h"
 
 #include <functional>
+#include <stdexcept>
+#include <vector>
 
 
 TEST_CASE_METHOD( SrcdirConfig, "xpath/create_context", "[xpath]" )
@@ -113,3 +115,115 @@ TEST_CASE_METHOD( SrcdirConfig, "xpath/illegal_xpath", "[xpath]" )
         xml::exception
     );
 }
+
+TEST_CASE( "xpath/value", "[xpath]" )
+{
+    xml::xpath_value empty;
+    CHECK( empty.get_type() == xml::xpath_value::type_node_set );
+    CHECK( empty.as_nodes().empty() );
+    CHECK_FALSE( empty.as_boolean() );
+
+    xml::xpath_value b(true);
+    CHECK( b.get_type() == xml::xpath_value::type_boolean );
+    CHECK( b.as_number() == 1 );
+    CHECK( b.as_string() == "true" );
+    CHECK_THROWS_AS( b.as_nodes(), xml::exception );
+
+    xml::xpath_value n(42);
+    CHECK( n.get_type() == xml::xpath_value::type_number );
+    CHECK( n.as_string() == "42" );
+    CHECK( n.as_boolean() );
+
+    xml::xpath_value s("17.5");
+    CHECK( s.get_type() == xml::xpath_value::type_string );
+    CHECK( s.as_number() == 17.5 );
+
+    xml::xpath_value copy(s);
+    s = n;
+    CHECK( copy.as_string() == "17.5" );
+    CHECK( s.as_string() == "42" );
+
+    xml::document doc(xml::node("root", "text"));
+    xml::xpath_value node(doc.get_root_node());
+    CHECK( node.get_type() == xml::xpath_value::type_node_set );
+    CHECK( node.as_string() == "text" );
+    CHECK( std::distance(node.as_nodes().begin(), node.as_nodes().end()) == 1 );
+}
+
+/*
+ * Test XPath extension functions
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xpath/extension_function", "[xpath]" )
+{
+    xml::tree_parser parser(test_file_path("xpath/data/02.xml").c_str());
+    xml::xpath_context ctxt(parser.get_document());
+    ctxt.register_namespace("p", "href");
+    ctxt.register_namespace("ext", "http://example.com/ext");
+
+    // function taking arguments of different types
+    std::vector<xml::xpath_value::value_type> types;
+    ctxt.register_function("is-second", "http://example.com/ext",
+        [&types](const std::vector<xml::xpath_value>& args) -> xml::xpath_value
+        {
+            types.clear();
+            for ( auto const& a : args )
+                types.push_back(a.get_type());
+
+            return args.at(0).as_number() == 2;
+        });
+
+    xml::const_nodes_view ns = ctxt.evaluate("//p:child[ext:is-second(position(), 'x', .)]");
+    CHECK( std::distance(ns.begin(), ns.end()) == 1 );
+    REQUIRE( types.size() == 3 );
+    CHECK( types[0] == xml::xpath_value::type_number );
+    CHECK( types[1] == xml::xpath_value::type_string );
+    CHECK( types[2] == xml::xpath_value::type_node_set );
+
+    // function returning nodes
+    ctxt.register_function("first", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>& args)
+        {
+            const xml::const_nodes_view nodes = args.at(0).as_nodes();
+            if ( nodes.empty() )
+                return xml::xpath_value();
+            return xml::xpath_value(*nodes.begin());
+        });
+
+    ns = ctxt.evaluate("ext:first(//p:child)");
+    CHECK( std::distance(ns.begin(), ns.end()) == 1 );
+
+    // function without namespace
+    ctxt.register_function("all", "",
+        [](const std::vector<xml::xpath_value>& args)
+        {
+            return args.at(0);
+        });
+
+    ns = ctxt.evaluate("all(//p:child)");
+    CHECK( std::distance(ns.begin(), ns.end()) == 3 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xpath/extension_function_error", "[xpath]" )
+{
+    xml::tree_parser parser(test_file_path("xpath/data/02.xml").c_str());
+    xml::xpath_context ctxt(parser.get_document());
+    ctxt.register_namespace("ext", "http://example.com/ext");
+
+    ctxt.register_function("fail", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>&) -> xml::xpath_value
+        {
+            throw std::runtime_error("something bad happened");
+        });
+
+    CHECK_THROWS_WITH
+    (
+        ctxt.evaluate("//*[ext:fail()]"),
+        Catch::Contains("something bad happened")
+    );
+
+    xml::error_messages errors;
+    xml::const_nodes_view ns = ctxt.evaluate("//*[ext:fail()]", errors);
+    CHECK( ns.empty() );
+    CHECK( errors.has_errors() );
+}
@@ -0,0 +1,4 @@
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform" xmlns:ext="http://example.com/ext" exclude-result-prefixes="ext">
+<xsl:output method="xml" indent="no"/>
+<xsl:template match="/"><result count="{ext:count(root/child)}" upper="{ext:upper('abc')}"/></xsl:template>
+</xsl:stylesheet>
@@ -0,0 +1,7 @@
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+<xsl:output method="xml" omit-xml-declaration="yes"/>
+<xsl:strip-space elements="*"/>
+<xsl:variable name="lookup" select="document('06a.xml')/lookup"/>
+<xsl:template match="/"><result nodes="{count($lookup/node())}"><xsl:apply-templates select="root/child"/></result></xsl:template>
+<xsl:template match="child"><xsl:value-of select="$lookup/entry[@key=name(current())]"/></xsl:template>
+</xsl:stylesheet>
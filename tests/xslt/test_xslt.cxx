@@ -35,6 +35,13 @@
 
 #include <xsltwrapp/xsltwrapp.h>
 
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 /*
  * Test stylesheet creation
  */
@@ -62,6 +69,58 @@ TEST_CASE_METHOD( SrcdirConfig, "xslt/creation_fail2", "[xslt]" )
     );
 }
 
+TEST_CASE_METHOD( SrcdirConfig, "xslt/creation_from_memory", "[xslt]" )
+{
+    const std::string data =
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:import href='02a.xsl'/>"
+        "</xsl:stylesheet>";
+
+    // the import is resolved relatively to the base URI
+    const std::string base_uri = test_file_path("xslt/data/memory.xsl");
+    xslt::stylesheet style(data.data(), data.size(), base_uri.c_str());
+
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    xml::document result;
+    xml::error_messages errors;
+    CHECK( style.apply(parser.get_document(), result, errors) );
+    CHECK( is_same_as_file(result, "xslt/data/02a.out") );
+
+    const std::string invalid = "<notxsl/>";
+    CHECK_THROWS_AS
+    (
+        xslt::stylesheet(invalid.data(), invalid.size(), nullptr),
+        xml::exception
+    );
+
+    CHECK_THROWS_AS
+    (
+        xslt::stylesheet(data.data(), data.size() - 1, nullptr),
+        xml::exception
+    );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/creation_from_document", "[xslt]" )
+{
+    xml::document doc(test_file_path("xslt/data/02a.xsl").c_str(), xml::throw_on_error);
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    // the document is copied and can still be used
+    xslt::stylesheet style1(doc);
+    CHECK( doc.get_root_node().get_name() == std::string("stylesheet") );
+
+    // the document is taken over without copying it
+    xslt::stylesheet style2(std::move(doc));
+
+    for ( auto style : { &style1, &style2 } )
+    {
+        xml::document result;
+        xml::error_messages errors;
+        CHECK( style->apply(parser.get_document(), result, errors) );
+        CHECK( is_same_as_file(result, "xslt/data/02a.out") );
+    }
+}
+
 
 /*
  * Test the first form of apply()
@@ -130,6 +189,453 @@ TEST_CASE_METHOD( SrcdirConfig, "xslt/apply4", "[xslt]" )
 }
 
 
+/*
+ * Test applying stylesheet with xslt::param_set
+ */
+
+namespace
+{
+
+std::string apply_with_params(const xslt::stylesheet& style, const xslt::param_set& params)
+{
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    xml::document result;
+    REQUIRE( style.apply(parser.get_document(), result, params, xml::throw_on_error) );
+
+    std::string output;
+    result.save_to_string(output);
+    return output;
+}
+
+} // anonymous namespace
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/param_set", "[xslt]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+
+    xslt::param_set params;
+    CHECK( params.empty() );
+    CHECK( apply_with_params(style, params).find("foo == default") != std::string::npos );
+
+    params.set_string("foo", "bar");
+    CHECK( params.size() == 1 );
+    CHECK( is_same_as_file(apply_with_params(style, params), "xslt/data/03a.out") );
+
+    // strings don't need to be quoted, even if they contain quotes
+    params.set_string("foo", "it's \"quoted\"");
+    CHECK( params.size() == 1 );
+    CHECK( apply_with_params(style, params).find("foo == it's \"quoted\"") != std::string::npos );
+
+    params.set_number("foo", 2.5);
+    CHECK( apply_with_params(style, params).find("foo == 2.5<") != std::string::npos );
+
+    params.set_number("foo", -0.125);
+    CHECK( apply_with_params(style, params).find("foo == -0.125<") != std::string::npos );
+
+    params.set_boolean("foo", true);
+    CHECK( apply_with_params(style, params).find("foo == true<") != std::string::npos );
+
+    // expressions are evaluated in the context of the input document
+    params.set_expression("foo", "count(/root/child)");
+    CHECK( apply_with_params(style, params).find("foo == 2<") != std::string::npos );
+
+    params.set_expression("foo", "name(/root/*[1])");
+    const std::string out = apply_with_params(style, params);
+    CHECK( out.find("foo == child<") != std::string::npos );
+
+    CHECK_THROWS_AS( params.set_expression("foo", "/root/["), xml::exception );
+
+    // copies are independent of the original
+    xslt::param_set copy(params);
+    params.set_string("foo", "bar");
+    CHECK( apply_with_params(style, copy) == out );
+
+    CHECK( params.remove("foo") );
+    CHECK_FALSE( params.remove("foo") );
+    CHECK( params.empty() );
+    CHECK( apply_with_params(style, params).find("foo == default") != std::string::npos );
+
+    // output functions can be used with param_set too
+    copy.clear();
+    copy.set_string("foo", "bar");
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    std::ostringstream ostr;
+    CHECK( style.apply_to_stream(parser.get_document(), ostr, copy) );
+    CHECK( is_same_as_file(ostr, "xslt/data/03a.out") );
+}
+
+
+/*
+ * Test extension functions
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/extension_function", "[xslt]" )
+{
+    xslt::stylesheet style(test_file_path("xslt/data/04a.xsl").c_str());
+    style.register_function("count", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>& args)
+        {
+            const xml::const_nodes_view nodes = args.at(0).as_nodes();
+            return static_cast<int>(std::distance(nodes.begin(), nodes.end()));
+        });
+    style.register_function("upper", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>& args)
+        {
+            std::string s = args.at(0).as_string();
+            for ( auto& c : s )
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            return s;
+        });
+
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    xml::document result;
+    REQUIRE( style.apply(parser.get_document(), result, xml::throw_on_error) );
+
+    const xml::node& root = result.get_root_node();
+    CHECK( std::string(root.get_attributes().find("count")->get_value()) == "2" );
+    CHECK( std::string(root.get_attributes().find("upper")->get_value()) == "ABC" );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/extension_function_error", "[xslt]" )
+{
+    xslt::stylesheet style(test_file_path("xslt/data/04a.xsl").c_str());
+    style.register_function("count", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>&) -> xml::xpath_value
+        {
+            throw std::runtime_error("count failed");
+        });
+    style.register_function("upper", "http://example.com/ext",
+        [](const std::vector<xml::xpath_value>& args)
+        {
+            return args.at(0);
+        });
+
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    xml::document result;
+    xml::error_messages errors;
+    CHECK( !style.apply(parser.get_document(), result, errors) );
+    CHECK( errors.print().find("count failed") != std::string::npos );
+
+    // unregistered functions result in errors too
+    xslt::stylesheet style2(test_file_path("xslt/data/04a.xsl").c_str());
+    xml::error_messages errors2;
+    CHECK( !style2.apply(parser.get_document(), result, errors2) );
+    CHECK( errors2.has_errors() );
+}
+
+
+/*
+ * Test writing the result directly to a stream or file descriptor
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/apply_to_stream", "[xslt]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    std::ostringstream ostr;
+    CHECK( style.apply_to_stream(parser.get_document(), ostr) );
+    CHECK( is_same_as_file(ostr, "xslt/data/02a.out") );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/apply_to_stream_params", "[xslt]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    xslt::stylesheet::param_type params;
+    params["foo"] = "'bar'";
+
+    std::ostringstream ostr;
+    CHECK( style.apply_to_stream(parser.get_document(), ostr, params) );
+    CHECK( is_same_as_file(ostr, "xslt/data/03a.out") );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/apply_to_stream_errors", "[xslt]" )
+{
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    // transformation error: nothing is written
+    const xslt::stylesheet style_errors(test_file_path("xslt/data/with_errors.xsl").c_str());
+    std::ostringstream ostr;
+    xml::error_messages errors;
+    CHECK( !style_errors.apply_to_stream(parser.get_document(), ostr, errors) );
+    CHECK( !errors.messages().empty() );
+    CHECK( ostr.str().empty() );
+
+    CHECK_THROWS_AS
+    (
+        style_errors.apply_to_stream(parser.get_document(), ostr),
+        xml::exception
+    );
+
+    // output error
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+    std::ostringstream bad;
+    bad.setstate(std::ios::badbit);
+    xml::error_messages errors2;
+    CHECK( !style.apply_to_stream(parser.get_document(), bad, errors2) );
+    CHECK( !errors2.messages().empty() );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/apply_to_fd", "[xslt]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    std::FILE *f = std::tmpfile();
+    REQUIRE( f );
+
+    CHECK( style.apply_to_fd(parser.get_document(), fileno(f)) );
+
+    std::string output;
+    std::rewind(f);
+    char buf[256];
+    size_t len;
+    while ( (len = std::fread(buf, 1, sizeof(buf), f)) > 0 )
+        output.append(buf, len);
+    std::fclose(f);
+
+    CHECK( is_same_as_file(output, "xslt/data/02a.out") );
+}
+
+
+/*
+ * Test xslt::pipeline
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/pipeline", "[xslt]" )
+{
+    const xslt::stylesheet identity(test_file_path("xslt/data/05a.xsl").c_str());
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    xslt::pipeline p;
+    CHECK( p.empty() );
+    xml::document result;
+    CHECK_THROWS_AS( p.apply(parser.get_document(), result), xml::exception );
+
+    p.add(identity).add(identity).add(style);
+    CHECK( p.size() == 3 );
+
+    // the output settings of the last stylesheet are used
+    REQUIRE( p.apply(parser.get_document(), result) );
+    CHECK( is_same_as_file(result, "xslt/data/02a.out") );
+
+    std::ostringstream ostr;
+    REQUIRE( p.apply_to_stream(parser.get_document(), ostr) );
+    CHECK( is_same_as_file(ostr, "xslt/data/02a.out") );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/pipeline_params", "[xslt]" )
+{
+    xslt::stylesheet_cache cache;
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    xslt::param_set params;
+    params.set_string("foo", "bar");
+
+    xslt::pipeline p;
+    p.add(cache.get(test_file_path("xslt/data/05a.xsl").c_str()))
+     .add(cache.get(test_file_path("xslt/data/03a.xsl").c_str()), params);
+
+    // the pipeline keeps the stylesheets alive
+    cache.clear();
+
+    std::ostringstream ostr;
+    REQUIRE( p.apply_to_stream(parser.get_document(), ostr) );
+    CHECK( is_same_as_file(ostr, "xslt/data/03a.out") );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/pipeline_errors", "[xslt]" )
+{
+    const xslt::stylesheet identity(test_file_path("xslt/data/05a.xsl").c_str());
+    const xslt::stylesheet style_errors(test_file_path("xslt/data/with_errors.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    xslt::pipeline p;
+    p.add(identity).add(style_errors).add(identity);
+
+    xml::document result;
+    xml::error_messages errors;
+    CHECK( !p.apply(parser.get_document(), result, errors) );
+    CHECK( errors.has_errors() );
+
+    CHECK_THROWS_AS( p.apply(parser.get_document(), result), xml::exception );
+}
+
+
+/*
+ * Test xslt::batch_transform
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/batch_transform", "[xslt][threads]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+
+    xslt::param_set params;
+    params.set_string("foo", "bar");
+
+    xslt::batch_transform batch(style, 4);
+    CHECK( batch.get_num_threads() == 4 );
+    batch.set_params(params);
+
+    std::ifstream f(test_file_path("xslt/data/input.xml"));
+    const std::string input_data{std::istreambuf_iterator<char>(f),
+                                 std::istreambuf_iterator<char>()};
+
+    const int num_docs = 50;
+    int produced = 0;
+    std::vector<xslt::batch_transform::result> results;
+    auto stats = batch.run(
+        [&](xslt::batch_transform::input& next)
+        {
+            if ( produced == num_docs )
+                return false;
+
+            next.name = "doc" + std::to_string(produced);
+            if ( produced % 10 == 9 )
+                next.data = "<root><child>";
+            else if ( produced % 2 )
+                next.filename = test_file_path("xslt/data/input.xml");
+            else
+                next.data = input_data;
+
+            produced++;
+            return true;
+        },
+        [&](const xslt::batch_transform::result& res)
+        {
+            results.push_back(res);
+        });
+
+    CHECK( stats.documents == num_docs );
+    CHECK( stats.failures == num_docs / 10 );
+    CHECK( stats.input_bytes > 0 );
+    CHECK( stats.output_bytes > 0 );
+    CHECK( stats.documents_per_second() > 0 );
+
+    REQUIRE( results.size() == num_docs );
+
+    std::vector<bool> seen(num_docs, false);
+    for ( auto const& res : results )
+    {
+        REQUIRE( res.index < num_docs );
+        CHECK( !seen[res.index] );
+        seen[res.index] = true;
+
+        CHECK( res.name == "doc" + std::to_string(res.index) );
+        if ( res.index % 10 == 9 )
+        {
+            CHECK( !res.success );
+            CHECK( res.errors.has_errors() );
+            CHECK( res.output.empty() );
+        }
+        else
+        {
+            CHECK( res.success );
+            CHECK( is_same_as_file(res.output, "xslt/data/03a.out") );
+        }
+    }
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/batch_transform_files", "[xslt][threads]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+
+    std::vector<std::string> files(10, test_file_path("xslt/data/input.xml"));
+    files.push_back("nonexistent.xml");
+
+    xslt::batch_transform batch(style);
+    CHECK( batch.get_num_threads() > 0 );
+
+    int failures = 0;
+    auto stats = batch.run(files, [&](const xslt::batch_transform::result& res)
+    {
+        if ( !res.success )
+        {
+            failures++;
+            CHECK( res.name == "nonexistent.xml" );
+        }
+    });
+
+    CHECK( stats.documents == files.size() );
+    CHECK( stats.failures == 1 );
+    CHECK( failures == 1 );
+
+    // exceptions thrown by the sink are propagated
+    CHECK_THROWS_AS
+    (
+        batch.run(files, [](const xslt::batch_transform::result&)
+                         {
+                             throw std::runtime_error("sink error");
+                         }),
+        std::runtime_error
+    );
+}
+
+
+/*
+ * Test profiling transformations
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/profile", "[xslt]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/02a.xsl").c_str());
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+    xslt::profile prof;
+    xml::document result;
+    REQUIRE( style.apply(parser.get_document(), result, prof, xml::throw_on_error) );
+    CHECK( is_same_as_file(result, "xslt/data/02a.out") );
+
+    CHECK( prof.transformations() == 1 );
+    REQUIRE( prof.templates().size() == 3 );
+
+    std::map<std::string, unsigned long> calls;
+    for ( auto const& t : prof.templates() )
+    {
+        CHECK( t.name.empty() );
+        CHECK( t.mode.empty() );
+        calls[t.match] = t.calls;
+    }
+
+    CHECK( calls["/"] == 1 );
+    CHECK( calls["root"] == 1 );
+    CHECK( calls["child"] == 2 );
+
+    // profiling information is accumulated over several transformations
+    xml::document result2;
+    REQUIRE( style.apply(parser.get_document(), result2, prof, xml::throw_on_error) );
+    CHECK( prof.transformations() == 2 );
+    CHECK( prof.templates().size() == 3 );
+
+    xslt::profile total;
+    total.merge(prof);
+    total.merge(prof);
+    CHECK( total.transformations() == 4 );
+    for ( auto const& t : total.templates() )
+        CHECK( t.calls == 4 * calls[t.match] );
+
+    // the templates are sorted by time
+    for ( size_t n = 1; n < total.templates().size(); ++n )
+        CHECK( total.templates()[n - 1].time >= total.templates()[n].time );
+
+    total.clear();
+    CHECK( total.templates().empty() );
+    CHECK( total.transformations() == 0 );
+
+    // profiling doesn't affect the normal transformations
+    xslt::profile prof2;
+    xml::document result3;
+    REQUIRE( style.apply(parser.get_document(), result3, xml::throw_on_error) );
+    REQUIRE( style.apply(parser.get_document(), result3, prof2, xml::throw_on_error) );
+    CHECK( prof2.transformations() == 1 );
+    for ( auto const& t : prof2.templates() )
+        CHECK( t.calls == calls[t.match] );
+}
+
+
 /*
  * Tests libxslt errors reporting
  */
@@ -155,3 +661,361 @@ TEST_CASE_METHOD( SrcdirConfig, "xslt/xsl_with_errors_throw", "[xslt]" )
         xml::exception
     );
 }
+
+
+/*
+ * Test using the same stylesheet from several threads concurrently.
+ */
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/apply_concurrently", "[xslt][threads]" )
+{
+    const xslt::stylesheet style(test_file_path("xslt/data/03a.xsl").c_str());
+    const xslt::stylesheet style_errors(test_file_path("xslt/data/with_errors.xsl").c_str());
+
+    std::string expected;
+    {
+        xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+        xml::document result;
+        xml::error_messages errors;
+        xslt::stylesheet::param_type params;
+        params["foo"] = "'bar'";
+        REQUIRE( style.apply(parser.get_document(), result, params, errors) );
+        result.save_to_string(expected);
+    }
+
+    const int num_threads = 8;
+    const int num_iterations = 20;
+
+    // Catch assertions can't be used from multiple threads, so just count
+    // the failures in each thread and check them in the main one.
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            // Each thread must use its own input document.
+            xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+            const xml::document& input = parser.get_document();
+
+            xslt::stylesheet::param_type params;
+            params["foo"] = "'bar'";
+
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::document result;
+                xml::error_messages errors;
+                if ( !style.apply(input, result, params, errors) )
+                {
+                    ++failures[t];
+                    continue;
+                }
+
+                std::string output;
+                result.save_to_string(output);
+                if ( output != expected || !errors.messages().empty() )
+                    ++failures[t];
+
+                // Errors in a transformation must not affect the others.
+                xml::error_messages errors2;
+                xml::document result2;
+                if ( style_errors.apply(input, result2, errors2) ||
+                        errors2.messages().empty() )
+                    ++failures[t];
+            }
+        });
+    }
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        INFO( "thread #" << t );
+        CHECK( failures[t] == 0 );
+    }
+}
+
+
+/*
+ * Test xslt::stylesheet_cache
+ */
+
+namespace
+{
+
+// Create (or overwrite) a temporary file which is removed at the end of test.
+class temp_stylesheet_file
+{
+public:
+    explicit temp_stylesheet_file(const char *name) : name_(name) {}
+
+    ~temp_stylesheet_file() { remove(name_); }
+
+    const char *get_name() const { return name_; }
+
+    void write(const std::string& contents)
+    {
+        std::ofstream f(name_);
+        f << contents;
+    }
+
+private:
+    const char *name_;
+
+    temp_stylesheet_file(const temp_stylesheet_file&) = delete;
+    temp_stylesheet_file& operator=(const temp_stylesheet_file&) = delete;
+};
+
+std::string apply_to_input(const xslt::stylesheet& style)
+{
+    xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+    xml::document result;
+    xml::error_messages errors;
+    REQUIRE( style.apply(parser.get_document(), result, errors) );
+
+    std::string output;
+    result.save_to_string(output);
+    return output;
+}
+
+} // anonymous namespace
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/cache_hits", "[xslt][cache]" )
+{
+    xslt::stylesheet_cache cache;
+    const std::string path = test_file_path("xslt/data/02a.xsl");
+
+    auto style1 = cache.get(path.c_str());
+    auto style2 = cache.get(path.c_str());
+    CHECK( style1 == style2 );
+    CHECK( cache.size() == 1 );
+    CHECK( is_same_as_file(apply_to_input(*style1), "xslt/data/02a.out") );
+
+    auto stats = cache.get_statistics();
+    CHECK( stats.hits == 1 );
+    CHECK( stats.misses == 1 );
+    CHECK( stats.evictions == 0 );
+
+    CHECK( cache.remove(path.c_str()) );
+    CHECK_FALSE( cache.remove(path.c_str()) );
+    CHECK( cache.size() == 0 );
+
+    // the stylesheet is still usable after removing it from the cache
+    CHECK( is_same_as_file(apply_to_input(*style1), "xslt/data/02a.out") );
+
+    CHECK( cache.get(path.c_str()) != style1 );
+    CHECK( cache.get_statistics().misses == 2 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/cache_lru", "[xslt][cache]" )
+{
+    xslt::stylesheet_cache cache(2);
+    const std::string a = test_file_path("xslt/data/01b.xsl");
+    const std::string b = test_file_path("xslt/data/02a.xsl");
+    const std::string c = test_file_path("xslt/data/03a.xsl");
+
+    cache.get(a.c_str());
+    cache.get(b.c_str());
+    cache.get(a.c_str());
+    cache.get(c.c_str());   // evicts b, which was used least recently
+
+    CHECK( cache.size() == 2 );
+    CHECK( cache.get_statistics().evictions == 1 );
+
+    cache.get(a.c_str());
+    CHECK( cache.get_statistics().misses == 3 );
+    cache.get(b.c_str());
+    CHECK( cache.get_statistics().misses == 4 );
+
+    cache.set_max_size(1);
+    CHECK( cache.size() == 1 );
+    CHECK( cache.get_max_size() == 1 );
+    CHECK( cache.get_statistics().evictions == 3 );
+
+    cache.clear();
+    CHECK( cache.size() == 0 );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/cache_error", "[xslt][cache]" )
+{
+    xslt::stylesheet_cache cache;
+    const std::string path = test_file_path("xslt/data/01a.xsl");
+
+    CHECK_THROWS_AS( cache.get(path.c_str()), xml::exception );
+    CHECK( cache.size() == 0 );
+    CHECK( cache.get_statistics().misses == 1 );
+
+    CHECK_THROWS_AS( xslt::stylesheet_cache(0), xml::exception );
+}
+
+TEST_CASE( "xslt/cache_modified", "[xslt][cache]" )
+{
+    temp_stylesheet_file imported("test_cache_imported.xsl");
+    imported.write(
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:template match='child'><a/></xsl:template>"
+        "</xsl:stylesheet>");
+
+    temp_stylesheet_file main("test_cache_main.xsl");
+    main.write(
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:import href='test_cache_imported.xsl'/>"
+        "<xsl:template match='/'><r><xsl:apply-templates select='root/child'/></r></xsl:template>"
+        "</xsl:stylesheet>");
+
+    xslt::stylesheet_cache cache;
+
+    auto style1 = cache.get(main.get_name());
+    CHECK( cache.get(main.get_name()) == style1 );
+
+    auto stats = cache.get_statistics();
+    CHECK( stats.misses == 1 );
+    CHECK( stats.import_misses == 1 );
+    CHECK( stats.import_hits == 0 );
+
+    // Changing the main stylesheet recompiles it, but reuses the import.
+    main.write(
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:import href='test_cache_imported.xsl'/>"
+        "<xsl:template match='/'><res><xsl:apply-templates select='root/child'/></res></xsl:template>"
+        "</xsl:stylesheet>");
+
+    auto style2 = cache.get(main.get_name());
+    CHECK( style2 != style1 );
+
+    stats = cache.get_statistics();
+    CHECK( stats.misses == 2 );
+    CHECK( stats.import_misses == 1 );
+    CHECK( stats.import_hits == 1 );
+
+    // Changing the imported stylesheet recompiles the main one too.
+    imported.write(
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:template match='child'><bb/></xsl:template>"
+        "</xsl:stylesheet>");
+
+    auto style3 = cache.get(main.get_name());
+    CHECK( style3 != style2 );
+
+    stats = cache.get_statistics();
+    CHECK( stats.misses == 3 );
+    CHECK( stats.import_misses == 2 );
+
+    CHECK( apply_to_input(*style1).find("<r><a/><a/></r>") != std::string::npos );
+    CHECK( apply_to_input(*style2).find("<res><a/><a/></res>") != std::string::npos );
+    CHECK( apply_to_input(*style3).find("<res><bb/><bb/></res>") != std::string::npos );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/document_cache", "[xslt][cache]" )
+{
+    auto cache = std::make_shared<xslt::document_cache>();
+
+    xslt::stylesheet style(test_file_path("xslt/data/06a.xsl").c_str());
+    CHECK( apply_to_input(style) == "<result nodes=\"1\">foundfound</result>\n" );
+
+    style.set_document_cache(cache);
+    for ( int n = 0; n < 3; n++ )
+    {
+        // whitespace is stripped from a copy of the document, not the one
+        // stored in the cache
+        CHECK( apply_to_input(style) == "<result nodes=\"1\">foundfound</result>\n" );
+    }
+
+    auto stats = cache->get_statistics();
+    CHECK( stats.misses == 1 );
+    CHECK( stats.hits == 2 );
+    CHECK( stats.evictions == 0 );
+    CHECK( cache->size() == 1 );
+    CHECK( cache->get_memory_used() > 0 );
+
+    CHECK( cache->remove(test_file_path("xslt/data/06a.xml").c_str()) );
+    CHECK( cache->size() == 0 );
+    CHECK( cache->get_memory_used() == 0 );
+
+    // documents bigger than the limit are not cached
+    cache->set_max_memory(1);
+    CHECK( apply_to_input(style) == "<result nodes=\"1\">foundfound</result>\n" );
+    CHECK( cache->size() == 0 );
+
+    CHECK_THROWS_AS( cache->set_max_memory(0), xml::exception );
+}
+
+TEST_CASE_METHOD( SrcdirConfig, "xslt/document_cache_concurrently", "[xslt][cache][threads]" )
+{
+    auto cache = std::make_shared<xslt::document_cache>();
+    xslt::stylesheet style(test_file_path("xslt/data/06a.xsl").c_str());
+    style.set_document_cache(cache);
+
+    const int num_threads = 8;
+    const int num_iterations = 20;
+
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t )
+    {
+        threads.emplace_back([&, t]()
+        {
+            xml::tree_parser parser(test_file_path("xslt/data/input.xml").c_str());
+
+            for ( int n = 0; n < num_iterations; ++n )
+            {
+                xml::document result;
+                xml::error_messages errors;
+                std::string output;
+                if ( style.apply(parser.get_document(), result, errors) )
+                    result.save_to_string(output);
+
+                if ( output != "<result nodes=\"1\">foundfound</result>\n" )
+                    failures[t]++;
+
+                // exercise removing the documents while they're used too
+                if ( n % 5 == 4 )
+                    cache->clear();
+            }
+        });
+    }
+
+    for ( auto& th : threads )
+        th.join();
+
+    for ( int t = 0; t < num_threads; ++t )
+        CHECK( failures[t] == 0 );
+
+    auto stats = cache->get_statistics();
+    CHECK( stats.hits + stats.misses == num_threads * num_iterations );
+}
+
+TEST_CASE( "xslt/document_cache_modified", "[xslt][cache]" )
+{
+    temp_stylesheet_file lookup("test_cache_lookup.xml");
+    lookup.write("<lookup>a</lookup>");
+
+    temp_stylesheet_file main("test_cache_lookup.xsl");
+    main.write(
+        "<xsl:stylesheet version='1.0' xmlns:xsl='http://www.w3.org/1999/XSL/Transform'>"
+        "<xsl:output method='text'/>"
+        "<xsl:template match='/'><xsl:value-of select=\"document('test_cache_lookup.xml')\"/></xsl:template>"
+        "</xsl:stylesheet>");
+
+    xslt::stylesheet_cache style_cache;
+    auto doc_cache = std::make_shared<xslt::document_cache>();
+    style_cache.set_document_cache(doc_cache);
+
+    auto style = style_cache.get(main.get_name());
+    CHECK( apply_to_input(*style) == "a" );
+    CHECK( apply_to_input(*style) == "a" );
+
+    // Changing the document loads it again.
+    lookup.write("<lookup>bb</lookup>");
+    CHECK( apply_to_input(*style) == "bb" );
+
+    auto stats = doc_cache->get_statistics();
+    CHECK( stats.misses == 2 );
+    CHECK( stats.hits == 1 );
+    CHECK( doc_cache->size() == 1 );
+
+    doc_cache->clear();
+    CHECK( doc_cache->size() == 0 );
+    CHECK( doc_cache->get_memory_used() == 0 );
+}